@@ -0,0 +1,120 @@
+/**
+ * @file bench.h
+ * @brief A minimal benchmark harness for the jelly_bench target.
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+/**
+ * @brief State passed to a benchmark body.
+ *
+ * The body does its setup, then repeats the measured work while
+ * keepRunning() returns true, and finally reports how many items and bytes
+ * it processed so the runner can derive throughput.
+ */
+class BenchState {
+  using Clock = std::chrono::steady_clock;
+
+  size_t m_done = 0;
+  bool m_started = false;
+  Clock::time_point m_start;
+  Clock::duration m_elapsed = Clock::duration::zero();
+
+public:
+  size_t range;              ///< Problem size of this run
+  size_t iterations;         ///< Number of times to repeat the work
+  size_t itemsProcessed = 0; ///< Items processed over all iterations
+  size_t bytesProcessed = 0; ///< Bytes processed over all iterations
+
+  BenchState(size_t range, size_t iterations)
+      : range(range), iterations(iterations) {}
+
+  /**
+   * @brief Advances the measured loop.
+   *
+   * Starts the timer on the first call and stops it once all iterations ran.
+   *
+   * @return True while iterations remain.
+   */
+  bool keepRunning() {
+    if (!m_started) {
+      m_started = true;
+      m_start = Clock::now();
+    }
+    if (m_done == iterations) {
+      m_elapsed = Clock::now() - m_start;
+      return false;
+    }
+    ++m_done;
+    return true;
+  }
+
+  /**
+   * @brief Gets the time spent in the measured loop.
+   *
+   * @return The elapsed time in seconds.
+   */
+  double elapsedSeconds() const {
+    return std::chrono::duration<double>(m_elapsed).count();
+  }
+};
+
+using BenchFunction = void (*)(BenchState &state);
+
+/**
+ * @brief A registered benchmark and the problem sizes it runs at.
+ */
+struct Benchmark {
+  const char *name;
+  BenchFunction function;
+  std::vector<size_t> ranges;
+};
+
+/**
+ * @brief Gets all benchmarks registered with JELLY_BENCHMARK.
+ *
+ * @return The benchmark registry.
+ */
+std::vector<Benchmark> &benchmarkRegistry();
+
+/**
+ * @brief Registers a benchmark at static initialization time.
+ */
+struct BenchRegistrar {
+  BenchRegistrar(const char *name, BenchFunction function,
+                 std::initializer_list<size_t> ranges) {
+    benchmarkRegistry().push_back({name, function, ranges});
+  }
+};
+
+/**
+ * @brief Registers a benchmark function to run at each of the given sizes.
+ */
+#define JELLY_BENCHMARK(function, ...)                                         \
+  static BenchRegistrar function##_registrar(#function, function,             \
+                                             {__VA_ARGS__})
+
+/**
+ * @brief Creates the GameContext for benchmarks that render, if it does not
+ * exist yet.
+ *
+ * Renders offscreen through a headless context unless jelly_bench was run
+ * with --window or no headless context is available.
+ */
+void initBenchContext();
+
+/**
+ * @brief Keeps the compiler from optimizing away a computed value.
+ *
+ * @param value The value to keep alive.
+ */
+template <typename T> inline void doNotOptimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif // BENCH_H
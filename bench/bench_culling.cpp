@@ -0,0 +1,104 @@
+#include <random>
+#include <vector>
+
+#include <jelly/culling.h>
+#include <jelly/game_context.h>
+#include <jelly/sprite.h>
+
+#include "bench.h"
+
+// Worlds are 20x the 1280x720 viewport in each direction, so about one
+// sprite in 400 is visible.
+const float WORLD_WIDTH = 1280.0f * 20.0f;
+const float WORLD_HEIGHT = 720.0f * 20.0f;
+
+static std::vector<Vec2<float>> worldPositions(size_t count) {
+  std::mt19937 rng(9);
+  std::uniform_real_distribution<float> x(0.0f, WORLD_WIDTH);
+  std::uniform_real_distribution<float> y(0.0f, WORLD_HEIGHT);
+
+  std::vector<Vec2<float>> positions(count);
+  for (Vec2<float> &position : positions) {
+    position = Vec2<float>(x(rng), y(rng));
+  }
+  return positions;
+}
+
+static void cullKernel(BenchState &state, SimdLevel level) {
+  if (!isSimdLevelSupported(level))
+    return;
+
+  CullBoundsSoA bounds;
+  for (const Vec2<float> &position : worldPositions(state.range)) {
+    bounds.push({position.x, position.y, position.x + 32.0f,
+                 position.y + 32.0f});
+  }
+  std::vector<uint32_t> visible(state.range);
+  CullRect view = {0.0f, 0.0f, 1280.0f, 720.0f};
+
+  while (state.keepRunning()) {
+    size_t count = cullBounds(bounds, view, visible.data(), level);
+    doNotOptimize(count);
+  }
+
+  state.itemsProcessed = state.iterations * state.range;
+  state.bytesProcessed = state.itemsProcessed * 4 * sizeof(float);
+}
+
+static void cullScalar(BenchState &state) {
+  cullKernel(state, SimdLevel::Scalar);
+}
+
+static void cullSSE(BenchState &state) { cullKernel(state, SimdLevel::SSE); }
+
+static void cullAVX(BenchState &state) { cullKernel(state, SimdLevel::AVX); }
+
+JELLY_BENCHMARK(cullScalar, 10000, 1000000);
+JELLY_BENCHMARK(cullSSE, 10000, 1000000);
+JELLY_BENCHMARK(cullAVX, 10000, 1000000);
+
+enum class WorldDraw { Unculled, PerSprite, Bulk };
+
+static void drawWorld(BenchState &state, WorldDraw mode) {
+  initBenchContext();
+  Renderer2D &renderer = GameContext::getInstance().getRenderer();
+  renderer.setCulling(mode != WorldDraw::Unculled);
+
+  std::vector<Sprite> sprites(state.range, Sprite("textures/martian.png"));
+  std::vector<Vec2<float>> positions = worldPositions(state.range);
+  for (size_t i = 0; i < state.range; ++i) {
+    sprites[i].setPosition(Vec3<float>(positions[i].x, positions[i].y, 0.0f));
+  }
+
+  while (state.keepRunning()) {
+    renderer.begin();
+    if (mode == WorldDraw::Bulk) {
+      renderer.drawSprites(sprites);
+    } else {
+      for (const Sprite &sprite : sprites) {
+        renderer.drawSprite(sprite);
+      }
+    }
+    renderer.end();
+    glFinish();
+  }
+
+  state.itemsProcessed = state.iterations * state.range;
+  renderer.setCulling(true);
+}
+
+static void drawWorldUnculled(BenchState &state) {
+  drawWorld(state, WorldDraw::Unculled);
+}
+
+static void drawWorldCulled(BenchState &state) {
+  drawWorld(state, WorldDraw::PerSprite);
+}
+
+static void drawWorldCulledBulk(BenchState &state) {
+  drawWorld(state, WorldDraw::Bulk);
+}
+
+JELLY_BENCHMARK(drawWorldUnculled, 10000, 200000);
+JELLY_BENCHMARK(drawWorldCulled, 10000, 200000);
+JELLY_BENCHMARK(drawWorldCulledBulk, 10000, 200000);
@@ -0,0 +1,89 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <jelly/image.h>
+#include <jelly/io.h>
+
+#include "bench.h"
+
+// Input files are generated once per size in the temporary directory, so the
+// benchmarks do not depend on the assets in the working directory. After the
+// first iteration they are read from the page cache.
+
+static std::filesystem::path benchFile(const std::string &name) {
+  std::filesystem::path dir =
+      std::filesystem::temp_directory_path() / "jelly_bench_io";
+  std::filesystem::create_directories(dir);
+  return dir / name;
+}
+
+// Range is the file size in bytes.
+static void readFile(BenchState &state) {
+  std::filesystem::path path =
+      benchFile("file" + std::to_string(state.range) + ".bin");
+  if (!std::filesystem::exists(path) ||
+      std::filesystem::file_size(path) != state.range) {
+    std::string data(state.range, '\0');
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<char>('a' + i % 26);
+    }
+    std::ofstream(path, std::ios::binary).write(data.data(), data.size());
+  }
+
+  std::string pathString = path.string();
+  while (state.keepRunning()) {
+    std::string contents = read_file(pathString.c_str());
+    doNotOptimize(contents.data());
+  }
+
+  state.itemsProcessed = state.iterations;
+  state.bytesProcessed = state.iterations * state.range;
+}
+
+JELLY_BENCHMARK(readFile, 4096, 1 << 20, 16 << 20);
+
+// Range is the width and height of a square RGBA PNG. The pixels are a
+// gradient with noise so the file compresses like a real texture rather than
+// a flat color.
+static void loadImage(BenchState &state) {
+  int size = static_cast<int>(state.range);
+  std::filesystem::path path =
+      benchFile("image" + std::to_string(size) + ".png");
+  if (!std::filesystem::exists(path)) {
+    std::vector<unsigned char> pixels(static_cast<size_t>(size) * size * 4);
+    unsigned int noise = 1;
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+      size_t x = (i / 4) % size;
+      size_t y = (i / 4) / size;
+      noise = noise * 1103515245u + 12345u;
+      pixels[i + 0] = static_cast<unsigned char>(x * 255 / size);
+      pixels[i + 1] = static_cast<unsigned char>(y * 255 / size);
+      pixels[i + 2] = static_cast<unsigned char>((noise >> 16) & 0x1f);
+      pixels[i + 3] = 255;
+    }
+    write_png(path.string().c_str(), size, size, pixels.data());
+  }
+
+  std::string pathString = path.string();
+  size_t decodedBytes = 0;
+  while (state.keepRunning()) {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    unsigned char *data =
+        load_image(pathString.c_str(), width, height, channels, 4);
+    if (data != nullptr) {
+      decodedBytes += static_cast<size_t>(width) * height * 4;
+    }
+    doNotOptimize(data);
+    free_image(data);
+  }
+
+  // Bytes are the decoded pixels, which is what a texture upload consumes.
+  state.itemsProcessed = state.iterations;
+  state.bytesProcessed = decodedBytes;
+}
+
+JELLY_BENCHMARK(loadImage, 64, 256, 1024);
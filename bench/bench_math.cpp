@@ -0,0 +1,116 @@
+#include <random>
+#include <vector>
+
+#include <jelly/mat.h>
+#include <jelly/vec.h>
+
+#include "bench.h"
+
+// Range is the number of matrices or vectors processed per iteration. The
+// inputs are random so no result can be folded at compile time.
+
+static std::vector<Mat4<float>> randomMatrices(size_t count) {
+  std::mt19937 rng(20);
+  std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+  std::uniform_real_distribution<float> offset(-100.0f, 100.0f);
+
+  std::vector<Mat4<float>> matrices;
+  matrices.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    matrices.push_back(
+        Mat4<float>::translate(Vec3<float>(offset(rng), offset(rng), 0.0f)) *
+        Mat4<float>::rotateZ(angle(rng)));
+  }
+  return matrices;
+}
+
+template <typename V> static std::vector<V> randomVectors(size_t count) {
+  std::mt19937 rng(30);
+  std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+
+  std::vector<V> vectors(count);
+  for (V &vector : vectors) {
+    for (size_t i = 0; i < sizeof(V) / sizeof(float); ++i) {
+      vector[i] = value(rng);
+    }
+  }
+  return vectors;
+}
+
+static void mat4Multiply(BenchState &state) {
+  std::vector<Mat4<float>> matrices = randomMatrices(state.range);
+  std::vector<Mat4<float>> results(state.range);
+  Mat4<float> projection =
+      Mat4<float>::ortho(0.0f, 1280.0f, 720.0f, 0.0f, -1.0f, 1.0f);
+
+  while (state.keepRunning()) {
+    for (size_t i = 0; i < state.range; ++i) {
+      results[i] = projection * matrices[i];
+    }
+    doNotOptimize(results.data());
+  }
+
+  // One matrix is read and one written per product.
+  state.itemsProcessed = state.iterations * state.range;
+  state.bytesProcessed = state.itemsProcessed * 2 * sizeof(Mat4<float>);
+}
+
+JELLY_BENCHMARK(mat4Multiply, 1000, 100000);
+
+template <typename V> static void mat4Transform(BenchState &state) {
+  std::vector<V> vectors = randomVectors<V>(state.range);
+  std::vector<V> results(state.range);
+  Mat4<float> model = randomMatrices(1)[0];
+
+  while (state.keepRunning()) {
+    for (size_t i = 0; i < state.range; ++i) {
+      results[i] = model * vectors[i];
+    }
+    doNotOptimize(results.data());
+  }
+
+  state.itemsProcessed = state.iterations * state.range;
+  state.bytesProcessed = state.itemsProcessed * 2 * sizeof(V);
+}
+
+static void mat4TransformVec3(BenchState &state) {
+  mat4Transform<Vec3<float>>(state);
+}
+
+static void mat4TransformVec4(BenchState &state) {
+  mat4Transform<Vec4<float>>(state);
+}
+
+JELLY_BENCHMARK(mat4TransformVec3, 1000, 100000);
+JELLY_BENCHMARK(mat4TransformVec4, 1000, 100000);
+
+// A mix of the operations game code uses on every frame: a scaled add, a
+// normalize and a dot product per vector.
+template <typename V> static void vecOps(BenchState &state) {
+  std::vector<V> positions = randomVectors<V>(state.range);
+  std::vector<V> velocities = randomVectors<V>(state.range);
+  float sum = 0.0f;
+
+  while (state.keepRunning()) {
+    for (size_t i = 0; i < state.range; ++i) {
+      positions[i] += velocities[i] * 0.016f;
+      sum += positions[i].normalize().dot(velocities[i]);
+    }
+    doNotOptimize(sum);
+    doNotOptimize(positions.data());
+  }
+
+  // Positions are read and written, velocities only read.
+  state.itemsProcessed = state.iterations * state.range;
+  state.bytesProcessed = state.itemsProcessed * 3 * sizeof(V);
+}
+
+static void vec2Ops(BenchState &state) { vecOps<Vec2<float>>(state); }
+
+static void vec3Ops(BenchState &state) { vecOps<Vec3<float>>(state); }
+
+static void vec4Ops(BenchState &state) { vecOps<Vec4<float>>(state); }
+
+JELLY_BENCHMARK(vec2Ops, 1000, 100000);
+JELLY_BENCHMARK(vec3Ops, 1000, 100000);
+JELLY_BENCHMARK(vec4Ops, 1000, 100000);
@@ -0,0 +1,273 @@
+#include <vector>
+
+#include <jelly/game_context.h>
+#include <jelly/null_render_device.h>
+#include <jelly/sprite.h>
+#include <jelly/texture_cache.h>
+
+#include "bench.h"
+
+static Renderer2D &benchRenderer() {
+  initBenchContext();
+  return GameContext::getInstance().getRenderer();
+}
+
+static void submitSprites(Renderer2D &renderer, Sprite &sprite,
+                          size_t count) {
+  renderer.begin();
+  for (size_t i = 0; i < count; ++i) {
+    sprite.setPosition(Vec3<float>(static_cast<float>(i % 1280),
+                                   static_cast<float>((i / 1280) % 720),
+                                   0.0f));
+    renderer.drawSprite(sprite);
+  }
+  renderer.end();
+}
+
+static void drawSprites(BenchState &state, SpritePipeline pipeline) {
+  Renderer2D &renderer = benchRenderer();
+  renderer.setSpritePipeline(pipeline);
+
+  Sprite sprite("textures/martian.png");
+
+  while (state.keepRunning()) {
+    submitSprites(renderer, sprite, state.range);
+    glFinish();
+  }
+
+  // Bytes are what each pipeline writes to the GPU per sprite.
+  size_t spriteBytes = pipeline == SpritePipeline::Instanced
+                           ? sizeof(SpriteInstance)
+                           : 4 * sizeof(BatchQuadVertex);
+  state.itemsProcessed = state.iterations * state.range;
+  state.bytesProcessed = state.itemsProcessed * spriteBytes;
+
+  renderer.setSpritePipeline(SpritePipeline::Batched);
+}
+
+static void drawSpriteBatched(BenchState &state) {
+  drawSprites(state, SpritePipeline::Batched);
+}
+
+static void drawSpriteInstanced(BenchState &state) {
+  drawSprites(state, SpritePipeline::Instanced);
+}
+
+JELLY_BENCHMARK(drawSpriteBatched, 1000, 10000, 200000);
+JELLY_BENCHMARK(drawSpriteInstanced, 1000, 10000, 200000);
+
+static void submitCircles(Renderer2D &renderer, size_t count) {
+  renderer.begin();
+  for (size_t i = 0; i < count; ++i) {
+    Circle circle(Vec2<float>(static_cast<float>(i % 1280),
+                              static_cast<float>((i / 1280) % 720)),
+                  4.0f, i % 2 == 0);
+    renderer.drawCircle(circle);
+  }
+  renderer.end();
+}
+
+static void drawCircles(BenchState &state) {
+  Renderer2D &renderer = benchRenderer();
+
+  while (state.keepRunning()) {
+    submitCircles(renderer, state.range);
+    glFinish();
+  }
+
+  state.itemsProcessed = state.iterations * state.range;
+  state.bytesProcessed = state.itemsProcessed * sizeof(BatchCircleInstance);
+}
+
+JELLY_BENCHMARK(drawCircles, 1000, 50000);
+
+static std::vector<Rectangle> benchRectangles(size_t count) {
+  std::vector<Rectangle> rectangles;
+  rectangles.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    rectangles.emplace_back(Vec2<float>(static_cast<float>(i % 1280),
+                                        static_cast<float>((i / 1280) % 720)),
+                            Vec2<float>(4.0f, 4.0f),
+                            Vec4<float>(1.0f, 1.0f, 1.0f, 1.0f));
+  }
+  return rectangles;
+}
+
+static void drawRectsEach(BenchState &state) {
+  Renderer2D &renderer = benchRenderer();
+  std::vector<Rectangle> rectangles = benchRectangles(state.range);
+
+  while (state.keepRunning()) {
+    renderer.begin();
+    for (const Rectangle &rectangle : rectangles) {
+      renderer.drawRect(rectangle);
+    }
+    renderer.end();
+    glFinish();
+  }
+
+  state.itemsProcessed = state.iterations * state.range;
+}
+
+static void drawRectsBulk(BenchState &state) {
+  Renderer2D &renderer = benchRenderer();
+  std::vector<Rectangle> rectangles = benchRectangles(state.range);
+
+  while (state.keepRunning()) {
+    renderer.begin();
+    renderer.drawRects(rectangles);
+    renderer.end();
+    glFinish();
+  }
+
+  state.itemsProcessed = state.iterations * state.range;
+}
+
+static void drawRectsStatic(BenchState &state) {
+  Renderer2D &renderer = benchRenderer();
+  std::vector<Rectangle> rectangles = benchRectangles(state.range);
+
+  StaticBatch batch;
+  for (const Rectangle &rectangle : rectangles) {
+    batch.add(rectangle);
+  }
+
+  while (state.keepRunning()) {
+    renderer.begin();
+    renderer.drawStaticBatch(batch);
+    renderer.end();
+    glFinish();
+  }
+
+  batch.Delete();
+  state.itemsProcessed = state.iterations * state.range;
+}
+
+// A frame mixing every kind of draw, rendered offscreen. It reports no items
+// so the regression comparison looks at its frame time.
+static void drawScene(BenchState &state) {
+  Renderer2D &renderer = benchRenderer();
+  std::vector<Rectangle> rectangles = benchRectangles(state.range / 3);
+  Sprite sprite("textures/martian.png", Vec4<float>(1.0f, 1.0f, 1.0f, 1.0f),
+                32, 32);
+
+  while (state.keepRunning()) {
+    renderer.begin();
+    renderer.drawRects(rectangles);
+    for (size_t i = 0; i < state.range / 3; ++i) {
+      renderer.drawCircle(Circle(Vec2<float>(static_cast<float>(i % 1280),
+                                             static_cast<float>(i % 720)),
+                                 6.0f, i % 2 == 0));
+      sprite.setPosition(Vec3<float>(static_cast<float>((i * 7) % 1280),
+                                     static_cast<float>((i * 3) % 720),
+                                     0.0f));
+      renderer.drawSprite(sprite);
+    }
+    renderer.end();
+    glFinish();
+  }
+}
+
+JELLY_BENCHMARK(drawScene, 1000, 10000);
+
+// The null device records calls instead of drawing, so the benchmarks below
+// measure the CPU side of batching without a driver or an OpenGL context.
+// Bytes are those handed to the device for upload.
+static NullRenderDevice g_nullDevice;
+
+static Renderer2D &nullRenderer() {
+  static Renderer2D renderer(1280, 720, 1.0f);
+  static bool initialized = false;
+
+  RenderDevice::set(&g_nullDevice);
+  if (!initialized) {
+    g_nullDevice.setLogging(false);
+    renderer.init();
+    initialized = true;
+  }
+  g_nullDevice.reset();
+  return renderer;
+}
+
+static void drawRectsEachNull(BenchState &state) {
+  Renderer2D &renderer = nullRenderer();
+  std::vector<Rectangle> rectangles = benchRectangles(state.range);
+
+  while (state.keepRunning()) {
+    renderer.begin();
+    for (const Rectangle &rectangle : rectangles) {
+      renderer.drawRect(rectangle);
+    }
+    renderer.end();
+  }
+
+  state.itemsProcessed = state.iterations * state.range;
+  state.bytesProcessed = g_nullDevice.getStats().bytesUploaded;
+  RenderDevice::set(nullptr);
+}
+
+static void drawRectsBulkNull(BenchState &state) {
+  Renderer2D &renderer = nullRenderer();
+  std::vector<Rectangle> rectangles = benchRectangles(state.range);
+
+  while (state.keepRunning()) {
+    renderer.begin();
+    renderer.drawRects(rectangles);
+    renderer.end();
+  }
+
+  state.itemsProcessed = state.iterations * state.range;
+  state.bytesProcessed = g_nullDevice.getStats().bytesUploaded;
+  RenderDevice::set(nullptr);
+}
+
+static void drawSpritesNull(BenchState &state, SpritePipeline pipeline) {
+  Renderer2D &renderer = nullRenderer();
+  renderer.setSpritePipeline(pipeline);
+
+  // The texture has to live on the null device, so it comes from a cache of
+  // its own rather than the one of the game context.
+  TextureCache cache;
+  Sprite sprite(cache.load("textures/martian.png"));
+  g_nullDevice.reset();
+
+  while (state.keepRunning()) {
+    submitSprites(renderer, sprite, state.range);
+  }
+
+  state.itemsProcessed = state.iterations * state.range;
+  state.bytesProcessed = g_nullDevice.getStats().bytesUploaded;
+
+  renderer.setSpritePipeline(SpritePipeline::Batched);
+  cache.clear();
+  RenderDevice::set(nullptr);
+}
+
+static void drawSpriteBatchedNull(BenchState &state) {
+  drawSpritesNull(state, SpritePipeline::Batched);
+}
+
+static void drawSpriteInstancedNull(BenchState &state) {
+  drawSpritesNull(state, SpritePipeline::Instanced);
+}
+
+static void drawCirclesNull(BenchState &state) {
+  Renderer2D &renderer = nullRenderer();
+
+  while (state.keepRunning()) {
+    submitCircles(renderer, state.range);
+  }
+
+  state.itemsProcessed = state.iterations * state.range;
+  state.bytesProcessed = g_nullDevice.getStats().bytesUploaded;
+  RenderDevice::set(nullptr);
+}
+
+JELLY_BENCHMARK(drawRectsEach, 1000, 50000);
+JELLY_BENCHMARK(drawRectsBulk, 1000, 50000);
+JELLY_BENCHMARK(drawRectsStatic, 1000, 50000);
+JELLY_BENCHMARK(drawRectsEachNull, 1000, 10000, 100000, 1000000);
+JELLY_BENCHMARK(drawRectsBulkNull, 1000, 10000, 100000, 1000000);
+JELLY_BENCHMARK(drawSpriteBatchedNull, 1000, 10000, 100000, 1000000);
+JELLY_BENCHMARK(drawSpriteInstancedNull, 1000, 10000, 100000, 1000000);
+JELLY_BENCHMARK(drawCirclesNull, 1000, 10000, 100000, 1000000);
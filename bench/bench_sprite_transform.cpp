@@ -0,0 +1,49 @@
+#include <random>
+#include <vector>
+
+#include <jelly/sprite_transform.h>
+
+#include "bench.h"
+
+static void transformKernel(BenchState &state, SimdLevel level) {
+  if (!isSimdLevelSupported(level))
+    return;
+
+  std::mt19937 rng(10);
+  std::uniform_real_distribution<float> position(0.0f, 1280.0f);
+  std::uniform_real_distribution<float> size(8.0f, 128.0f);
+  std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+  SpriteTransformSoA transforms;
+  for (size_t i = 0; i < state.range; ++i) {
+    transforms.push(Vec2<float>(position(rng), position(rng)),
+                    Vec2<float>(size(rng), size(rng)),
+                    Vec2<float>(0.5f, 0.5f), angle(rng));
+  }
+  std::vector<float> corners(state.range * 8);
+
+  while (state.keepRunning()) {
+    transformQuads(transforms, corners.data(), level);
+    doNotOptimize(corners.data());
+  }
+
+  // Eight input floats are read and eight corner floats written per sprite.
+  state.itemsProcessed = state.iterations * state.range;
+  state.bytesProcessed = state.itemsProcessed * 16 * sizeof(float);
+}
+
+static void transformScalar(BenchState &state) {
+  transformKernel(state, SimdLevel::Scalar);
+}
+
+static void transformSSE(BenchState &state) {
+  transformKernel(state, SimdLevel::SSE);
+}
+
+static void transformAVX(BenchState &state) {
+  transformKernel(state, SimdLevel::AVX);
+}
+
+JELLY_BENCHMARK(transformScalar, 10000, 1000000);
+JELLY_BENCHMARK(transformSSE, 10000, 1000000);
+JELLY_BENCHMARK(transformAVX, 10000, 1000000);
@@ -0,0 +1,58 @@
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <jelly/game_context.h>
+#include <jelly/texture_loader.h>
+
+#include "bench.h"
+
+// Enough distinct files that the cache cannot deduplicate them and every
+// decode thread stays busy.
+static const size_t LOAD_IMAGE_COUNT = 32;
+
+static const std::vector<std::string> &loadPaths() {
+  static std::vector<std::string> paths;
+  if (!paths.empty())
+    return paths;
+
+  std::filesystem::path dir =
+      std::filesystem::temp_directory_path() / "jelly_bench_textures";
+  std::filesystem::create_directories(dir);
+  for (size_t i = 0; i < LOAD_IMAGE_COUNT; ++i) {
+    std::filesystem::path path = dir / ("image" + std::to_string(i) + ".png");
+    std::filesystem::copy_file("textures/psyduck.png", path,
+                               std::filesystem::copy_options::skip_existing);
+    paths.push_back(path.string());
+  }
+  return paths;
+}
+
+// Range is the number of decode threads.
+static void loadTexturesAsync(BenchState &state) {
+  initBenchContext();
+  const std::vector<std::string> &paths = loadPaths();
+
+  TextureLoader loader;
+  loader.init(state.range);
+
+  while (state.keepRunning()) {
+    TextureCache cache;
+    std::vector<TextureHandle> handles;
+    for (const std::string &path : paths) {
+      handles.push_back(cache.loadAsync(path.c_str(), loader));
+    }
+    while (!loader.isIdle()) {
+      loader.update();
+      std::this_thread::yield();
+    }
+    glFinish();
+  }
+
+  state.itemsProcessed = state.iterations * paths.size();
+  state.bytesProcessed = loader.getStats().bytesUploaded;
+  loader.shutdown();
+}
+
+JELLY_BENCHMARK(loadTexturesAsync, 1, 2, 4, 8);
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <jelly/game_context.h>
+
+#include "bench.h"
+#include "regression.h"
+
+std::vector<Benchmark> &benchmarkRegistry() {
+  static std::vector<Benchmark> registry;
+  return registry;
+}
+
+static bool g_useWindow = false;
+
+void initBenchContext() {
+  if (g_useWindow || !GameContext::initHeadless(1280, 720)) {
+    GameContext::init(1280, 720, "jelly_bench");
+  }
+}
+
+static void printRate(const char *unit, double perSecond) {
+  const char *prefixes[] = {"", "k", "M", "G", "T"};
+  int prefix = 0;
+  while (perSecond >= 1000.0 && prefix < 4) {
+    perSecond /= 1000.0;
+    ++prefix;
+  }
+  printf(" %8.2f %s%s/s", perSecond, prefixes[prefix], unit);
+}
+
+static BenchState runBenchmark(const Benchmark &benchmark, size_t range,
+                               double minTime) {
+  // Grow the iteration count until one run takes at least minTime.
+  size_t iterations = 1;
+  while (true) {
+    BenchState state(range, iterations);
+    benchmark.function(state);
+
+    double elapsed = state.elapsedSeconds();
+    if (elapsed >= minTime || iterations >= 1000000000) {
+      return state;
+    }
+
+    double scale = elapsed > 0.0 ? minTime * 1.4 / elapsed : 10.0;
+    if (scale > 10.0)
+      scale = 10.0;
+    if (scale < 2.0)
+      scale = 2.0;
+    iterations = static_cast<size_t>(iterations * scale);
+  }
+}
+
+// Whether a name contains any of the comma-separated substrings of a filter.
+static bool matchesFilter(const char *name, const char *filter) {
+  std::string patterns = filter;
+  size_t start = 0;
+  while (true) {
+    size_t end = patterns.find(',', start);
+    std::string pattern = patterns.substr(start, end - start);
+    if (strstr(name, pattern.c_str()) != nullptr)
+      return true;
+    if (end == std::string::npos)
+      return false;
+    start = end + 1;
+  }
+}
+
+// Whether a baseline lists the benchmark at the range.
+static bool inBaseline(const std::vector<BenchResult> &baseline,
+                       const char *function, size_t range) {
+  return std::any_of(baseline.begin(), baseline.end(),
+                     [&](const BenchResult &result) {
+                       return result.function == function &&
+                              result.range == range;
+                     });
+}
+
+int main(int argc, char **argv) {
+  const char *filter = "";
+  const char *jsonPath = nullptr;
+  const char *baselinePath = nullptr;
+  double minTime = 0.5;
+  double threshold = 0.1;
+  size_t repetitions = 1;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], "--filter=", 9) == 0) {
+      filter = argv[i] + 9;
+    } else if (strncmp(argv[i], "--min-time=", 11) == 0) {
+      minTime = atof(argv[i] + 11);
+    } else if (strncmp(argv[i], "--repetitions=", 14) == 0) {
+      repetitions = std::max(atoi(argv[i] + 14), 1);
+    } else if (strncmp(argv[i], "--json=", 7) == 0) {
+      jsonPath = argv[i] + 7;
+    } else if (strncmp(argv[i], "--baseline=", 11) == 0) {
+      baselinePath = argv[i] + 11;
+    } else if (strncmp(argv[i], "--threshold=", 12) == 0) {
+      threshold = atof(argv[i] + 12);
+    } else if (strcmp(argv[i], "--window") == 0) {
+      g_useWindow = true;
+    } else {
+      fprintf(stderr,
+              "Usage: %s [--filter=substring,...] [--min-time=seconds] "
+              "[--repetitions=count] [--json=path] [--baseline=path] "
+              "[--threshold=fraction] [--window]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
+  // With a baseline only the benchmarks it lists run. Exit code 77 tells
+  // CTest to report the comparison as skipped when there is none.
+  std::vector<BenchResult> baseline;
+  if (baselinePath != nullptr) {
+    if (!std::filesystem::exists(baselinePath)) {
+      printf("No baseline at %s; skipping the comparison.\n", baselinePath);
+      return 77;
+    }
+    if (!readResults(baselinePath, baseline))
+      return 1;
+  }
+
+  std::vector<BenchResult> results;
+  printf("%-44s %12s %14s\n", "Benchmark", "Iterations", "Time/iter");
+  for (const Benchmark &benchmark : benchmarkRegistry()) {
+    if (!matchesFilter(benchmark.name, filter))
+      continue;
+
+    for (size_t range : benchmark.ranges) {
+      if (baselinePath != nullptr &&
+          !inBaseline(baseline, benchmark.name, range))
+        continue;
+
+      std::vector<double> seconds;
+      std::vector<double> items;
+      std::vector<double> bytes;
+      for (size_t repetition = 0; repetition < repetitions; ++repetition) {
+        BenchState state = runBenchmark(benchmark, range, minTime);
+        double elapsed = state.elapsedSeconds();
+        std::string name =
+            std::string(benchmark.name) + "/" + std::to_string(range);
+
+        printf("%-44s %12zu %11.3f us", name.c_str(), state.iterations,
+               elapsed * 1e6 / state.iterations);
+        if (state.itemsProcessed > 0)
+          printRate("items", state.itemsProcessed / elapsed);
+        if (state.bytesProcessed > 0)
+          printRate("B", state.bytesProcessed / elapsed);
+        printf("\n");
+
+        // Benchmarks that return without measuring, such as a SIMD level
+        // the CPU lacks, leave no results.
+        if (elapsed <= 0.0)
+          break;
+        seconds.push_back(elapsed / state.iterations);
+        items.push_back(state.itemsProcessed / elapsed);
+        bytes.push_back(state.bytesProcessed / elapsed);
+      }
+
+      if (seconds.empty())
+        continue;
+      BenchResult result;
+      result.function = benchmark.name;
+      result.range = range;
+      result.repetitions = seconds.size();
+      result.secondsPerIteration = summarize(seconds);
+      result.itemsPerSecond = summarize(items);
+      result.bytesPerSecond = summarize(bytes);
+      results.push_back(result);
+    }
+  }
+
+  // Renderer benchmarks create the context on first use.
+  GameContext::shutdown();
+
+  if (jsonPath != nullptr && !writeResults(jsonPath, results))
+    return 1;
+  if (baselinePath != nullptr && !compareResults(baseline, results, threshold))
+    return 1;
+  return 0;
+}
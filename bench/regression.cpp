@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "regression.h"
+
+SampleSummary summarize(std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  size_t n = samples.size();
+
+  SampleSummary summary;
+  summary.median = n % 2 == 1
+                       ? samples[n / 2]
+                       : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+
+  // The k-th smallest and k-th largest samples bound the median with a
+  // confidence of 1 - 2 * P(X < k), X ~ Binomial(n, 0.5). Take the largest k
+  // that still gives 95%.
+  size_t k = 0;
+  double term = 1.0;
+  for (size_t i = 0; i < n; ++i) {
+    term *= 0.5;
+  }
+  double cumulative = 0.0;
+  for (size_t i = 0; i < n / 2; ++i) {
+    cumulative += term;
+    if (cumulative > 0.025)
+      break;
+    k = i + 1;
+    term = term * static_cast<double>(n - i) / static_cast<double>(i + 1);
+  }
+
+  size_t lowIndex = k > 0 ? k - 1 : 0;
+  size_t highIndex = k > 0 ? n - k : n - 1;
+  summary.low = samples[lowIndex];
+  summary.high = samples[highIndex];
+  return summary;
+}
+
+std::string BenchResult::name() const {
+  return function + "/" + std::to_string(range);
+}
+
+static void writeSummary(FILE *file, const char *key,
+                         const SampleSummary &summary) {
+  fprintf(file, ", \"%s\": %.9g, \"%s_ci\": [%.9g, %.9g]", key,
+          summary.median, key, summary.low, summary.high);
+}
+
+bool writeResults(const char *path, const std::vector<BenchResult> &results) {
+  FILE *file = fopen(path, "w");
+  if (file == nullptr) {
+    fprintf(stderr, "Error: Unable to open file for writing: %s\n", path);
+    return false;
+  }
+
+  fprintf(file, "{\n  \"benchmarks\": [");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchResult &result = results[i];
+    fprintf(file,
+            "%s\n    {\"name\": \"%s\", \"function\": \"%s\", \"range\": %zu, "
+            "\"repetitions\": %zu",
+            i == 0 ? "" : ",", result.name().c_str(), result.function.c_str(),
+            result.range, result.repetitions);
+    writeSummary(file, "seconds_per_iteration", result.secondsPerIteration);
+    writeSummary(file, "items_per_second", result.itemsPerSecond);
+    writeSummary(file, "bytes_per_second", result.bytesPerSecond);
+    fprintf(file, "}");
+  }
+  fprintf(file, "\n  ]\n}\n");
+
+  bool ok = ferror(file) == 0;
+  fclose(file);
+  if (!ok) {
+    fprintf(stderr, "Error: Failed to write data to file: %s\n", path);
+  }
+  return ok;
+}
+
+// Finds the value after "key": on a line; nullptr if the key is missing.
+static const char *findValue(const std::string &line, const char *key) {
+  std::string pattern = std::string("\"") + key + "\": ";
+  size_t position = line.find(pattern);
+  if (position == std::string::npos)
+    return nullptr;
+  return line.c_str() + position + pattern.size();
+}
+
+static void readSummary(const std::string &line, const char *key,
+                        SampleSummary &summary) {
+  if (const char *value = findValue(line, key)) {
+    summary.median = strtod(value, nullptr);
+    summary.low = summary.median;
+    summary.high = summary.median;
+  }
+
+  std::string intervalKey = std::string(key) + "_ci";
+  if (const char *value = findValue(line, intervalKey.c_str())) {
+    char *end = nullptr;
+    summary.low = strtod(value + 1, &end);
+    summary.high = strtod(end + 1, nullptr);
+  }
+}
+
+bool readResults(const char *path, std::vector<BenchResult> &results) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    fprintf(stderr, "Error: Unable to open file for reading: %s\n", path);
+    return false;
+  }
+
+  results.clear();
+  std::string line;
+  while (std::getline(file, line)) {
+    const char *function = findValue(line, "function");
+    const char *range = findValue(line, "range");
+    if (function == nullptr || range == nullptr || *function != '"')
+      continue;
+
+    BenchResult result;
+    const char *end = strchr(function + 1, '"');
+    if (end == nullptr)
+      continue;
+    result.function.assign(function + 1, end);
+    result.range = strtoull(range, nullptr, 10);
+    if (const char *repetitions = findValue(line, "repetitions")) {
+      result.repetitions = strtoull(repetitions, nullptr, 10);
+    }
+    readSummary(line, "seconds_per_iteration", result.secondsPerIteration);
+    readSummary(line, "items_per_second", result.itemsPerSecond);
+    readSummary(line, "bytes_per_second", result.bytesPerSecond);
+    results.push_back(result);
+  }
+
+  if (results.empty()) {
+    fprintf(stderr, "Error: No benchmark results in %s\n", path);
+    return false;
+  }
+  return true;
+}
+
+static std::string formatRate(double perSecond) {
+  const char *prefixes[] = {"", "k", "M", "G", "T"};
+  int prefix = 0;
+  while (perSecond >= 1000.0 && prefix < 4) {
+    perSecond /= 1000.0;
+    ++prefix;
+  }
+  char text[32];
+  snprintf(text, sizeof(text), "%.2f %sitems/s", perSecond, prefixes[prefix]);
+  return text;
+}
+
+static std::string formatTime(double seconds) {
+  char text[32];
+  snprintf(text, sizeof(text), "%.3f us", seconds * 1e6);
+  return text;
+}
+
+bool compareResults(const std::vector<BenchResult> &baseline,
+                    const std::vector<BenchResult> &current,
+                    double threshold) {
+  printf("\n%-36s %18s %18s %8s  %s\n", "Benchmark", "Baseline", "Current",
+         "Speed", "Status");
+
+  size_t regressions = 0;
+  for (const BenchResult &base : baseline) {
+    std::string name = base.name();
+    auto match = std::find_if(
+        current.begin(), current.end(),
+        [&](const BenchResult &result) { return result.name() == name; });
+    if (match == current.end()) {
+      printf("%-36s %18s %18s %8s  missing\n", name.c_str(), "", "", "");
+      continue;
+    }
+
+    // Speed is positive when the current run is faster, for either metric.
+    bool useItems = base.itemsPerSecond.median > 0.0 &&
+                    match->itemsPerSecond.median > 0.0;
+    double speed;
+    bool separated;
+    std::string before;
+    std::string after;
+    if (useItems) {
+      const SampleSummary &was = base.itemsPerSecond;
+      const SampleSummary &now = match->itemsPerSecond;
+      speed = now.median / was.median - 1.0;
+      separated = speed < 0.0 ? now.high < was.low : now.low > was.high;
+      before = formatRate(was.median);
+      after = formatRate(now.median);
+    } else {
+      const SampleSummary &was = base.secondsPerIteration;
+      const SampleSummary &now = match->secondsPerIteration;
+      speed = was.median / now.median - 1.0;
+      separated = speed < 0.0 ? now.low > was.high : now.high < was.low;
+      before = formatTime(was.median);
+      after = formatTime(now.median);
+    }
+
+    const char *status = "ok";
+    if (separated && speed < -threshold) {
+      status = "REGRESSED";
+      ++regressions;
+    } else if (separated && speed > threshold) {
+      status = "improved";
+    }
+
+    printf("%-36s %18s %18s %+7.1f%%  %s\n", name.c_str(), before.c_str(),
+           after.c_str(), speed * 100.0, status);
+  }
+
+  if (regressions > 0) {
+    printf("\n%zu of %zu benchmarks regressed by more than %.0f%%.\n",
+           regressions, baseline.size(), threshold * 100.0);
+    return false;
+  }
+  printf("\nNo benchmark regressed by more than %.0f%%.\n", threshold * 100.0);
+  return true;
+}
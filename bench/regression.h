@@ -0,0 +1,95 @@
+/**
+ * @file regression.h
+ * @brief Benchmark results, their JSON files and the comparison against a
+ * stored baseline.
+ */
+#ifndef REGRESSION_H
+#define REGRESSION_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The median of repeated measurements and a confidence interval for
+ * it.
+ */
+struct SampleSummary {
+  double median = 0.0;
+  double low = 0.0;  ///< Lower bound of the 95% confidence interval
+  double high = 0.0; ///< Upper bound of the 95% confidence interval
+};
+
+/**
+ * @brief Summarizes repeated measurements.
+ *
+ * The interval comes from order statistics, so it assumes nothing about the
+ * distribution of the samples. With fewer than six samples no pair of ranks
+ * reaches 95% and the interval spans the smallest to the largest sample.
+ *
+ * @param samples The measurements; at least one.
+ * @return The median and its confidence interval.
+ */
+SampleSummary summarize(std::vector<double> samples);
+
+/**
+ * @brief The measurements of one benchmark at one range.
+ */
+struct BenchResult {
+  std::string function;
+  size_t range = 0;
+  size_t repetitions = 0;
+  SampleSummary secondsPerIteration;
+  SampleSummary itemsPerSecond; ///< All 0 if the benchmark counts no items
+  SampleSummary bytesPerSecond; ///< All 0 if the benchmark counts no bytes
+
+  /**
+   * @brief Gets the name the benchmark is reported under.
+   *
+   * @return The function name and range, such as "mat4Multiply/1000".
+   */
+  std::string name() const;
+};
+
+/**
+ * @brief Writes results as JSON, one benchmark per line.
+ *
+ * @param path The file to write.
+ * @param results The results to write.
+ * @return False if the file could not be written.
+ */
+bool writeResults(const char *path, const std::vector<BenchResult> &results);
+
+/**
+ * @brief Reads results written by writeResults.
+ *
+ * This is not a general JSON parser; it reads one benchmark per line as
+ * writeResults lays them out, so a baseline edited by hand must keep that
+ * layout.
+ *
+ * @param path The file to read.
+ * @param results Receives the results.
+ * @return False if the file could not be read or holds no results.
+ */
+bool readResults(const char *path, std::vector<BenchResult> &results);
+
+/**
+ * @brief Compares results against a baseline and prints a report.
+ *
+ * Items per second are compared where the benchmark counts items, otherwise
+ * the time per iteration, which for a scene is the frame time. A benchmark
+ * regressed when its median is worse than the baseline median by more than
+ * the threshold and its confidence interval does not overlap the baseline
+ * interval, so noise alone does not fail the comparison. Baseline entries
+ * without a current result are reported but do not fail.
+ *
+ * @param baseline The stored results.
+ * @param current The results of this run.
+ * @param threshold The tolerated slowdown, such as 0.1 for 10%.
+ * @return False if any benchmark regressed.
+ */
+bool compareResults(const std::vector<BenchResult> &baseline,
+                    const std::vector<BenchResult> &current,
+                    double threshold);
+
+#endif // REGRESSION_H
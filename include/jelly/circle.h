@@ -2,6 +2,7 @@
 #define CIRCLE_H
 
 #include <jelly/shape.h>
+#include <jelly/vertex_format.h>
 #include <cmath>
 #include <vector>
 
@@ -12,6 +13,7 @@
 class Circle : public Shape {
   float m_radius;
   int m_segments;
+  float m_strokeWidth = 1.0f;
 
 public:
   Circle(const Vec2<float> &position, float radius, bool filled = true,
@@ -62,6 +64,20 @@ public:
 
   float getRadius() const { return m_radius; }
   int getSegments() const { return m_segments; }
+
+  // The renderer draws circles as distance fields; the width applies to
+  // outlined circles and grows inward from the radius.
+  void setStrokeWidth(float width) { m_strokeWidth = width; }
+  float getStrokeWidth() const { return m_strokeWidth; }
+
+  // Writes the circle as one distance-field instance straight into batch
+  // memory, without allocating; returns one past the instance written.
+  template <typename Instance> Instance *emit(Instance *out) const {
+    float strokeWidth = m_filled ? 0.0f : m_strokeWidth;
+    *out++ = VertexFormat<Instance>::make(m_position, m_radius, strokeWidth,
+                                          m_color);
+    return out;
+  }
 };
 
 #endif // CIRCLE_H
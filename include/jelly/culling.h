@@ -0,0 +1,101 @@
+/**
+ * @file culling.h
+ * @brief This file contains the axis-aligned bounding box culling kernels.
+ */
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <jelly/simd.h>
+
+/**
+ * @brief An axis-aligned rectangle given by its minimum and maximum corners.
+ */
+struct CullRect {
+  float minX;
+  float minY;
+  float maxX;
+  float maxY;
+
+  /**
+   * @brief Checks whether this rectangle touches another one.
+   *
+   * Rectangles that only share an edge count as overlapping.
+   *
+   * @param other The rectangle to test against.
+   * @return True if the rectangles overlap.
+   */
+  bool overlaps(const CullRect &other) const {
+    return maxX >= other.minX && minX <= other.maxX && maxY >= other.minY &&
+           minY <= other.maxY;
+  }
+};
+
+/**
+ * @brief Bounding boxes stored as one array per coordinate.
+ *
+ * The structure-of-arrays layout lets the culling kernels load four or eight
+ * boxes per instruction.
+ */
+struct CullBoundsSoA {
+  std::vector<float> minX;
+  std::vector<float> minY;
+  std::vector<float> maxX;
+  std::vector<float> maxY;
+
+  /**
+   * @brief Appends a bounding box.
+   *
+   * @param rect The box to append.
+   */
+  void push(const CullRect &rect) {
+    minX.push_back(rect.minX);
+    minY.push_back(rect.minY);
+    maxX.push_back(rect.maxX);
+    maxY.push_back(rect.maxY);
+  }
+
+  /**
+   * @brief Removes all boxes, keeping the allocated memory.
+   */
+  void clear() {
+    minX.clear();
+    minY.clear();
+    maxX.clear();
+    maxY.clear();
+  }
+
+  /**
+   * @brief Gets the number of boxes.
+   *
+   * @return The box count.
+   */
+  size_t size() const { return minX.size(); }
+};
+
+/**
+ * @brief Counts of culling tests, reset at the start of every frame.
+ */
+struct CullStats {
+  size_t tested = 0; ///< Draws whose bounds were tested
+  size_t culled = 0; ///< Draws dropped because they were off-screen
+};
+
+/**
+ * @brief Finds the boxes that overlap a view rectangle.
+ *
+ * @param bounds The boxes to test.
+ * @param view The visible rectangle.
+ * @param visible Receives the indices of overlapping boxes in ascending
+ * order; it must have room for bounds.size() entries.
+ * @param level The kernel to run. Unsupported levels fall back to the
+ * scalar kernel.
+ * @return The number of indices written to visible.
+ */
+size_t cullBounds(const CullBoundsSoA &bounds, const CullRect &view,
+                  uint32_t *visible, SimdLevel level = bestSimdLevel());
+
+#endif // CULLING_H
@@ -1,23 +1,67 @@
 #ifndef DEBUG_OVERLAY_H
 #define DEBUG_OVERLAY_H
 
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
+class FrameLimiter;
+class Renderer2D;
+struct WindowState;
+
+/**
+ * @brief Number of frames the debug overlay graphs and takes percentiles
+ * over.
+ */
+const size_t OVERLAY_FRAME_HISTORY = 240;
+
 /**
  * @brief A class to manage the debug overlay using Dear ImGui.
+ *
+ * Shows the frame time of the last OVERLAY_FRAME_HISTORY frames as a graph
+ * with percentiles, and the Renderer2D counters of the last frame. The frame
+ * time is the time between two render() calls. The input latency is that
+ * of the latest frame FrameLimiter saw complete.
  */
 class DebugOverlay {
+  using Clock = std::chrono::steady_clock;
+
   GLFWwindow *m_window;
+  Renderer2D *m_renderer;
+  FrameLimiter *m_frameLimiter;
+  const WindowState *m_windowState;
+
+  // Rolling history; the oldest frame is at m_historyHead once it is full.
+  std::array<float, OVERLAY_FRAME_HISTORY> m_frameTimes{};
+  std::array<float, OVERLAY_FRAME_HISTORY> m_drawCalls{};
+  std::array<float, OVERLAY_FRAME_HISTORY> m_latencies{};
+  size_t m_historyHead = 0;
+  size_t m_historyCount = 0;
+  std::vector<float> m_sorted;
+  Clock::time_point m_lastFrame;
+  bool m_timing = false;
+
+  void recordFrame();
+  void renderFrameTimes();
+  void renderLatency();
+  void renderRendererStats();
 
 public:
   /**
    * @brief Initializes the debug overlay.
    * @param window The GLFW window to bind the overlay to.
+   * @param renderer The renderer whose counters are shown.
+   * @param frameLimiter The limiter whose latencies are shown.
+   * @param windowState The cached window state to lay the overlay out in.
    */
-  void init(GLFWwindow *window);
+  void init(GLFWwindow *window, Renderer2D &renderer,
+            FrameLimiter &frameLimiter, const WindowState &windowState);
 
   /**
    * @brief Starts a new frame for the debug overlay.
@@ -11,12 +11,15 @@
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 
+#include <jelly/stream_buffer.h>
+
 /**
  * @class EBO
  * @brief A class to encapsulate an OpenGL Element Buffer Object (EBO).
  */
 class EBO {
-  GLuint m_id; ///< The ID of the EBO.
+  GLuint m_id;           ///< The ID of the EBO.
+  StreamBuffer m_stream; ///< The mapped storage in streaming mode.
 
 public:
   /**
@@ -31,6 +34,13 @@ public:
    */
   void Init(const void *indices, GLsizeiptr size);
 
+  /**
+   * @brief Initializes the EBO with immutable storage holding the indices.
+   * @param indices A pointer to the indices data.
+   * @param size The size of the indices data in bytes.
+   */
+  void InitStatic(const void *indices, GLsizeiptr size);
+
   /**
    * @brief Updates the EBO with new indices.
    * @param indices A pointer to the indices data.
@@ -38,6 +48,46 @@ public:
    */
   void Update(const void *indices, GLsizeiptr size);
 
+  /**
+   * @brief Initializes the EBO as a persistently mapped streaming buffer.
+   * @param regionSize The size of one fenced region in bytes.
+   * @param regionCount The number of regions in the ring.
+   * @return False if the buffer could not be mapped and falls back to
+   * uploads.
+   */
+  bool InitStreaming(GLsizeiptr regionSize,
+                     GLuint regionCount = STREAM_REGION_COUNT);
+
+  /**
+   * @brief Returns a mapped write pointer with at least size bytes free.
+   * @param size The number of bytes that must be writable.
+   * @return A pointer into the mapped buffer.
+   */
+  void *Reserve(GLsizeiptr size);
+
+  /**
+   * @brief Marks bytes written at the write pointer as used.
+   * @param size The number of bytes written.
+   */
+  void Commit(GLsizeiptr size);
+
+  /**
+   * @brief Fences the current region and moves to the next one.
+   */
+  void NextRegion();
+
+  /**
+   * @brief Gets the number of free bytes in the current region.
+   * @return The number of free bytes.
+   */
+  GLsizeiptr getAvailable() const;
+
+  /**
+   * @brief Gets the offset of the write pointer in bytes.
+   * @return The offset from the start of the buffer.
+   */
+  GLintptr getStreamOffset() const;
+
   /**
    * @brief Binds the EBO.
    */
@@ -0,0 +1,148 @@
+/**
+ * @file frame_limiter.h
+ * @brief This file contains the fence-based frames-in-flight limiter and its
+ * per-frame latency measurements.
+ */
+#ifndef FRAME_LIMITER_H
+#define FRAME_LIMITER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+#include <glad/gl.h>
+
+/**
+ * @brief Default number of frames the GPU may still be working on when the
+ * next frame starts.
+ */
+const size_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+/**
+ * @brief The latency of one finished frame, in milliseconds.
+ */
+struct FrameLatency {
+  uint64_t frame;          ///< Frame number, counting from 0
+  double inputToSubmit;    ///< From input poll to the last draw submitted
+  double submitToComplete; ///< From submit until the GPU finished the frame
+  double inputToComplete;  ///< The sum, the latency of the input
+};
+
+/**
+ * @class FrameLimiter
+ * @brief Bounds how many frames are queued to the GPU and measures how long
+ * each takes from input to completion.
+ *
+ * A fence is inserted after each frame is presented. Before the next frame
+ * polls input, waitForSlot() blocks until fewer than the configured number
+ * of fences are pending, so the CPU cannot run ahead of the GPU and input is
+ * sampled no more than that many frames before it reaches the screen.
+ *
+ * A frame is complete when its fence is seen signaled: exactly when
+ * waitForSlot() had to wait for it, otherwise at the next check, so
+ * submitToComplete is an upper bound by up to a frame when the GPU keeps up.
+ * Fences go through RenderDevice, so the limiter works on any context,
+ * including headless ones.
+ */
+class FrameLimiter {
+  using Clock = std::chrono::steady_clock;
+
+  struct PendingFrame {
+    GLsync fence;
+    uint64_t frame;
+    Clock::time_point input;
+    Clock::time_point submit;
+  };
+
+  size_t m_maxFramesInFlight;
+  std::deque<PendingFrame> m_pending; ///< Oldest frame first
+  uint64_t m_frame;
+  Clock::time_point m_input;
+  Clock::time_point m_submit;
+  FrameLatency m_latest;
+  bool m_hasLatest;
+  std::function<void(const FrameLatency &)> m_callback;
+
+  // Retires the oldest pending frame with the result of waiting on it.
+  void complete(GLenum result);
+  void retireSignaled();
+
+public:
+  /**
+   * @param maxFramesInFlight The most frames the GPU may be working on when
+   * a new one starts, or 0 for no limit and no measurements.
+   */
+  explicit FrameLimiter(size_t maxFramesInFlight = DEFAULT_FRAMES_IN_FLIGHT);
+  ~FrameLimiter();
+
+  FrameLimiter(const FrameLimiter &) = delete;
+  FrameLimiter &operator=(const FrameLimiter &) = delete;
+
+  /**
+   * @brief Changes the limit. Frames already in flight are kept.
+   *
+   * @param maxFramesInFlight The new limit, or 0 for no limit.
+   */
+  void setMaxFramesInFlight(size_t maxFramesInFlight);
+
+  /**
+   * @brief Gets the limit.
+   *
+   * @return The most frames in flight, or 0 for no limit.
+   */
+  size_t getMaxFramesInFlight() const;
+
+  /**
+   * @brief Gets the number of frames whose fence has not been seen signaled.
+   *
+   * @return The count.
+   */
+  size_t getFramesInFlight() const;
+
+  /**
+   * @brief Blocks until fewer than the limit of frames are in flight. Call
+   * before polling input.
+   */
+  void waitForSlot();
+
+  /**
+   * @brief Marks the time input was polled for the frame.
+   */
+  void markInput();
+
+  /**
+   * @brief Marks the time the last draw of the frame was submitted. Call
+   * before presenting.
+   */
+  void markSubmit();
+
+  /**
+   * @brief Inserts the fence of the frame. Call after presenting.
+   */
+  void endFrame();
+
+  /**
+   * @brief Gets the latency of the most recently completed frame.
+   *
+   * @return The latency, or nullptr before any frame completed.
+   */
+  const FrameLatency *getLatest() const;
+
+  /**
+   * @brief Sets a function called with the latency of each frame as it
+   * completes, in frame order.
+   *
+   * @param callback The function, or an empty one for none.
+   */
+  void setLatencyCallback(std::function<void(const FrameLatency &)> callback);
+
+  /**
+   * @brief Deletes the pending fences without reporting their frames. Call
+   * before the context is destroyed.
+   */
+  void reset();
+};
+
+#endif // FRAME_LIMITER_H
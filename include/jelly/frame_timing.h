@@ -0,0 +1,103 @@
+/**
+ * @file frame_timing.h
+ * @brief This file contains the fixed-timestep accumulator and the frame
+ * pacer used by GameContext::run.
+ */
+#ifndef FRAME_TIMING_H
+#define FRAME_TIMING_H
+
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @class FixedTimestep
+ * @brief Turns variable frame times into a whole number of fixed simulation
+ * steps.
+ *
+ * Frame time is added to an accumulator and consumed in steps of a fixed
+ * length; what is left is less than one step, and its fraction of a step is
+ * the alpha to interpolate rendering with. After a long stall, such as a
+ * breakpoint, at most maxSteps are run and the rest of the time is dropped,
+ * so the simulation cannot fall further and further behind.
+ */
+class FixedTimestep {
+  double m_step;
+  size_t m_maxSteps;
+  double m_accumulator;
+
+public:
+  /**
+   * @param step The length of one step in seconds.
+   * @param maxSteps The most steps one call to advance() returns.
+   */
+  explicit FixedTimestep(double step, size_t maxSteps = 5);
+
+  /**
+   * @brief Adds the time of a frame and takes the whole steps it completes.
+   *
+   * @param elapsed The frame time in seconds.
+   * @return The number of steps to simulate, at most maxSteps.
+   */
+  size_t advance(double elapsed);
+
+  /**
+   * @brief Gets the step length.
+   *
+   * @return The step in seconds.
+   */
+  double getStep() const;
+
+  /**
+   * @brief Gets how far the time left over is into the next step.
+   *
+   * @return A value in [0, 1); render at previous + (current - previous) *
+   * alpha.
+   */
+  double getAlpha() const;
+
+  /**
+   * @brief Discards the accumulated time.
+   */
+  void reset();
+};
+
+/**
+ * @class FramePacer
+ * @brief Waits until the next frame is due, to hold a target frame time.
+ *
+ * Frames are due at fixed intervals from the first call to wait(), so early
+ * and late frames do not shift the ones after them. Most of the wait is a
+ * sleep; the last spinTime is spent polling the clock, because the operating
+ * system may wake a sleeping thread a millisecond or more late. A frame that
+ * is a whole interval late starts a new schedule rather than rushing to
+ * catch up.
+ */
+class FramePacer {
+  using Clock = std::chrono::steady_clock;
+
+  Clock::duration m_interval;
+  Clock::duration m_spinTime;
+  Clock::time_point m_deadline;
+  bool m_started;
+
+public:
+  /**
+   * @param frameTime The target frame time in seconds, or 0 not to wait.
+   * @param spinTime The part of each wait spent spinning, in seconds.
+   */
+  explicit FramePacer(double frameTime = 0.0, double spinTime = 0.002);
+
+  /**
+   * @brief Changes the target frame time and starts a new schedule.
+   *
+   * @param frameTime The target frame time in seconds, or 0 not to wait.
+   */
+  void setFrameTime(double frameTime);
+
+  /**
+   * @brief Blocks until the next frame is due.
+   */
+  void wait();
+};
+
+#endif // FRAME_TIMING_H
@@ -1,39 +1,144 @@
 #ifndef GAME_CONTEXT_H
 #define GAME_CONTEXT_H
 
+#include <functional>
 #include <iostream>
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 
+#include <jelly/frame_limiter.h>
+#include <jelly/frame_timing.h>
+#include <jelly/headless_context.h>
+#include <jelly/input.h>
 #include <jelly/renderer_2d.h>
 #include <jelly/debug_overlay.h>
+#include <jelly/texture_cache.h>
+#include <jelly/texture_loader.h>
+#include <jelly/window_events.h>
+
+/**
+ * @brief Timing of GameContext::run.
+ */
+struct GameLoopConfig {
+  double updateRate = 60.0;      ///< Fixed simulation steps per second
+  size_t maxUpdatesPerFrame = 5; ///< Steps run at most before rendering
+  int swapInterval = 1;          ///< Vertical blanks per swap; 0 is no vsync
+  double targetFrameRate = 0.0;  ///< Frames per second to pace to, or 0 to
+                                 ///< leave pacing to the swap interval
+  double spinTime = 0.002;       ///< Seconds of each pacing wait spent
+                                 ///< spinning instead of sleeping
+  /// Frames the GPU may still be working on when input is polled, or 0 for
+  /// no limit
+  size_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+};
 
 class GameContext {
   GameContext(int windowWidth, int windowHeight, const char *title,
               bool debugOverlayEnabled);
+  // Creates a headless context instead of a window.
+  GameContext(int width, int height);
   ~GameContext();
 
+  void initGL();
+
   GLFWwindow *m_window;
+  HeadlessContext m_headless;
   Renderer2D m_renderer;
   DebugOverlay m_debugOverlay;
+  TextureCache m_textureCache;
+  TextureLoader m_textureLoader;
+  FrameLimiter m_frameLimiter;
+  WindowEvents m_windowEvents;
+  Input m_input;
+  std::function<void(const WindowEvent &)> m_windowEventCallback;
 
   bool m_debugOverlayEnabled;
+  bool m_running;
 
   static GameContext *m_instance;
 
 public:
   static void init(int windowWidth, int windowHeight, const char *title,
                    bool debugOverlayEnabled = false);
+  // Renders offscreen into the headless context's framebuffer, without a
+  // window or display. Returns false if no headless context is available.
+  static bool initHeadless(int width, int height);
   static void shutdown();
+  static bool isInitialized();
   static GameContext &getInstance();
 
+  // Null in headless mode.
   GLFWwindow *getWindow() const;
+  bool isHeadless() const;
+  HeadlessContext &getHeadlessContext();
+  // Cached; updated by processWindowEvents().
   int getWindowWidth() const;
   int getWindowHeight() const;
+  const WindowState &getWindowState() const;
   Renderer2D &getRenderer();
   DebugOverlay &getDebugOverlay();
+  TextureCache &getTextureCache();
+  TextureLoader &getTextureLoader();
+  FrameLimiter &getFrameLimiter();
+  Input &getInput();
   bool isDebugOverlayEnabled() const;
+
+  /**
+   * @brief Sets the number of vertical blanks to wait for per buffer swap.
+   *
+   * Does nothing in headless mode, which never waits for a display.
+   *
+   * @param interval 1 for vsync, 0 to swap immediately.
+   */
+  void setSwapInterval(int interval);
+
+  /**
+   * @brief Sets a function called with each window event that
+   * processWindowEvents() dispatches.
+   *
+   * @param callback The function, or an empty one for none.
+   */
+  void
+  setWindowEventCallback(std::function<void(const WindowEvent &)> callback);
+
+  /**
+   * @brief Applies the window events since the last call.
+   *
+   * A framebuffer resize sets the viewport and a window resize the
+   * renderer projection, so drawing stays in window coordinates at any
+   * size and pixel density; then each event goes to the window event
+   * callback. Losing focus releases every key and button, since their
+   * releases would go to another window. run() calls this once per frame
+   * after polling; loops of their own call it after glfwPollEvents(),
+   * followed by getInput().update().
+   */
+  void processWindowEvents();
+
+  /**
+   * @brief Runs the game loop until the window closes or stop() is called.
+   *
+   * Each frame waits until fewer than config.framesInFlight frames are
+   * queued to the GPU, polls and processes events, publishes the input
+   * snapshot, continues texture streaming, runs update as many times as the
+   * fixed timestep requires, and calls render between Renderer2D::begin and
+   * end with the interpolation alpha. It then draws the debug overlay if
+   * enabled, presents, fences the frame and waits for the pacer. The
+   * latency of each frame is reported by getFrameLimiter().
+   *
+   * @param update Advances the simulation by the step, in seconds.
+   * @param render Draws the state interpolated alpha of the way from the
+   * previous step to the current one.
+   * @param config The loop timing.
+   */
+  void run(const std::function<void(double step)> &update,
+           const std::function<void(double alpha)> &render,
+           const GameLoopConfig &config = GameLoopConfig());
+
+  /**
+   * @brief Makes run() return after the current frame.
+   */
+  void stop();
 };
 
 #endif // GAME_CONTEXT_H
@@ -0,0 +1,237 @@
+/**
+ * @file gl_instrument.h
+ * @brief This file contains the GL_CHECK macro and the OpenGL call
+ * instrumentation behind it.
+ *
+ * How much GL_CHECK does is fixed at compile time by JELLY_GL_LEVEL:
+ *
+ * - JELLY_GL_OFF: GL_CHECK(stmt) is just stmt.
+ * - JELLY_GL_COUNT: every call site counts its calls.
+ * - JELLY_GL_CHECK: calls are counted and followed by glGetError, and the
+ *   OpenGL debug output is enabled.
+ * - JELLY_GL_TRACE: as JELLY_GL_CHECK, and each call's CPU time is measured.
+ *
+ * glGetError can stall the driver until the GPU catches up, so only debug
+ * builds check errors by default.
+ *
+ * Wrappers that make OpenGL calls on behalf of other code, like
+ * GLRenderDevice, use GL_CHECK_AT instead, so the calls are recorded at
+ * their caller rather than inside the wrapper.
+ */
+#ifndef GL_INSTRUMENT_H
+#define GL_INSTRUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <source_location>
+#include <vector>
+
+#include <glad/gl.h>
+
+#define JELLY_GL_OFF 0
+#define JELLY_GL_COUNT 1
+#define JELLY_GL_CHECK 2
+#define JELLY_GL_TRACE 3
+
+#ifndef JELLY_GL_LEVEL
+#define JELLY_GL_LEVEL JELLY_GL_OFF
+#endif
+
+/**
+ * @brief Number of frames kept in the GLInstrument history.
+ */
+const size_t GL_FRAME_HISTORY = 120;
+
+/**
+ * @brief A GL_CHECK call site and the calls recorded at it.
+ */
+struct GLCallSite {
+  const char *call;        ///< The wrapped statement
+  const char *file;        ///< Source file of the call site
+  int line;                ///< Source line of the call site
+  uint64_t frameCalls = 0; ///< Calls during the current frame
+  uint64_t frameNanos = 0; ///< CPU time during the current frame
+  uint64_t totalCalls = 0; ///< Calls in finished frames
+  uint64_t totalNanos = 0; ///< CPU time in finished frames
+
+  /**
+   * @brief Registers a call site with GLInstrument.
+   */
+  GLCallSite(const char *call, const char *file, int line);
+};
+
+/**
+ * @brief Where an OpenGL wrapper was called from.
+ *
+ * Wrappers take it as a last parameter defaulted to GLCaller::current().
+ */
+using GLCaller = std::source_location;
+
+/**
+ * @brief Totals of one frame of instrumented calls.
+ */
+struct GLFrameStats {
+  uint64_t frame = 0;    ///< Index of the frame
+  uint64_t calls = 0;    ///< Instrumented calls
+  uint64_t cpuNanos = 0; ///< CPU time of the calls, at JELLY_GL_TRACE
+  uint64_t errors = 0;   ///< Errors reported by glGetError
+};
+
+/**
+ * @class GLInstrument
+ * @brief Collects the counts, timings and errors recorded by GL_CHECK, and
+ * filters the OpenGL debug output.
+ *
+ * All calls must come from the thread that owns the OpenGL context.
+ */
+class GLInstrument {
+public:
+  /**
+   * @brief Closes the current frame and moves its totals to the history.
+   */
+  static void nextFrame();
+
+  /**
+   * @brief Gets the number of finished frames in the history.
+   * @return At most GL_FRAME_HISTORY.
+   */
+  static size_t getFrameCount();
+
+  /**
+   * @brief Gets a finished frame from the history.
+   * @param framesAgo 0 for the last finished frame, up to getFrameCount() - 1.
+   * @return The frame totals.
+   */
+  static const GLFrameStats &getFrame(size_t framesAgo);
+
+  /**
+   * @brief Gets every call site reached so far.
+   * @return The call sites, in the order they were first reached.
+   */
+  static const std::vector<GLCallSite *> &getCallSites();
+
+  /**
+   * @brief Gets the call site of a statement run on behalf of a caller,
+   * registering it the first time.
+   *
+   * @param call The wrapped statement.
+   * @param caller The code that called the wrapper.
+   * @return The call site.
+   */
+  static GLCallSite &getCallSite(const char *call, const GLCaller &caller);
+
+  /**
+   * @brief Writes the call sites with the most time, or calls when timing is
+   * off, to a stream.
+   * @param out The stream to write to.
+   * @param maxSites The number of call sites to list.
+   */
+  static void report(std::ostream &out, size_t maxSites = 20);
+
+  /**
+   * @brief Enables the OpenGL debug output with a filtering callback.
+   *
+   * Messages below the minimum severity are dropped, and a message is only
+   * printed the first time it is seen. Does nothing below JELLY_GL_CHECK.
+   *
+   * @param minSeverity The least severe message to print.
+   */
+  static void enableDebugOutput(GLenum minSeverity = GL_DEBUG_SEVERITY_LOW);
+
+  /**
+   * @brief Gets the number of repeated debug messages that were not printed.
+   * @return The count.
+   */
+  static size_t getSuppressedMessageCount();
+
+  /**
+   * @brief Counts an error reported by glGetError.
+   */
+  static void recordError();
+};
+
+/**
+ * @brief Reports every pending OpenGL error for a statement.
+ *
+ * @param stmt The statement that was checked.
+ * @param file The source file of the statement.
+ * @param line The source line of the statement.
+ */
+void checkOpenGLError(const char *stmt, const char *file, int line);
+
+#if JELLY_GL_LEVEL >= JELLY_GL_TRACE
+/**
+ * @brief Adds the lifetime of the timer to a call site's CPU time.
+ */
+class GLCallTimer {
+  GLCallSite &m_site;
+  uint64_t m_start;
+
+public:
+  explicit GLCallTimer(GLCallSite &site);
+  ~GLCallTimer();
+};
+#endif
+
+#if JELLY_GL_LEVEL == JELLY_GL_OFF
+#define GL_CHECK(stmt)                                                         \
+  do {                                                                         \
+    stmt;                                                                      \
+  } while (0)
+#define GL_CHECK_AT(stmt, caller)                                              \
+  do {                                                                         \
+    (void)(caller);                                                            \
+    stmt;                                                                      \
+  } while (0)
+#elif JELLY_GL_LEVEL == JELLY_GL_COUNT
+#define GL_CHECK(stmt)                                                         \
+  do {                                                                         \
+    static GLCallSite jellyGLSite(#stmt, __FILE__, __LINE__);                  \
+    jellyGLSite.frameCalls++;                                                  \
+    stmt;                                                                      \
+  } while (0)
+#define GL_CHECK_AT(stmt, caller)                                              \
+  do {                                                                         \
+    GLInstrument::getCallSite(#stmt, caller).frameCalls++;                     \
+    stmt;                                                                      \
+  } while (0)
+#elif JELLY_GL_LEVEL == JELLY_GL_CHECK
+#define GL_CHECK(stmt)                                                         \
+  do {                                                                         \
+    static GLCallSite jellyGLSite(#stmt, __FILE__, __LINE__);                  \
+    jellyGLSite.frameCalls++;                                                  \
+    stmt;                                                                      \
+    checkOpenGLError(#stmt, __FILE__, __LINE__);                               \
+  } while (0)
+#define GL_CHECK_AT(stmt, caller)                                              \
+  do {                                                                         \
+    GLCallSite &jellyGLSite = GLInstrument::getCallSite(#stmt, caller);        \
+    jellyGLSite.frameCalls++;                                                  \
+    stmt;                                                                      \
+    checkOpenGLError(#stmt, jellyGLSite.file, jellyGLSite.line);               \
+  } while (0)
+#else
+#define GL_CHECK(stmt)                                                         \
+  do {                                                                         \
+    static GLCallSite jellyGLSite(#stmt, __FILE__, __LINE__);                  \
+    jellyGLSite.frameCalls++;                                                  \
+    {                                                                          \
+      GLCallTimer jellyGLTimer(jellyGLSite);                                   \
+      stmt;                                                                    \
+    }                                                                          \
+    checkOpenGLError(#stmt, __FILE__, __LINE__);                               \
+  } while (0)
+#define GL_CHECK_AT(stmt, caller)                                              \
+  do {                                                                         \
+    GLCallSite &jellyGLSite = GLInstrument::getCallSite(#stmt, caller);        \
+    jellyGLSite.frameCalls++;                                                  \
+    {                                                                          \
+      GLCallTimer jellyGLTimer(jellyGLSite);                                   \
+      stmt;                                                                    \
+    }                                                                          \
+    checkOpenGLError(#stmt, jellyGLSite.file, jellyGLSite.line);               \
+  } while (0)
+#endif
+
+#endif // GL_INSTRUMENT_H
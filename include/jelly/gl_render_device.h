@@ -0,0 +1,115 @@
+/**
+ * @file gl_render_device.h
+ * @brief This file contains the RenderDevice that calls OpenGL.
+ */
+#ifndef GL_RENDER_DEVICE_H
+#define GL_RENDER_DEVICE_H
+
+#include <jelly/render_device.h>
+
+/**
+ * @class GLRenderDevice
+ * @brief Forwards every RenderDevice call to the current OpenGL context.
+ *
+ * Each call goes through GL_CHECK_AT, so the instrumentation report lists
+ * the OpenGL calls at the code that made them through the device.
+ */
+class GLRenderDevice : public RenderDevice {
+public:
+  GLuint createBuffer(GLCaller caller = GLCaller::current()) override;
+  void deleteBuffer(GLuint buffer,
+                    GLCaller caller = GLCaller::current()) override;
+  void bindBuffer(GLenum target, GLuint buffer,
+                  GLCaller caller = GLCaller::current()) override;
+  void bufferData(GLenum target, GLsizeiptr size, const void *data,
+                  GLenum usage, GLCaller caller = GLCaller::current()) override;
+  void bufferStorage(GLenum target, GLsizeiptr size, const void *data,
+                     GLbitfield flags,
+                     GLCaller caller = GLCaller::current()) override;
+  void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size,
+                     const void *data,
+                     GLCaller caller = GLCaller::current()) override;
+  void *mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length,
+                       GLbitfield access) override;
+  void unmapBuffer(GLenum target,
+                   GLCaller caller = GLCaller::current()) override;
+  void commitMappedRange(GLuint buffer, GLintptr offset,
+                         GLsizeiptr size) override;
+
+  GLsync fenceSync() override;
+  GLenum clientWaitSync(GLsync sync, GLbitfield flags,
+                        GLuint64 timeout) override;
+  void deleteSync(GLsync sync) override;
+
+  GLuint createVertexArray(GLCaller caller = GLCaller::current()) override;
+  void deleteVertexArray(GLuint vao,
+                         GLCaller caller = GLCaller::current()) override;
+  void bindVertexArray(GLuint vao,
+                       GLCaller caller = GLCaller::current()) override;
+  void vertexAttribPointer(GLuint index, GLint size, GLenum type,
+                           GLboolean normalized, GLsizei stride,
+                           const void *offset,
+                           GLCaller caller = GLCaller::current()) override;
+  void vertexAttribIPointer(GLuint index, GLint size, GLenum type,
+                            GLsizei stride, const void *offset,
+                            GLCaller caller = GLCaller::current()) override;
+  void enableVertexAttribArray(GLuint index,
+                               GLCaller caller = GLCaller::current()) override;
+  void vertexAttribDivisor(GLuint index, GLuint divisor,
+                           GLCaller caller = GLCaller::current()) override;
+
+  GLuint createTexture(GLCaller caller = GLCaller::current()) override;
+  void deleteTexture(GLuint texture,
+                     GLCaller caller = GLCaller::current()) override;
+  void activeTexture(GLuint unit,
+                     GLCaller caller = GLCaller::current()) override;
+  void bindTexture(GLenum target, GLuint texture,
+                   GLCaller caller = GLCaller::current()) override;
+  void texParameteri(GLenum target, GLenum name, GLint value,
+                     GLCaller caller = GLCaller::current()) override;
+  void texImage2D(GLenum target, GLint internalFormat, GLsizei width,
+                  GLsizei height, GLenum format, GLenum type,
+                  const void *pixels,
+                  GLCaller caller = GLCaller::current()) override;
+  void texSubImage2D(GLenum target, GLint x, GLint y, GLsizei width,
+                     GLsizei height, GLenum format, GLenum type,
+                     const void *pixels,
+                     GLCaller caller = GLCaller::current()) override;
+  void generateMipmap(GLenum target,
+                      GLCaller caller = GLCaller::current()) override;
+  void pixelStorei(GLenum name, GLint value,
+                   GLCaller caller = GLCaller::current()) override;
+  void clearTexImage(GLuint texture, GLenum format, GLenum type,
+                     GLCaller caller = GLCaller::current()) override;
+  void getTexImage(GLenum target, GLenum format, GLenum type, void *pixels,
+                   GLCaller caller = GLCaller::current()) override;
+
+  GLuint createProgram(const char *vertexSource,
+                       const char *fragmentSource) override;
+  void deleteProgram(GLuint program) override;
+  void useProgram(GLuint program,
+                  GLCaller caller = GLCaller::current()) override;
+  void getActiveUniforms(GLuint program,
+                         std::vector<ShaderUniform> &uniforms) override;
+  void programUniform1iv(GLuint program, GLint location, GLsizei count,
+                         const GLint *values,
+                         GLCaller caller = GLCaller::current()) override;
+  void programUniformMatrix4fv(GLuint program, GLint location, GLsizei count,
+                               GLboolean transpose, const GLfloat *values,
+                               GLCaller caller = GLCaller::current()) override;
+
+  void clear(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha,
+             GLCaller caller = GLCaller::current()) override;
+  void enable(GLenum capability,
+              GLCaller caller = GLCaller::current()) override;
+  void disable(GLenum capability,
+               GLCaller caller = GLCaller::current()) override;
+  void drawElements(GLenum mode, GLsizei count, GLenum type, const void *offset,
+                    GLint baseVertex = 0,
+                    GLCaller caller = GLCaller::current()) override;
+  void drawArraysInstanced(GLenum mode, GLint first, GLsizei count,
+                           GLsizei instanceCount, GLuint baseInstance = 0,
+                           GLCaller caller = GLCaller::current()) override;
+};
+
+#endif // GL_RENDER_DEVICE_H
@@ -0,0 +1,140 @@
+/**
+ * @file gl_state.h
+ * @brief This file contains the GLState cache of OpenGL bindings.
+ */
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <cstddef>
+
+#include <glad/gl.h>
+
+#include <jelly/gl_instrument.h>
+
+/**
+ * @brief Number of texture units whose 2D bindings are cached.
+ */
+const GLuint GL_STATE_TEXTURE_UNITS = 32;
+
+/**
+ * @brief Binding calls that went through GLState during a frame.
+ */
+struct GLStateStats {
+  size_t issued = 0;  ///< Calls forwarded to the RenderDevice
+  size_t skipped = 0; ///< Calls dropped because the binding was current
+};
+
+/**
+ * @class GLState
+ * @brief Tracks the current OpenGL bindings and skips redundant binds.
+ *
+ * The engine's GL wrappers bind programs, vertex arrays, buffers and
+ * textures through this class, which remembers what is bound in the current
+ * context and drops calls that would not change it. The rest are passed to
+ * the current RenderDevice. Code that changes bindings directly, like the
+ * ImGui backend, must call invalidate() afterwards.
+ *
+ * The cache assumes a single context used from one thread.
+ */
+class GLState {
+public:
+  /**
+   * @brief Makes a program current.
+   * @param program The program ID.
+   * @param caller The code to attribute the call to.
+   */
+  static void useProgram(GLuint program,
+                         GLCaller caller = GLCaller::current());
+
+  /**
+   * @brief Binds a vertex array.
+   *
+   * The element array buffer binding belongs to the vertex array, so it is
+   * treated as unknown after the vertex array changes.
+   *
+   * @param vao The vertex array ID.
+   * @param caller The code to attribute the call to.
+   */
+  static void bindVertexArray(GLuint vao,
+                              GLCaller caller = GLCaller::current());
+
+  /**
+   * @brief Binds a buffer. Only array and element array bindings are cached.
+   * @param target The binding target.
+   * @param buffer The buffer ID.
+   * @param caller The code to attribute the call to.
+   */
+  static void bindBuffer(GLenum target, GLuint buffer,
+                         GLCaller caller = GLCaller::current());
+
+  /**
+   * @brief Binds a texture to a texture unit, switching the active unit only
+   * if the binding changes.
+   * @param unit The texture unit index, starting at 0.
+   * @param target The texture target.
+   * @param texture The texture ID.
+   * @param caller The code to attribute the call to.
+   */
+  static void bindTexture(GLuint unit, GLenum target, GLuint texture,
+                          GLCaller caller = GLCaller::current());
+
+  /**
+   * @brief Binds a texture to the active texture unit.
+   * @param target The texture target.
+   * @param texture The texture ID.
+   * @param caller The code to attribute the call to.
+   */
+  static void bindTexture(GLenum target, GLuint texture,
+                          GLCaller caller = GLCaller::current());
+
+  /**
+   * @brief Makes a texture unit active.
+   * @param unit The texture unit index, starting at 0.
+   * @param caller The code to attribute the call to.
+   */
+  static void activeTexture(GLuint unit,
+                            GLCaller caller = GLCaller::current());
+
+  /**
+   * @brief Forgets a program that is about to be deleted.
+   * @param program The program ID.
+   */
+  static void forgetProgram(GLuint program);
+
+  /**
+   * @brief Forgets a vertex array that is about to be deleted.
+   * @param vao The vertex array ID.
+   */
+  static void forgetVertexArray(GLuint vao);
+
+  /**
+   * @brief Forgets a buffer that is about to be deleted.
+   * @param buffer The buffer ID.
+   */
+  static void forgetBuffer(GLuint buffer);
+
+  /**
+   * @brief Forgets a texture that is about to be deleted.
+   * @param texture The texture ID.
+   */
+  static void forgetTexture(GLuint texture);
+
+  /**
+   * @brief Marks every binding as unknown so the next bind of each kind is
+   * issued.
+   */
+  static void invalidate();
+
+  /**
+   * @brief Starts a new frame of counters.
+   */
+  static void beginFrame();
+
+  /**
+   * @brief Gets the counters of the current frame.
+   * @return The counters.
+   */
+  static const GLStateStats &getFrameStats();
+};
+
+#endif // GL_STATE_H
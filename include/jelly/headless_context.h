@@ -0,0 +1,89 @@
+/**
+ * @file headless_context.h
+ * @brief This file contains the HeadlessContext class, an OpenGL context
+ * that renders offscreen without a window or display.
+ */
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+#include <vector>
+
+#include <glad/gl.h>
+
+/**
+ * @class HeadlessContext
+ * @brief An OpenGL 4.5 core context that renders into a framebuffer object.
+ *
+ * The context is created through EGL, on the Mesa surfaceless platform when
+ * it is available and on a pbuffer otherwise. With Mesa's llvmpipe driver
+ * this needs neither a display nor a GPU, so tests and benchmarks can drive
+ * Renderer2D on headless machines.
+ *
+ * Headless rendering is only compiled in when CMake finds EGL
+ * (JELLY_HEADLESS_EGL); otherwise init() always fails.
+ */
+class HeadlessContext {
+  void *m_display; ///< The EGLDisplay
+  void *m_context; ///< The EGLContext
+  void *m_surface; ///< The EGLSurface, or EGL_NO_SURFACE when surfaceless
+  GLuint m_framebuffer;
+  GLuint m_colorBuffer;
+  int m_width;
+  int m_height;
+
+public:
+  HeadlessContext();
+
+  HeadlessContext(const HeadlessContext &) = delete;
+  HeadlessContext &operator=(const HeadlessContext &) = delete;
+
+  /**
+   * @brief Creates the context, makes it current, loads OpenGL and binds a
+   * framebuffer of the given size with the viewport covering it.
+   *
+   * @param width The width of the framebuffer.
+   * @param height The height of the framebuffer.
+   * @return False, after printing why, if no context could be created.
+   */
+  bool init(int width, int height);
+
+  /**
+   * @brief Destroys the framebuffer and the context.
+   */
+  void shutdown();
+
+  /**
+   * @brief Checks whether init() succeeded.
+   *
+   * @return True while the context exists.
+   */
+  bool isInitialized() const;
+
+  int getWidth() const;
+  int getHeight() const;
+
+  /**
+   * @brief Gets the framebuffer everything is rendered into.
+   *
+   * @return The framebuffer ID.
+   */
+  GLuint getFramebuffer() const;
+
+  /**
+   * @brief Reads the framebuffer back after the pending draws finish.
+   *
+   * @param pixels Receives width * height RGBA8 pixels, bottom row first as
+   * OpenGL returns them.
+   */
+  void readPixels(std::vector<unsigned char> &pixels) const;
+
+  /**
+   * @brief Writes the framebuffer to a PNG file.
+   *
+   * @param path The file to write.
+   * @return False if the file could not be written.
+   */
+  bool savePNG(const char *path) const;
+};
+
+#endif // HEADLESS_CONTEXT_H
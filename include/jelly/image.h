@@ -1,13 +1,35 @@
 #ifndef IMAGE_H
 #define IMAGE_H
 
-#define STBI_NO_SIMD
 #include <stb_image.h>
 
 #include <iostream>
 
+/**
+ * @brief Loads an image file, flipped vertically for OpenGL.
+ *
+ * @param path The file path to the image.
+ * @param width Receives the width of the image.
+ * @param height Receives the height of the image.
+ * @param channels Receives the number of channels in the file.
+ * @param desiredChannels Channels to convert the data to, or 0 to keep the
+ * file's channel count.
+ * @return The pixel data, to be released with free_image, or nullptr.
+ */
 unsigned char *load_image(const char *path, int &width, int &height,
-                          int &channels);
+                          int &channels, int desiredChannels = 0);
 void free_image(unsigned char *data);
 
+/**
+ * @brief Writes RGBA8 pixels to a PNG file.
+ *
+ * @param path The file path to write.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param pixels The pixel data, bottom row first as load_image returns it.
+ * @return False if the file could not be written.
+ */
+bool write_png(const char *path, int width, int height,
+               const unsigned char *pixels);
+
 #endif // IMAGE_H
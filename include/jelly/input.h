@@ -0,0 +1,205 @@
+/**
+ * @file input.h
+ * @brief This file contains the Input subsystem and the per-frame input
+ * snapshots it publishes.
+ */
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+#include <GLFW/glfw3.h>
+
+#include <jelly/spsc_queue.h>
+
+const size_t KEY_COUNT = GLFW_KEY_LAST + 1;
+const size_t MOUSE_BUTTON_COUNT = GLFW_MOUSE_BUTTON_LAST + 1;
+const size_t GAMEPAD_COUNT = GLFW_JOYSTICK_LAST + 1;
+const size_t GAMEPAD_BUTTON_COUNT = GLFW_GAMEPAD_BUTTON_LAST + 1;
+const size_t GAMEPAD_AXIS_COUNT = GLFW_GAMEPAD_AXIS_LAST + 1;
+
+/**
+ * @brief Number of input events that can queue up between two frames.
+ * Further events are dropped and the keys and buttons are queried again.
+ */
+const size_t INPUT_EVENT_QUEUE_CAPACITY = 1024;
+
+enum class InputEventType {
+  Key,               ///< code is the GLFW key, action the GLFW action
+  MouseButton,       ///< code is the GLFW button, action the GLFW action
+  CursorPos,         ///< x and y are the cursor position
+  Scroll,            ///< x and y are the scroll offsets
+  GamepadConnection, ///< code is the joystick, action GLFW_CONNECTED or
+                     ///< GLFW_DISCONNECTED
+};
+
+/**
+ * @brief A raw input event as GLFW reported it.
+ */
+struct InputEvent {
+  InputEventType type;
+  int code = 0;
+  int action = 0;
+  double x = 0.0;
+  double y = 0.0;
+};
+
+/**
+ * @brief The state of a gamepad in a snapshot.
+ */
+struct GamepadSnapshot {
+  bool connected = false;
+  std::bitset<GAMEPAD_BUTTON_COUNT> buttons;  ///< Held at the snapshot
+  std::bitset<GAMEPAD_BUTTON_COUNT> pressed;  ///< Went down since the last
+  std::bitset<GAMEPAD_BUTTON_COUNT> released; ///< Went up since the last
+  std::array<float, GAMEPAD_AXIS_COUNT> axes{};
+};
+
+/**
+ * @brief The input of one frame.
+ *
+ * Pressed and released record every edge since the previous snapshot, so
+ * a key tapped and let go within one frame is both pressed and released
+ * even though it is not down in either snapshot. Key and button codes
+ * outside the GLFW range, such as GLFW_KEY_UNKNOWN, are never down.
+ */
+struct InputSnapshot {
+  uint64_t frame = 0; ///< Number of updates before this snapshot
+
+  std::bitset<KEY_COUNT> keys;         ///< Held at the snapshot
+  std::bitset<KEY_COUNT> previousKeys; ///< Held at the previous snapshot
+  std::bitset<KEY_COUNT> pressedKeys;
+  std::bitset<KEY_COUNT> releasedKeys;
+
+  std::bitset<MOUSE_BUTTON_COUNT> mouseButtons;
+  std::bitset<MOUSE_BUTTON_COUNT> pressedMouseButtons;
+  std::bitset<MOUSE_BUTTON_COUNT> releasedMouseButtons;
+
+  double mouseX = 0.0; ///< Cursor position in window coordinates
+  double mouseY = 0.0;
+  double mouseDeltaX = 0.0; ///< Cursor movement since the last snapshot
+  double mouseDeltaY = 0.0;
+  double scrollX = 0.0; ///< Scrolling since the last snapshot
+  double scrollY = 0.0;
+
+  std::array<GamepadSnapshot, GAMEPAD_COUNT> gamepads;
+
+  bool isKeyDown(int key) const { return validKey(key) && keys[key]; }
+  bool wasKeyDown(int key) const {
+    return validKey(key) && previousKeys[key];
+  }
+  bool isKeyPressed(int key) const {
+    return validKey(key) && pressedKeys[key];
+  }
+  bool isKeyReleased(int key) const {
+    return validKey(key) && releasedKeys[key];
+  }
+
+  bool isMouseButtonDown(int button) const {
+    return validMouseButton(button) && mouseButtons[button];
+  }
+  bool isMouseButtonPressed(int button) const {
+    return validMouseButton(button) && pressedMouseButtons[button];
+  }
+  bool isMouseButtonReleased(int button) const {
+    return validMouseButton(button) && releasedMouseButtons[button];
+  }
+
+  static bool validKey(int key) {
+    return key >= 0 && static_cast<size_t>(key) < KEY_COUNT;
+  }
+  static bool validMouseButton(int button) {
+    return button >= 0 && static_cast<size_t>(button) < MOUSE_BUTTON_COUNT;
+  }
+};
+
+/**
+ * @class Input
+ * @brief Captures keyboard, mouse and gamepad input and publishes it as one
+ * immutable snapshot per frame.
+ *
+ * The GLFW callbacks only push events into a lock-free queue. update(),
+ * called once per frame on the thread that polls events, applies them to a
+ * new snapshot and publishes it; GLFW has no gamepad callbacks besides
+ * connection changes, so update() also reads the connected gamepads.
+ *
+ * Snapshots are triple buffered: the published one is not written again
+ * until two more updates have been published, so any thread may read it
+ * without locking during the frame it was published in and the next one.
+ * Readers that keep it longer must copy it.
+ */
+class Input {
+  GLFWwindow *m_window;
+  SpscQueue<InputEvent, INPUT_EVENT_QUEUE_CAPACITY> m_queue;
+  std::atomic<bool> m_overflowed;
+  bool m_releaseAll;
+
+  std::array<InputSnapshot, 3> m_snapshots;
+  std::atomic<size_t> m_published;
+
+  void apply(InputSnapshot &snapshot, const InputEvent &event);
+  void resync(InputSnapshot &snapshot);
+  void readGamepads(InputSnapshot &snapshot,
+                    const InputSnapshot &previous) const;
+
+  static void onKey(GLFWwindow *window, int key, int scancode, int action,
+                    int mods);
+  static void onMouseButton(GLFWwindow *window, int button, int action,
+                            int mods);
+  static void onCursorPos(GLFWwindow *window, double x, double y);
+  static void onScroll(GLFWwindow *window, double x, double y);
+  static void onJoystick(int joystick, int event);
+
+public:
+  Input();
+  ~Input();
+
+  Input(const Input &) = delete;
+  Input &operator=(const Input &) = delete;
+
+  /**
+   * @brief Installs the callbacks on a window and reads the cursor and the
+   * connected gamepads.
+   *
+   * One Input can be attached at a time. Call before other libraries, such
+   * as the ImGui backend, install callbacks that chain to existing ones.
+   *
+   * @param window The window.
+   */
+  void attach(GLFWwindow *window);
+
+  /**
+   * @brief Queues an event. Called by the producer only: the thread that
+   * polls events, or code injecting input such as replays and tests.
+   *
+   * @param event The event.
+   * @return False if the queue was full.
+   */
+  bool push(const InputEvent &event);
+
+  /**
+   * @brief Releases every key and button at the next update, for when the
+   * window loses focus and would not report releases.
+   */
+  void releaseAll();
+
+  /**
+   * @brief Applies the queued events and publishes the next snapshot.
+   * Called by the consumer only, once per frame.
+   */
+  void update();
+
+  /**
+   * @brief Gets the latest published snapshot. Safe from any thread.
+   *
+   * @return The snapshot, unchanged for the rest of this frame and the
+   * next.
+   */
+  const InputSnapshot &getSnapshot() const;
+};
+
+#endif // INPUT_H
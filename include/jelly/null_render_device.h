@@ -0,0 +1,223 @@
+/**
+ * @file null_render_device.h
+ * @brief This file contains the RenderDevice that records calls instead of
+ * drawing.
+ */
+#ifndef NULL_RENDER_DEVICE_H
+#define NULL_RENDER_DEVICE_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include <jelly/render_device.h>
+
+/**
+ * @brief Kinds of calls a NullRenderDevice records.
+ */
+enum class DeviceCommandType {
+  UseProgram,      ///< A program was made current
+  BindVertexArray, ///< A vertex array was bound
+  BindBuffer,      ///< A buffer was bound
+  ActiveTexture,   ///< The active texture unit changed
+  BindTexture,     ///< A texture was bound to the active unit
+  Enable,          ///< A capability was enabled
+  Disable,         ///< A capability was disabled
+  Upload,          ///< Bytes were written to a buffer or texture
+  Clear,           ///< The color buffer was cleared
+  Draw             ///< Primitives were drawn
+};
+
+/**
+ * @brief One recorded call.
+ *
+ * Only the fields that apply to the type are set; the others are 0.
+ */
+struct DeviceCommand {
+  DeviceCommandType type;
+  GLenum target;    ///< Binding target, capability, or primitive mode
+  GLuint object;    ///< Bound or uploaded-to object, or the texture unit
+  size_t bytes;     ///< Bytes uploaded
+  size_t count;     ///< Vertices or indices drawn per instance
+  size_t instances; ///< Instances drawn, 1 for non-instanced draws
+};
+
+/**
+ * @brief Totals of the calls a NullRenderDevice recorded.
+ */
+struct RenderDeviceStats {
+  size_t drawCalls = 0;     ///< Draw commands
+  size_t stateChanges = 0;  ///< Program, vertex array, buffer, texture and
+                            ///< capability changes
+  size_t uploads = 0;       ///< Buffer and texture uploads
+  size_t bytesUploaded = 0; ///< Bytes in those uploads
+  size_t elementsDrawn = 0; ///< Vertices or indices, summed over instances
+};
+
+/**
+ * @class NullRenderDevice
+ * @brief A RenderDevice that needs no OpenGL context.
+ *
+ * Every call that changes state, uploads data or draws is appended to a log
+ * and added to running totals. Shaders always compile and have no active
+ * uniforms, fences are always signaled, and textures read back as zeros.
+ * Buffers mapped for streaming are backed by memory owned by the device, so
+ * Renderer2D fills them exactly as it would on OpenGL; those writes count as
+ * uploads once they are committed. Texture uploads from a pixel unpack
+ * buffer count only as the buffer writes.
+ *
+ * Benchmarks that run for many frames should turn the log off and read the
+ * totals only.
+ */
+class NullRenderDevice : public RenderDevice {
+  struct Buffer {
+    GLsizeiptr size = 0;
+    std::vector<unsigned char> mapping;
+  };
+
+  GLuint m_nextObject;
+  std::unordered_map<GLuint, Buffer> m_buffers;
+  GLuint m_arrayBuffer;
+  GLuint m_elementBuffer;
+  GLuint m_unpackBuffer;
+  GLuint m_activeUnit;
+  std::vector<GLuint> m_textures; ///< Bound 2D texture per unit
+  std::unordered_map<GLuint, size_t> m_textureSizes; ///< Texels per texture
+  std::vector<DeviceCommand> m_log;
+  bool m_logging;
+  RenderDeviceStats m_stats;
+
+  GLuint &boundBuffer(GLenum target);
+  GLuint boundTexture() const;
+  void record(DeviceCommandType type, GLenum target, GLuint object,
+              size_t bytes = 0, size_t count = 0, size_t instances = 0);
+
+public:
+  NullRenderDevice();
+
+  NullRenderDevice(const NullRenderDevice &) = delete;
+  NullRenderDevice &operator=(const NullRenderDevice &) = delete;
+
+  /**
+   * @brief Gets the recorded calls, oldest first.
+   *
+   * @return The log.
+   */
+  const std::vector<DeviceCommand> &getLog() const;
+
+  /**
+   * @brief Gets the totals since the last reset().
+   *
+   * @return The totals.
+   */
+  const RenderDeviceStats &getStats() const;
+
+  /**
+   * @brief Turns the log on or off. The totals are always kept.
+   *
+   * @param enabled Whether to append calls to the log.
+   */
+  void setLogging(bool enabled);
+
+  /**
+   * @brief Clears the log and the totals. Objects stay alive.
+   */
+  void reset();
+
+  GLuint createBuffer(GLCaller caller = GLCaller::current()) override;
+  void deleteBuffer(GLuint buffer,
+                    GLCaller caller = GLCaller::current()) override;
+  void bindBuffer(GLenum target, GLuint buffer,
+                  GLCaller caller = GLCaller::current()) override;
+  void bufferData(GLenum target, GLsizeiptr size, const void *data,
+                  GLenum usage, GLCaller caller = GLCaller::current()) override;
+  void bufferStorage(GLenum target, GLsizeiptr size, const void *data,
+                     GLbitfield flags,
+                     GLCaller caller = GLCaller::current()) override;
+  void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size,
+                     const void *data,
+                     GLCaller caller = GLCaller::current()) override;
+  void *mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length,
+                       GLbitfield access) override;
+  void unmapBuffer(GLenum target,
+                   GLCaller caller = GLCaller::current()) override;
+  void commitMappedRange(GLuint buffer, GLintptr offset,
+                         GLsizeiptr size) override;
+
+  GLsync fenceSync() override;
+  GLenum clientWaitSync(GLsync sync, GLbitfield flags,
+                        GLuint64 timeout) override;
+  void deleteSync(GLsync sync) override;
+
+  GLuint createVertexArray(GLCaller caller = GLCaller::current()) override;
+  void deleteVertexArray(GLuint vao,
+                         GLCaller caller = GLCaller::current()) override;
+  void bindVertexArray(GLuint vao,
+                       GLCaller caller = GLCaller::current()) override;
+  void vertexAttribPointer(GLuint index, GLint size, GLenum type,
+                           GLboolean normalized, GLsizei stride,
+                           const void *offset,
+                           GLCaller caller = GLCaller::current()) override;
+  void vertexAttribIPointer(GLuint index, GLint size, GLenum type,
+                            GLsizei stride, const void *offset,
+                            GLCaller caller = GLCaller::current()) override;
+  void enableVertexAttribArray(GLuint index,
+                               GLCaller caller = GLCaller::current()) override;
+  void vertexAttribDivisor(GLuint index, GLuint divisor,
+                           GLCaller caller = GLCaller::current()) override;
+
+  GLuint createTexture(GLCaller caller = GLCaller::current()) override;
+  void deleteTexture(GLuint texture,
+                     GLCaller caller = GLCaller::current()) override;
+  void activeTexture(GLuint unit,
+                     GLCaller caller = GLCaller::current()) override;
+  void bindTexture(GLenum target, GLuint texture,
+                   GLCaller caller = GLCaller::current()) override;
+  void texParameteri(GLenum target, GLenum name, GLint value,
+                     GLCaller caller = GLCaller::current()) override;
+  void texImage2D(GLenum target, GLint internalFormat, GLsizei width,
+                  GLsizei height, GLenum format, GLenum type,
+                  const void *pixels,
+                  GLCaller caller = GLCaller::current()) override;
+  void texSubImage2D(GLenum target, GLint x, GLint y, GLsizei width,
+                     GLsizei height, GLenum format, GLenum type,
+                     const void *pixels,
+                     GLCaller caller = GLCaller::current()) override;
+  void generateMipmap(GLenum target,
+                      GLCaller caller = GLCaller::current()) override;
+  void pixelStorei(GLenum name, GLint value,
+                   GLCaller caller = GLCaller::current()) override;
+  void clearTexImage(GLuint texture, GLenum format, GLenum type,
+                     GLCaller caller = GLCaller::current()) override;
+  void getTexImage(GLenum target, GLenum format, GLenum type, void *pixels,
+                   GLCaller caller = GLCaller::current()) override;
+
+  GLuint createProgram(const char *vertexSource,
+                       const char *fragmentSource) override;
+  void deleteProgram(GLuint program) override;
+  void useProgram(GLuint program,
+                  GLCaller caller = GLCaller::current()) override;
+  void getActiveUniforms(GLuint program,
+                         std::vector<ShaderUniform> &uniforms) override;
+  void programUniform1iv(GLuint program, GLint location, GLsizei count,
+                         const GLint *values,
+                         GLCaller caller = GLCaller::current()) override;
+  void programUniformMatrix4fv(GLuint program, GLint location, GLsizei count,
+                               GLboolean transpose, const GLfloat *values,
+                               GLCaller caller = GLCaller::current()) override;
+
+  void clear(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha,
+             GLCaller caller = GLCaller::current()) override;
+  void enable(GLenum capability,
+              GLCaller caller = GLCaller::current()) override;
+  void disable(GLenum capability,
+               GLCaller caller = GLCaller::current()) override;
+  void drawElements(GLenum mode, GLsizei count, GLenum type, const void *offset,
+                    GLint baseVertex = 0,
+                    GLCaller caller = GLCaller::current()) override;
+  void drawArraysInstanced(GLenum mode, GLint first, GLsizei count,
+                           GLsizei instanceCount, GLuint baseInstance = 0,
+                           GLCaller caller = GLCaller::current()) override;
+};
+
+#endif // NULL_RENDER_DEVICE_H
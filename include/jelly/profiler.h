@@ -0,0 +1,209 @@
+/**
+ * @file profiler.h
+ * @brief This file contains the scoped CPU profiler and the
+ * JELLY_PROFILE_ZONE macro.
+ *
+ * Zones are only recorded when JELLY_PROFILE is defined. Without it the
+ * macros expand to nothing, so instrumented code carries no cost; the
+ * Profiler functions still exist and report no events.
+ */
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/**
+ * @brief Number of zones a thread can record before Profiler::collect()
+ * drains them. Further zones are dropped and counted.
+ */
+const size_t PROFILER_RING_CAPACITY = 1 << 15;
+
+/**
+ * @brief Number of collected zones the profiler keeps. Past it the oldest
+ * zones are discarded and counted, so a long run keeps a window of its most
+ * recent frames.
+ */
+const size_t PROFILER_EVENT_CAPACITY = 1 << 18;
+
+/**
+ * @brief A finished zone.
+ */
+struct ProfileEvent {
+  const char *name; ///< Zone name; a string literal or other static string
+  uint64_t start;   ///< Start time in nanoseconds since the profiler epoch
+  uint64_t end;     ///< End time in nanoseconds since the profiler epoch
+  uint32_t thread;  ///< Index of the recording thread, in order of first use
+};
+
+/**
+ * @class ProfileRing
+ * @brief A fixed-size single-producer, single-consumer queue of zones.
+ *
+ * The owning thread pushes without locking; Profiler::collect() pops from
+ * any thread. When the ring is full new zones are dropped rather than
+ * overwriting ones the consumer may be reading.
+ */
+class ProfileRing {
+  ProfileEvent m_events[PROFILER_RING_CAPACITY];
+  // The indices sit on separate cache lines so the producer and the consumer
+  // do not invalidate each other's line on every zone.
+  alignas(64) std::atomic<size_t> m_head; ///< Next slot to write
+  alignas(64) std::atomic<size_t> m_tail; ///< Next slot to read
+  std::atomic<size_t> m_dropped;
+
+public:
+  ProfileRing();
+
+  /**
+   * @brief Appends a zone. Called by the owning thread only.
+   *
+   * @param event The zone.
+   * @return False if the ring was full and the zone was dropped.
+   */
+  bool push(const ProfileEvent &event);
+
+  /**
+   * @brief Moves every queued zone to a vector. Called by one consumer at a
+   * time.
+   *
+   * @param events Receives the zones, oldest first.
+   */
+  void drain(std::vector<ProfileEvent> &events);
+
+  /**
+   * @brief Gets the number of zones dropped because the ring was full.
+   *
+   * @return The count.
+   */
+  size_t getDroppedCount() const;
+};
+
+/**
+ * @class Profiler
+ * @brief Collects the zones of every thread and exports them as a trace.
+ *
+ * Each thread records into its own ProfileRing, taken on its first zone.
+ * Call collect() regularly, such as once per frame, so the rings do not
+ * fill up; the most recent PROFILER_EVENT_CAPACITY collected zones are kept
+ * until clear(). The first collect() after a thread exits frees its ring for
+ * the next new thread.
+ */
+class Profiler {
+public:
+  /**
+   * @brief Gets the current time on the profiler clock.
+   *
+   * @return Nanoseconds since the profiler epoch, the first call.
+   */
+  static uint64_t now();
+
+  /**
+   * @brief Records a zone on the calling thread.
+   *
+   * @param name The zone name, which must outlive the profiler.
+   * @param start The start time from now().
+   * @param end The end time from now().
+   */
+  static void record(const char *name, uint64_t start, uint64_t end);
+
+  /**
+   * @brief Names the calling thread in exported traces.
+   *
+   * @param name The thread name, which must outlive the profiler.
+   */
+  static void setThreadName(const char *name);
+
+  /**
+   * @brief Moves the zones of every thread to the collected zones.
+   */
+  static void collect();
+
+  /**
+   * @brief Gets the collected zones.
+   *
+   * @return The zones in the order they were collected; zones of one thread
+   * are in the order they ended.
+   */
+  static const std::deque<ProfileEvent> &getEvents();
+
+  /**
+   * @brief Gets the number of zones dropped because a ring was full.
+   *
+   * @return The count over all threads.
+   */
+  static size_t getDroppedCount();
+
+  /**
+   * @brief Gets the number of collected zones discarded to stay within
+   * PROFILER_EVENT_CAPACITY.
+   *
+   * @return The count since the program started.
+   */
+  static size_t getDiscardedCount();
+
+  /**
+   * @brief Gets the number of rings allocated, for running threads and
+   * spare ones left by exited threads.
+   *
+   * @return The count.
+   */
+  static size_t getRingCount();
+
+  /**
+   * @brief Collects and then discards every zone.
+   */
+  static void clear();
+
+  /**
+   * @brief Collects and writes the kept zones in the Chrome trace event
+   * format.
+   *
+   * The file opens in chrome://tracing and ui.perfetto.dev.
+   *
+   * @param path The file to write.
+   * @return False if the file could not be written.
+   */
+  static bool writeChromeTrace(const char *path);
+};
+
+/**
+ * @class ProfileZone
+ * @brief Records the lifetime of the object as a zone.
+ */
+class ProfileZone {
+  const char *m_name;
+  uint64_t m_start;
+
+public:
+  explicit ProfileZone(const char *name)
+      : m_name(name), m_start(Profiler::now()) {}
+  ~ProfileZone() { Profiler::record(m_name, m_start, Profiler::now()); }
+
+  ProfileZone(const ProfileZone &) = delete;
+  ProfileZone &operator=(const ProfileZone &) = delete;
+};
+
+#define JELLY_PROFILE_CONCAT_(a, b) a##b
+#define JELLY_PROFILE_CONCAT(a, b) JELLY_PROFILE_CONCAT_(a, b)
+
+#ifdef JELLY_PROFILE
+/**
+ * @brief Records the rest of the enclosing scope as a zone.
+ */
+#define JELLY_PROFILE_ZONE(name)                                               \
+  ProfileZone JELLY_PROFILE_CONCAT(jellyProfileZone, __LINE__)(name)
+
+/**
+ * @brief Names the calling thread in exported traces.
+ */
+#define JELLY_PROFILE_THREAD(name) Profiler::setThreadName(name)
+#else
+#define JELLY_PROFILE_ZONE(name) static_cast<void>(0)
+#define JELLY_PROFILE_THREAD(name) static_cast<void>(0)
+#endif
+
+#endif // PROFILER_H
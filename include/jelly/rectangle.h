@@ -2,6 +2,7 @@
 #define RECTANGLE_H
 
 #include <jelly/shape.h>
+#include <jelly/vertex_format.h>
 
 class Rectangle : public Shape {
   Vec2<float> m_size;
@@ -35,6 +36,23 @@ public:
       };
     }
   }
+
+  const Vec2<float> &getSize() const { return m_size; }
+
+  // Writes the four corners in getVertices() order straight into batch
+  // memory, without allocating; returns one past the last vertex written.
+  template <typename Vertex> Vertex *emit(Vertex *out) const {
+    using Format = VertexFormat<Vertex>;
+    const Vec2<float> uv(0.0f, 0.0f);
+    *out++ = Format::make(m_position, uv, m_color, -1);
+    *out++ = Format::make({m_position.x + m_size.x, m_position.y}, uv, m_color,
+                          -1);
+    *out++ = Format::make({m_position.x + m_size.x, m_position.y + m_size.y},
+                          uv, m_color, -1);
+    *out++ = Format::make({m_position.x, m_position.y + m_size.y}, uv, m_color,
+                          -1);
+    return out;
+  }
 };
 
 #endif // RECTANGLE_H
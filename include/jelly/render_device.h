@@ -0,0 +1,224 @@
+/**
+ * @file render_device.h
+ * @brief This file contains the RenderDevice interface the GL wrappers draw
+ * through.
+ */
+#ifndef RENDER_DEVICE_H
+#define RENDER_DEVICE_H
+
+#include <vector>
+
+#include <glad/gl.h>
+
+#include <jelly/gl_instrument.h>
+
+struct ShaderUniform;
+
+/**
+ * @class RenderDevice
+ * @brief The graphics calls made by VBO, EBO, VAO, StreamBuffer, Shader,
+ * Texture, GLState and Renderer2D.
+ *
+ * Unless stated otherwise, each method does what the OpenGL function of the
+ * same name does. GLRenderDevice forwards them to OpenGL, and
+ * NullRenderDevice records them without a context, so the batching in
+ * Renderer2D can be measured and tested apart from the driver.
+ *
+ * Methods that GLRenderDevice instruments take the caller's location as a
+ * last, defaulted argument, so GL_CHECK statistics and errors point at the
+ * code using the device rather than at the device. Wrappers that only pass
+ * a call on forward their own caller.
+ *
+ * The current device is global and used from the rendering thread only.
+ * Objects created on one device must be deleted before switching to
+ * another.
+ */
+class RenderDevice {
+public:
+  virtual ~RenderDevice() = default;
+
+  /**
+   * @brief Gets the current device.
+   *
+   * @return The device set with set(), or the OpenGL device.
+   */
+  static RenderDevice &get();
+
+  /**
+   * @brief Makes a device current and forgets the cached GLState bindings.
+   *
+   * @param device The device, or nullptr for the OpenGL device.
+   */
+  static void set(RenderDevice *device);
+
+  /// @name Buffers
+  /// @{
+  virtual GLuint createBuffer(GLCaller caller = GLCaller::current()) = 0;
+  virtual void deleteBuffer(GLuint buffer,
+                            GLCaller caller = GLCaller::current()) = 0;
+  virtual void bindBuffer(GLenum target, GLuint buffer,
+                          GLCaller caller = GLCaller::current()) = 0;
+  virtual void bufferData(GLenum target, GLsizeiptr size, const void *data,
+                          GLenum usage,
+                          GLCaller caller = GLCaller::current()) = 0;
+  virtual void bufferStorage(GLenum target, GLsizeiptr size, const void *data,
+                             GLbitfield flags,
+                             GLCaller caller = GLCaller::current()) = 0;
+  virtual void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size,
+                             const void *data,
+                             GLCaller caller = GLCaller::current()) = 0;
+  virtual void *mapBufferRange(GLenum target, GLintptr offset,
+                               GLsizeiptr length, GLbitfield access) = 0;
+  virtual void unmapBuffer(GLenum target,
+                           GLCaller caller = GLCaller::current()) = 0;
+
+  /**
+   * @brief Reports bytes written through a persistent coherent mapping.
+   *
+   * OpenGL sees such writes without a call, so the OpenGL device does
+   * nothing; the null device counts them as uploaded.
+   *
+   * @param buffer The mapped buffer.
+   * @param offset The offset of the written bytes.
+   * @param size The number of bytes written.
+   */
+  virtual void commitMappedRange(GLuint buffer, GLintptr offset,
+                                 GLsizeiptr size) = 0;
+  /// @}
+
+  /// @name Fences
+  /// @{
+  virtual GLsync fenceSync() = 0;
+  virtual GLenum clientWaitSync(GLsync sync, GLbitfield flags,
+                                GLuint64 timeout) = 0;
+  virtual void deleteSync(GLsync sync) = 0;
+  /// @}
+
+  /// @name Vertex arrays
+  /// @{
+  virtual GLuint createVertexArray(GLCaller caller = GLCaller::current()) = 0;
+  virtual void deleteVertexArray(GLuint vao,
+                                 GLCaller caller = GLCaller::current()) = 0;
+  virtual void bindVertexArray(GLuint vao,
+                               GLCaller caller = GLCaller::current()) = 0;
+  virtual void vertexAttribPointer(GLuint index, GLint size, GLenum type,
+                                   GLboolean normalized, GLsizei stride,
+                                   const void *offset,
+                                   GLCaller caller = GLCaller::current()) = 0;
+  virtual void vertexAttribIPointer(GLuint index, GLint size, GLenum type,
+                                    GLsizei stride, const void *offset,
+                                    GLCaller caller = GLCaller::current()) = 0;
+  virtual void enableVertexAttribArray(
+      GLuint index, GLCaller caller = GLCaller::current()) = 0;
+  virtual void vertexAttribDivisor(GLuint index, GLuint divisor,
+                                   GLCaller caller = GLCaller::current()) = 0;
+  /// @}
+
+  /// @name Textures
+  /// @{
+  virtual GLuint createTexture(GLCaller caller = GLCaller::current()) = 0;
+  virtual void deleteTexture(GLuint texture,
+                             GLCaller caller = GLCaller::current()) = 0;
+
+  /**
+   * @brief Selects the active texture unit.
+   *
+   * @param unit The unit index, starting at 0 rather than GL_TEXTURE0.
+   */
+  virtual void activeTexture(GLuint unit,
+                             GLCaller caller = GLCaller::current()) = 0;
+  virtual void bindTexture(GLenum target, GLuint texture,
+                           GLCaller caller = GLCaller::current()) = 0;
+  virtual void texParameteri(GLenum target, GLenum name, GLint value,
+                             GLCaller caller = GLCaller::current()) = 0;
+  virtual void texImage2D(GLenum target, GLint internalFormat, GLsizei width,
+                          GLsizei height, GLenum format, GLenum type,
+                          const void *pixels,
+                          GLCaller caller = GLCaller::current()) = 0;
+  virtual void texSubImage2D(GLenum target, GLint x, GLint y, GLsizei width,
+                             GLsizei height, GLenum format, GLenum type,
+                             const void *pixels,
+                             GLCaller caller = GLCaller::current()) = 0;
+  virtual void generateMipmap(GLenum target,
+                              GLCaller caller = GLCaller::current()) = 0;
+  virtual void pixelStorei(GLenum name, GLint value,
+                           GLCaller caller = GLCaller::current()) = 0;
+
+  /**
+   * @brief Fills level 0 of a texture with zeros; glClearTexImage.
+   */
+  virtual void clearTexImage(GLuint texture, GLenum format, GLenum type,
+                             GLCaller caller = GLCaller::current()) = 0;
+
+  /**
+   * @brief Reads back level 0 of the bound texture; glGetTexImage.
+   */
+  virtual void getTexImage(GLenum target, GLenum format, GLenum type,
+                           void *pixels,
+                           GLCaller caller = GLCaller::current()) = 0;
+  /// @}
+
+  /// @name Programs
+  /// @{
+
+  /**
+   * @brief Compiles and links a program, printing any errors.
+   *
+   * @param vertexSource The vertex shader source.
+   * @param fragmentSource The fragment shader source.
+   * @return The program ID, also when linking failed.
+   */
+  virtual GLuint createProgram(const char *vertexSource,
+                               const char *fragmentSource) = 0;
+  virtual void deleteProgram(GLuint program) = 0;
+  virtual void useProgram(GLuint program,
+                          GLCaller caller = GLCaller::current()) = 0;
+
+  /**
+   * @brief Lists the active uniforms of a linked program.
+   *
+   * @param program The program ID.
+   * @param uniforms Receives the uniforms with their names as OpenGL reports
+   * them; empty if the program did not link.
+   */
+  virtual void getActiveUniforms(GLuint program,
+                                 std::vector<ShaderUniform> &uniforms) = 0;
+  virtual void programUniform1iv(GLuint program, GLint location, GLsizei count,
+                                 const GLint *values,
+                                 GLCaller caller = GLCaller::current()) = 0;
+  virtual void programUniformMatrix4fv(
+      GLuint program, GLint location, GLsizei count, GLboolean transpose,
+      const GLfloat *values, GLCaller caller = GLCaller::current()) = 0;
+  /// @}
+
+  /// @name Drawing
+  /// @{
+
+  /**
+   * @brief Clears the color buffer.
+   */
+  virtual void clear(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha,
+                     GLCaller caller = GLCaller::current()) = 0;
+  virtual void enable(GLenum capability,
+                      GLCaller caller = GLCaller::current()) = 0;
+  virtual void disable(GLenum capability,
+                       GLCaller caller = GLCaller::current()) = 0;
+
+  /**
+   * @brief Draws indexed primitives; glDrawElementsBaseVertex.
+   */
+  virtual void drawElements(GLenum mode, GLsizei count, GLenum type,
+                            const void *offset, GLint baseVertex = 0,
+                            GLCaller caller = GLCaller::current()) = 0;
+
+  /**
+   * @brief Draws instanced primitives; glDrawArraysInstancedBaseInstance.
+   */
+  virtual void drawArraysInstanced(GLenum mode, GLint first, GLsizei count,
+                                   GLsizei instanceCount,
+                                   GLuint baseInstance = 0,
+                                   GLCaller caller = GLCaller::current()) = 0;
+  /// @}
+};
+
+#endif // RENDER_DEVICE_H
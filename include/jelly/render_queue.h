@@ -0,0 +1,109 @@
+/**
+ * @file render_queue.h
+ * @brief This file contains the RenderQueue class and sort key helpers.
+ */
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The kind of draw a queued command replays.
+ */
+enum class RenderCommandType : uint8_t { Sprite, Rectangle, Circle };
+
+/**
+ * @brief A queued draw tagged with its 64-bit sort key.
+ *
+ * The command only references its payload by index; the owner of the queue
+ * keeps the payloads in per-type arrays.
+ */
+struct RenderCommand {
+  uint64_t key;           ///< Sort key, compared as an unsigned integer
+  uint32_t index;         ///< Index of the payload in its per-type array
+  RenderCommandType type; ///< Which per-type array the index refers to
+};
+
+/**
+ * @brief Maps a float layer to 32 bits that sort in the same order.
+ *
+ * @param layer The layer value, usually a position z.
+ * @return The order-preserving bit pattern.
+ */
+uint32_t layerSortBits(float layer);
+
+/**
+ * @brief Builds a sort key that groups draws by render state.
+ *
+ * Layout from the most significant bit: layer (32), pipeline (4),
+ * primitive mode (4), texture (24).
+ *
+ * @param layer The draw layer.
+ * @param pipeline The pipeline that renders the draw.
+ * @param mode The primitive mode within the pipeline.
+ * @param texture The texture ID, or 0 when untextured.
+ * @return The sort key.
+ */
+uint64_t makeSortKey(float layer, uint32_t pipeline, uint32_t mode,
+                     uint32_t texture);
+
+/**
+ * @brief Extracts the layer bits from a sort key.
+ *
+ * @param key The sort key.
+ * @return The layer bits as produced by layerSortBits.
+ */
+inline uint32_t sortKeyLayer(uint64_t key) {
+  return static_cast<uint32_t>(key >> 32);
+}
+
+/**
+ * @class RenderQueue
+ * @brief A list of draw commands sorted by key with an LSD radix sort.
+ *
+ * The radix sort is stable, so commands with equal keys keep their
+ * submission order. Storage is reused across frames.
+ */
+class RenderQueue {
+  std::vector<RenderCommand> m_commands;
+  std::vector<RenderCommand> m_scratch;
+
+public:
+  /**
+   * @brief Appends a command to the queue.
+   *
+   * @param key The sort key of the command.
+   * @param type The kind of draw.
+   * @param index The index of the payload in its per-type array.
+   */
+  void push(uint64_t key, RenderCommandType type, uint32_t index);
+
+  /**
+   * @brief Sorts the commands by key, keeping submission order for ties.
+   *
+   * Byte positions where every key is equal are skipped.
+   */
+  void sort();
+
+  /**
+   * @brief Removes all commands while keeping the allocated storage.
+   */
+  void clear();
+
+  /**
+   * @brief Gets the queued commands.
+   *
+   * @return The commands, in sorted order after sort().
+   */
+  const std::vector<RenderCommand> &getCommands() const;
+
+  /**
+   * @brief Checks whether the queue holds no commands.
+   *
+   * @return True if the queue is empty.
+   */
+  bool empty() const;
+};
+
+#endif // RENDER_QUEUE_H
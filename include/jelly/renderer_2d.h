@@ -1,6 +1,8 @@
 #ifndef RENDERER_2D_H
 #define RENDERER_2D_H
 
+#include <array>
+#include <span>
 #include <vector>
 
 #include <glad/gl.h>
@@ -8,6 +10,7 @@
 #include <jelly/sprite.h>
 #include <jelly/rectangle.h>
 #include <jelly/circle.h>
+#include <jelly/culling.h>
 #include <jelly/mat.h>
 #include <jelly/vec.h>
 #include <jelly/vao.h>
@@ -15,67 +18,238 @@
 #include <jelly/ebo.h>
 #include <jelly/texture.h>
 #include <jelly/shader.h>
+#include <jelly/sprite_transform.h>
+#include <jelly/render_queue.h>
+#include <jelly/static_batch.h>
+#include <jelly/vertex_format.h>
 #include <jelly/utils.h>
 
 const size_t MAX_BATCH_SIZE = 10000;
+const size_t MAX_INSTANCE_BATCH_SIZE = 65536;
 const size_t MAX_TEXTURE_SLOTS = 32;
 
-struct QuadVertex {
-  Vec2<float> position;
-  Vec2<float> uv;
-  Vec4<float> color;
-  float textureIndex;
+/**
+ * @brief Index type of the static quad index buffer.
+ *
+ * A quad batch holds at most MAX_BATCH_SIZE * 4 vertices and draws with a
+ * base vertex, so batch-relative indices always fit in 16 bits.
+ */
+using QuadIndex = GLushort;
+static_assert(MAX_BATCH_SIZE * 4 < 0xFFFF,
+              "quad batch indices must fit below the restart index");
+
+/**
+ * @brief Per-instance record of the instanced sprite pipeline.
+ *
+ * One record replaces the four QuadVertex entries and six indices the batched
+ * pipeline emits per sprite.
+ */
+struct SpriteInstance {
+  Vec2<float> position; ///< Pivot in world space
+  Vec2<float> size;     ///< Scaled width and height in world units
+  Vec4<float> uvRect;   ///< Texture rectangle as (u0, v0, u1, v1)
+  Vec4<float> color;    ///< Tint color
+  float textureIndex;   ///< Texture slot in the batch
+  float rotation;       ///< Rotation about the pivot, in radians
+  Vec2<float> pivot;    ///< Pivot as a fraction of the size
+};
+
+/**
+ * @brief Selects how Renderer2D::drawSprite submits sprites.
+ */
+enum class SpritePipeline {
+  Batched,  ///< Four vertices and six indices per sprite
+  Instanced ///< One SpriteInstance per sprite, drawn instanced
+};
+
+/**
+ * @brief Selects when Renderer2D draw calls reach the batches.
+ */
+enum class RenderSortMode {
+  Immediate, ///< Draws are batched in submission order
+  Batch,     ///< Draws are queued and sorted by layer, then render state
+  Stable     ///< Draws are queued and sorted by layer only, keeping
+             ///< painter's order within a layer; every switch between
+             ///< circles and quads or sprites costs a draw call
+};
+
+/**
+ * @brief Why Renderer2D drew a batch.
+ */
+enum class FlushReason {
+  BatchFull,      ///< The streaming buffer region had no room left
+  TextureSlots,   ///< A new texture did not fit in MAX_TEXTURE_SLOTS
+  FillMode,       ///< Filled and outlined quads cannot share a draw
+  PipelineSwitch, ///< Quads, instanced sprites, circles or the sprite
+                  ///< pipeline changed
+  LayerChange,    ///< A queued draw on a higher layer came next
+  StaticBatch,    ///< A static batch is drawn on top of the pending batches
+  EndOfFrame      ///< Renderer2D::end drew what was left
+};
+
+/**
+ * @brief Number of FlushReason values.
+ */
+const size_t FLUSH_REASON_COUNT = 7;
+
+/**
+ * @brief Gets a short name for a flush reason.
+ *
+ * @param reason The reason.
+ * @return The name, such as "batch full".
+ */
+const char *flushReasonName(FlushReason reason);
+
+/**
+ * @brief Counters of one frame of Renderer2D, reset by begin().
+ */
+struct RenderStats {
+  size_t drawCalls = 0;     ///< Draw commands, static batches included
+  size_t vertices = 0;      ///< Vertices drawn; four per instance
+  size_t indices = 0;       ///< Indices drawn by indexed draws
+  size_t instances = 0;     ///< Sprite and circle instances drawn
+  size_t bytesUploaded = 0; ///< Vertex and instance bytes written to buffers
+  size_t textureBinds = 0;  ///< Texture slots bound for draws
+  std::array<size_t, FLUSH_REASON_COUNT> flushes{}; ///< Flushes per reason
+
+  /**
+   * @brief Gets the number of flushes for a reason.
+   *
+   * @param reason The reason.
+   * @return The count.
+   */
+  size_t getFlushes(FlushReason reason) const {
+    return flushes[static_cast<size_t>(reason)];
+  }
 };
 
-struct CircleVertex {
-  Vec2<float> position;
-  Vec2<float> uv;
-  Vec4<float> color;
-  Vec2<float> center;
-  float radius;
+/**
+ * @brief One batch drawn while debug mode was on.
+ */
+struct FlushRecord {
+  FlushReason reason;
+  const char *batch; ///< "quads", "sprite instances" or "circles"
+  size_t items;      ///< Quads or instances in the batch
 };
 
 class Renderer2D {
-  struct QuadBatch {
-    std::vector<QuadVertex> vertices;
-    std::vector<GLuint> indices;
+  // Batches are written straight into the mapped streaming buffers; the
+  // pointers stay valid until the batch is flushed.
+  template <typename Vertex> struct VertexBatch {
+    Vertex *vertices = nullptr;
+    size_t vertexCount = 0;
+    size_t vertexCapacity = 0;
     std::vector<const Texture *> textures;
     bool filled = true;
   };
 
-  struct CircleBatch {
-    std::vector<CircleVertex> vertices;
-    std::vector<GLuint> indices;
-    bool filled = true;
+  template <typename Instance> struct InstanceBatch {
+    Instance *instances = nullptr;
+    size_t count = 0;
+    size_t capacity = 0;
+    std::vector<const Texture *> textures;
+  };
+
+  // Batched sprites wait here until the batch is flushed, so their corners
+  // are computed for the whole batch at once.
+  struct PendingSprite {
+    size_t vertexOffset;
+    Vec4<float> uvRect;
+    Vec4<float> color;
+    int textureIndex;
+  };
+
+  struct QueuedSprite {
+    SpriteInstance instance;
+    const Texture *texture;
+  };
+
+  // Values of the pipeline field of the sort key.
+  enum SortPipeline : uint32_t {
+    QuadPipeline,
+    InstancePipeline,
+    CirclePipeline
   };
 
   int m_windowWidth;
   int m_windowHeight;
   float m_scale;
   bool m_debugMode;
+  SpritePipeline m_spritePipeline;
+  RenderSortMode m_sortMode;
+
+  bool m_culling;
+  CullRect m_viewBounds;
+  CullStats m_cullStats;
+  RenderStats m_stats;
+  std::vector<FlushRecord> m_flushLog;
+  CullBoundsSoA m_cullBounds;
+  std::vector<uint32_t> m_visible;
+  std::vector<SpriteInstance> m_bulkSprites;
 
   Shader m_quadShader;
   VAO m_quadVao;
   VBO m_quadVbo;
   EBO m_quadEbo;
-  QuadBatch m_quadBatch;
+  VertexBatch<BatchQuadVertex> m_quadBatch;
+  SpriteTransformSoA m_spriteTransforms;
+  std::vector<PendingSprite> m_pendingSprites;
+  std::vector<float> m_spriteCorners;
+
+  Shader m_instanceShader;
+  VAO m_instanceVao;
+  VBO m_instanceVbo;
+  InstanceBatch<SpriteInstance> m_instanceBatch;
 
   Shader m_circleShader;
   VAO m_circleVao;
   VBO m_circleVbo;
-  EBO m_circleEbo;
-  CircleBatch m_circleBatch;
+  InstanceBatch<BatchCircleInstance> m_circleBatch;
+
+  RenderQueue m_queue;
+  std::vector<QueuedSprite> m_queuedSprites;
+  std::vector<Rectangle> m_queuedRects;
+  std::vector<Circle> m_queuedCircles;
 
   Mat4<float> m_projection;
 
   void initQuadShaders();
+  void initInstanceShaders();
   void initCircleShaders();
 
   void initQuadBuffers();
+  void initInstanceBuffers();
   void initCircleBuffers();
 
-  void flushQuad();
-  void flushCircle();
+  bool cull(const CullRect &bounds);
+  size_t cullBulk();
+  void queueSprite(const SpriteInstance &sprite, const Texture *texture,
+                   float layer);
+  void queueRect(const Rectangle &rectangle);
+  void queueCircle(const Circle &circle);
+
+  void reserveQuad();
+  void reserveInstance();
+  void reserveCircle();
+
+  void bindTextures(const std::vector<const Texture *> &textures);
+  void uploadProjection(const Shader &shader);
+
+  void submitSprite(const SpriteInstance &sprite, const Texture *texture);
+  void submitSpriteBatched(const SpriteInstance &sprite,
+                           const Texture *texture);
+  void submitSpriteInstanced(const SpriteInstance &sprite,
+                             const Texture *texture);
+  void submitRect(const Rectangle &rectangle);
+  void submitCircle(const Circle &circle);
+
+  void expandSprites();
+  void recordFlush(FlushReason reason, const char *batch, size_t items,
+                   size_t textures);
+  void flushQuad(FlushReason reason);
+  void flushInstances(FlushReason reason);
+  void flushCircle(FlushReason reason);
+  void flushQueue();
 
 public:
   Renderer2D(int windowWidth, int windowHeight, float scale);
@@ -85,11 +259,116 @@ public:
   void begin();
   void updateProjection(int windowWidth, int windowHeight);
   void drawSprite(const Sprite &sprite);
+
+  /**
+   * @brief Draws many sprites, culling them in bulk first.
+   *
+   * The bounds of all sprites are tested against the view with the SIMD
+   * culling kernels before any vertices are generated. The result is the
+   * same as calling drawSprite for each sprite in order.
+   *
+   * @param sprites The sprites to draw.
+   */
+  void drawSprites(std::span<const Sprite> sprites);
   void drawRect(const Rectangle &rectangle);
+
+  /**
+   * @brief Draws many rectangles, culling them in bulk first.
+   *
+   * Same result as calling drawRect for each rectangle in order. Once the
+   * renderer has warmed up, neither call allocates.
+   *
+   * @param rectangles The rectangles to draw.
+   */
+  void drawRects(std::span<const Rectangle> rectangles);
+
   void drawCircle(const Circle &circle);
+
+  /**
+   * @brief Draws many circles, culling them in bulk first.
+   *
+   * Same result as calling drawCircle for each circle in order. Once the
+   * renderer has warmed up, neither call allocates.
+   *
+   * @param circles The circles to draw.
+   */
+  void drawCircles(std::span<const Circle> circles);
+
+  /**
+   * @brief Draws a retained batch from its GPU buffers.
+   *
+   * Draws queued before this call are drawn first, so the batch lands on top
+   * of them. Only items changed since the batch was last drawn are uploaded,
+   * and the batch is not culled.
+   *
+   * @param batch The batch to draw.
+   */
+  void drawStaticBatch(StaticBatch &batch);
   void end();
   void shutdown();
+
+  /**
+   * @brief Turns the per-batch flush log on or off.
+   *
+   * The counters of getStats() are always kept; the log lists every batch of
+   * the frame with the reason it was drawn.
+   *
+   * @param debug Whether to keep the flush log.
+   */
   void setDebugMode(bool debug);
+  bool isDebugMode() const;
+  void setSpritePipeline(SpritePipeline pipeline);
+  SpritePipeline getSpritePipeline() const;
+
+  /**
+   * @brief Selects whether draws are batched immediately or queued.
+   *
+   * Queued draws are sorted and batched in end(). Sprites, rectangles and
+   * circles are copied at submission, so callers may change them right away.
+   *
+   * @param mode The sort mode.
+   */
+  void setSortMode(RenderSortMode mode);
+  RenderSortMode getSortMode() const;
+
+  /**
+   * @brief Enables or disables view culling.
+   *
+   * When enabled, draws whose bounds lie entirely outside the projection
+   * bounds are dropped before they reach the batches or the queue.
+   *
+   * @param enabled Whether to cull. Culling is enabled by default.
+   */
+  void setCulling(bool enabled);
+  bool isCullingEnabled() const;
+
+  /**
+   * @brief Gets the area covered by the projection, in world units.
+   *
+   * @return The view bounds draws are culled against.
+   */
+  const CullRect &getViewBounds() const;
+
+  /**
+   * @brief Gets the culling counts of the current frame.
+   *
+   * @return The counts since the last begin().
+   */
+  const CullStats &getCullStats() const;
+
+  /**
+   * @brief Gets the counters of the current frame.
+   *
+   * @return The counters since the last begin(); complete once end() ran.
+   */
+  const RenderStats &getStats() const;
+
+  /**
+   * @brief Gets the batches drawn in the current frame, in order.
+   *
+   * @return The log since the last begin(); empty unless debug mode is on.
+   */
+  const std::vector<FlushRecord> &getFlushLog() const;
 };
 
 #endif // RENDERER_2D_H
\ No newline at end of file
@@ -7,6 +7,9 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <string>
+#include <vector>
+
 #include <glad/gl.h>
 
 #include <jelly/io.h>
@@ -15,7 +18,7 @@
  * @brief Default vertex shader source code.
  */
 constexpr const char *quad_vertex_shader = R"(
-   #version 460 core
+   #version 450 core
     layout(location = 0) in vec2 a_pos;
     layout(location = 1) in vec2 a_uv;
     layout(location = 2) in vec4 a_color;
@@ -40,7 +43,7 @@ constexpr const char *quad_vertex_shader = R"(
  * @brief Default fragment shader source code.
  */
 constexpr const char *quad_fragment_shader = R"(
-    #version 460 core
+    #version 450 core
     out vec4 fragColor;
 
     in vec2 v_uv;
@@ -60,59 +63,182 @@ constexpr const char *quad_fragment_shader = R"(
 
 )";
 
-constexpr const char *circle_vertex_shader = R"(
-    #version 460 core
+/**
+ * @brief Vertex shader source code for PackedQuadVertex.
+ *
+ * Color and UVs arrive already normalized; the texture index is an integer
+ * attribute passed on flat.
+ */
+constexpr const char *packed_quad_vertex_shader = R"(
+    #version 450 core
+    layout(location = 0) in vec2 a_pos;
+    layout(location = 1) in vec2 a_uv;
+    layout(location = 2) in vec4 a_color;
+    layout(location = 3) in int a_texIndex;
+
+    out vec2 v_uv;
+    out vec4 v_color;
+    flat out int v_texIndex;
+
+    uniform mat4 projection;
+
+    void main() {
+        v_uv = a_uv;
+        v_color = a_color;
+        v_texIndex = a_texIndex;
+        gl_Position = projection * vec4(a_pos, 0.0, 1.0);
+    }
+
+)";
+
+/**
+ * @brief Fragment shader source code for PackedQuadVertex.
+ */
+constexpr const char *packed_quad_fragment_shader = R"(
+    #version 450 core
+    out vec4 fragColor;
+
+    in vec2 v_uv;
+    in vec4 v_color;
+    flat in int v_texIndex;
 
-    layout(location = 0) in vec2 a_pos;      // Position of the vertex
-    layout(location = 1) in vec2 a_uv;       // UV coordinates (not used here)
-    layout(location = 2) in vec4 a_color;    // Per-instance color
-    layout(location = 3) in vec2 a_center;   // Per-instance circle center
-    layout(location = 4) in float a_radius;  // Per-instance circle radius
+    uniform sampler2D textures[32]; // Support up to 32 texture slots
 
-    out vec2 fragUV;       // Pass normalized position
-    out vec4 fragColor;    // Pass color to fragment shader
-    out vec2 fragCenter;   // Pass transformed circle center
-    out float fragRadius;  // Pass radius to fragment shader
+    void main() {
+        if (v_texIndex < 0) { // Untextured
+            fragColor = v_color;
+        } else { // Textured
+            fragColor = texture(textures[v_texIndex], v_uv) * v_color;
+        }
+    }
+
+)";
+
+/**
+ * @brief Instanced sprite vertex shader source code.
+ *
+ * Expands one per-instance sprite record into a unit quad drawn as a
+ * four-vertex triangle strip. Pairs with quad_fragment_shader.
+ */
+constexpr const char *sprite_instance_vertex_shader = R"(
+    #version 450 core
+    layout(location = 0) in vec2 i_position;
+    layout(location = 1) in vec2 i_size;
+    layout(location = 2) in vec4 i_uvRect;
+    layout(location = 3) in vec4 i_color;
+    layout(location = 4) in float i_texIndex;
+    layout(location = 5) in float i_rotation;
+    layout(location = 6) in vec2 i_pivot;
+
+    out vec2 v_uv;
+    out vec4 v_color;
+    out float v_texIndex;
 
     uniform mat4 projection;
 
     void main() {
-        vec4 worldPos = projection * vec4(a_pos, 0.0, 1.0);
-        fragUV = a_pos;           // Object-space coordinates
-        fragColor = a_color;      // Circle color
-        fragCenter = (projection * vec4(a_center, 0.0, 1.0)).xy; // Transformed center
-        fragRadius = a_radius;    // Circle radius (unchanged)
+        vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+        vec2 local = (corner - i_pivot) * i_size;
+
+        float c = cos(i_rotation);
+        float s = sin(i_rotation);
+        vec2 world = i_position + vec2(c * local.x - s * local.y,
+                                       s * local.x + c * local.y);
+
+        v_uv = vec2(mix(i_uvRect.x, i_uvRect.z, corner.x),
+                    mix(i_uvRect.w, i_uvRect.y, corner.y));
+        v_color = i_color;
+        v_texIndex = i_texIndex;
+        gl_Position = projection * vec4(world, 0.0, 1.0);
+    }
+
+)";
+
+/**
+ * @brief Circle vertex shader source code.
+ *
+ * Expands one circle instance into a quad drawn as a four-vertex triangle
+ * strip, one unit larger than the circle to leave room for anti-aliasing.
+ */
+constexpr const char *circle_vertex_shader = R"(
+    #version 450 core
+    layout(location = 0) in vec2 i_center;
+    layout(location = 1) in float i_radius;
+    layout(location = 2) in float i_strokeWidth;
+    layout(location = 3) in vec4 i_color;
 
-        gl_Position = worldPos;
+    out vec2 v_local;
+    flat out float v_radius;
+    flat out float v_strokeWidth;
+    flat out vec4 v_color;
+
+    uniform mat4 projection;
+
+    void main() {
+        vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+        v_local = corner * (i_radius + 1.0);
+        v_radius = i_radius;
+        v_strokeWidth = i_strokeWidth;
+        v_color = i_color;
+        gl_Position = projection * vec4(i_center + v_local, 0.0, 1.0);
     }
 )";
 
+/**
+ * @brief Circle fragment shader source code.
+ *
+ * Evaluates the signed distance to the filled disc or to the outline ring
+ * and turns it into coverage over one pixel.
+ */
 constexpr const char *circle_fragment_shader = R"(
-    #version 460 core
-
-    in vec2 fragUV;       // Object-space UV coordinates
-    in vec4 fragColor;    // Circle color
-    in vec2 fragCenter;   // Transformed circle center
-    in float fragRadius;  // Circle radius
+    #version 450 core
+    in vec2 v_local;
+    flat in float v_radius;
+    flat in float v_strokeWidth;
+    flat in vec4 v_color;
 
-    out vec4 fragColorOut;  // Output color
+    out vec4 fragColor;
 
     void main() {
-        float dist = length(fragUV - fragCenter);  // Distance to the center
-        float alpha = smoothstep(fragRadius - 0.01, fragRadius, dist); // Anti-aliasing
-        if (dist > fragRadius) discard; // Outside the circle boundary
-        fragColorOut = vec4(fragColor.rgb, 1.0);
+        float dist = length(v_local);
+        float sdf = dist - v_radius;
+        if (v_strokeWidth > 0.0) { // Outline: also outside the inner edge
+            sdf = max(sdf, v_radius - v_strokeWidth - dist);
+        }
+
+        float pixel = max(fwidth(dist), 1e-4);
+        float coverage = clamp(0.5 - sdf / pixel, 0.0, 1.0);
+        if (coverage <= 0.0) {
+            discard;
+        }
+        fragColor = vec4(v_color.rgb, v_color.a * coverage);
     }
 )";
 
+/**
+ * @brief An active uniform of a linked shader program.
+ */
+struct ShaderUniform {
+  std::string name; ///< Name without a trailing "[0]" for arrays
+  GLint location;   ///< Location of the uniform or of its first element
+  GLint size;       ///< Number of array elements, 1 for non-arrays
+  GLenum type;      ///< Type of the uniform, such as GL_SAMPLER_2D
+};
+
 /**
  * @class Shader
  * @brief A class to manage OpenGL shaders.
+ *
+ * The locations of all active uniforms are read once after linking, so
+ * looking one up never calls into OpenGL. Sampler uniforms are given
+ * consecutive texture units at the same time, so a program whose only
+ * sampler is an array `textures[N]` reads from units 0 to N-1.
  */
 class Shader {
-  GLuint m_id; ///< Shader program ID
+  GLuint m_id;                           ///< Shader program ID
+  std::vector<ShaderUniform> m_uniforms; ///< Active uniforms after linking
 
-  void compileErrors(unsigned int shader, const char *type);
+  void loadUniforms();
 
 public:
   /**
@@ -126,7 +252,7 @@ public:
    * @brief Returns the ID of the shader program.
    * @return The ID of the shader program.
    */
-  GLuint GetID();
+  GLuint GetID() const;
 
   /**
    * @brief Compiles the shader program.
@@ -140,6 +266,20 @@ public:
    */
   void Activate() const;
 
+  /**
+   * @brief Gets the location of an active uniform from the table built at
+   * link time.
+   * @param name The uniform name; arrays are named without an index.
+   * @return The location, or -1 if the program has no such active uniform.
+   */
+  GLint getUniformLocation(const char *name) const;
+
+  /**
+   * @brief Gets the active uniforms of the linked program.
+   * @return The uniforms.
+   */
+  const std::vector<ShaderUniform> &getUniforms() const;
+
   /**
    * @brief Deletes the shader program.
    */
@@ -0,0 +1,37 @@
+/**
+ * @file simd.h
+ * @brief This file contains the runtime selection of SIMD kernels.
+ */
+#ifndef SIMD_H
+#define SIMD_H
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+/// Defined when the x86 SSE and AVX kernels are compiled in.
+#define JELLY_SIMD_X86
+#endif
+
+/**
+ * @brief The instruction sets a kernel can be built on.
+ */
+enum class SimdLevel {
+  Scalar, ///< Portable C++
+  SSE,    ///< Four lanes per iteration with SSE
+  AVX     ///< Eight lanes per iteration with AVX
+};
+
+/**
+ * @brief Checks whether the running CPU can execute kernels of a level.
+ *
+ * @param level The level to check.
+ * @return True if the level is available.
+ */
+bool isSimdLevelSupported(SimdLevel level);
+
+/**
+ * @brief Gets the widest level the running CPU supports.
+ *
+ * @return The level kernels run at when none is given.
+ */
+SimdLevel bestSimdLevel();
+
+#endif // SIMD_H
@@ -9,35 +9,75 @@
 #include <vector>
 
 #include <jelly/texture.h>
+#include <jelly/texture_atlas.h>
+#include <jelly/texture_cache.h>
 #include <jelly/vec.h>
 
 /**
  * @brief A class to encapsulate a sprite.
  */
 class Sprite {
-  float m_width;
-  float m_height;
+  float m_width;  ///< The requested width, or 0 to follow the texture
+  float m_height; ///< The requested height, or 0 to follow the texture
   Vec3<float> m_position = Vec3<float>(0.0f, 0.0f, 0.0f);
   Vec3<float> m_scale = Vec3<float>(1.0f, 1.0f, 1.0f);
   Vec3<float> m_rotation = Vec3<float>(0.0f, 0.0f, 0.0f);
+  Vec2<float> m_pivot = Vec2<float>(0.0f, 0.0f);
   Vec4<float> m_color = Vec4<float>(1.0f, 1.0f, 1.0f, 1.0f);
-  Texture m_texture;
+  TextureHandle m_texture;
+  const AtlasRegion *m_region = nullptr;
 
 public:
   /**
    * @brief Constructs a Sprite object.
    *
+   * Once the game context is initialized, the texture is loaded through its
+   * texture cache, so sprites with the same image share one texture. Before
+   * that the sprite loads a texture of its own, which needs a current OpenGL
+   * context and is freed with the last copy of the sprite.
+   *
    * @param texturePath The file path to the texture image.
+   * @param color The color to tint the sprite with.
    * @param width The width of the sprite.
    * @param height The height of the sprite.
    */
   Sprite(const char *texturePath,
          Vec4<float> color = Vec4<float>(1.0f, 1.0f, 1.0f, 1.0f), int width = 0,
          int height = 0);
-  ~Sprite();
 
   /**
-   * @brief Sets the position, scale, and rotation of the sprite.
+   * @brief Constructs a Sprite object from a cached texture.
+   *
+   * With a width or height of 0 the sprite follows the size of the texture,
+   * including when an asynchronously loaded texture replaces its placeholder.
+   *
+   * @param texture A handle to the texture.
+   * @param color The color to tint the sprite with.
+   * @param width The width of the sprite, or 0 for the width of the texture.
+   * @param height The height of the sprite, or 0 for the height of the texture.
+   */
+  Sprite(TextureHandle texture,
+         Vec4<float> color = Vec4<float>(1.0f, 1.0f, 1.0f, 1.0f), int width = 0,
+         int height = 0);
+
+  /**
+   * @brief Constructs a Sprite object that draws a region of a texture atlas.
+   *
+   * The region must outlive the sprite.
+   *
+   * @param region The atlas region to draw.
+   * @param color The color to tint the sprite with.
+   * @param width The width of the sprite, or 0 for the width of the region.
+   * @param height The height of the sprite, or 0 for the height of the region.
+   */
+  Sprite(const AtlasRegion &region,
+         Vec4<float> color = Vec4<float>(1.0f, 1.0f, 1.0f, 1.0f), int width = 0,
+         int height = 0);
+
+  /**
+   * @brief Sets the position of the sprite.
+   *
+   * The position is where the pivot of the sprite is drawn.
    *
    * @param position The position of the sprite.
    */
@@ -53,10 +93,23 @@ public:
   /**
    * @brief Sets the rotation of the sprite.
    *
+   * Sprites are drawn in 2D, so only the z component is used: the rotation
+   * about the pivot, in radians.
+   *
    * @param rotation The rotation of the sprite.
    */
   void setRotation(const Vec3<float> &rotation);
 
+  /**
+   * @brief Sets the point the sprite is positioned, scaled and rotated about.
+   *
+   * The pivot is a fraction of the sprite size: (0, 0), the default, is the
+   * top-left corner and (0.5, 0.5) the center.
+   *
+   * @param pivot The pivot of the sprite.
+   */
+  void setPivot(const Vec2<float> &pivot);
+
   /**
    * @brief Gets the position of the sprite.
    *
@@ -78,6 +131,13 @@ public:
    */
   const Vec3<float> &getRotation() const;
 
+  /**
+   * @brief Gets the pivot of the sprite.
+   *
+   * @return The pivot as a fraction of the sprite size.
+   */
+  const Vec2<float> &getPivot() const;
+
   /**
    * @brief Gets the width of the sprite.
    *
@@ -99,13 +159,29 @@ public:
    */
   Vec2<float> getSize() const;
 
+  /**
+   * @brief Gets the size of the sprite with its scale applied.
+   *
+   * @return The drawn size of the sprite.
+   */
+  Vec2<float> getScaledSize() const;
+
   /**
    * @brief Gets the texture of the sprite.
    *
+   * For atlas sprites this is the page holding the region.
+   *
    * @return A reference to the texture.
    */
   const Texture &getTexture() const;
 
+  /**
+   * @brief Gets the part of the texture the sprite draws.
+   *
+   * @return The texture coordinates as (u0, v0, u1, v1).
+   */
+  Vec4<float> getUVRect() const;
+
   /**
    * @brief Gets the color of the sprite.
    *
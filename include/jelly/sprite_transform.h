@@ -0,0 +1,71 @@
+/**
+ * @file sprite_transform.h
+ * @brief This file contains the kernels that expand sprites into quads.
+ */
+#ifndef SPRITE_TRANSFORM_H
+#define SPRITE_TRANSFORM_H
+
+#include <cstddef>
+#include <vector>
+
+#include <jelly/simd.h>
+#include <jelly/vec.h>
+
+/**
+ * @brief 2D sprite transforms stored as one array per component.
+ *
+ * Each sprite is a rectangle placed so that its pivot lands on its position,
+ * then rotated about the pivot. The structure-of-arrays layout lets the
+ * kernels transform four or eight sprites per instruction.
+ */
+struct SpriteTransformSoA {
+  std::vector<float> x;       ///< World position of the pivot
+  std::vector<float> y;       ///< World position of the pivot
+  std::vector<float> offsetX; ///< Unrotated offset of the first corner
+  std::vector<float> offsetY; ///< Unrotated offset of the first corner
+  std::vector<float> width;   ///< Scaled width
+  std::vector<float> height;  ///< Scaled height
+  std::vector<float> sin;     ///< Sine of the rotation
+  std::vector<float> cos;     ///< Cosine of the rotation
+
+  /**
+   * @brief Appends a sprite transform.
+   *
+   * @param position The world position of the pivot.
+   * @param size The scaled size of the sprite.
+   * @param pivot The pivot as a fraction of the size; (0, 0) is the first
+   * corner and (0.5, 0.5) the center.
+   * @param rotation The rotation about the pivot, in radians.
+   */
+  void push(const Vec2<float> &position, const Vec2<float> &size,
+            const Vec2<float> &pivot, float rotation);
+
+  /**
+   * @brief Removes all transforms, keeping the allocated memory.
+   */
+  void clear();
+
+  /**
+   * @brief Gets the number of transforms.
+   *
+   * @return The transform count.
+   */
+  size_t size() const { return x.size(); }
+};
+
+/**
+ * @brief Computes the corners of transformed sprites.
+ *
+ * Corners are written in quad vertex order: first corner, then along the
+ * width, then the opposite corner, then along the height. Each sprite takes
+ * eight floats, (x, y) for each of its four corners.
+ *
+ * @param transforms The sprites to transform.
+ * @param corners Receives 8 * transforms.size() floats.
+ * @param level The kernel to run. Unsupported levels fall back to the
+ * scalar kernel.
+ */
+void transformQuads(const SpriteTransformSoA &transforms, float *corners,
+                    SimdLevel level = bestSimdLevel());
+
+#endif // SPRITE_TRANSFORM_H
@@ -0,0 +1,79 @@
+/**
+ * @file spsc_queue.h
+ * @brief This file contains a fixed-size lock-free queue for one producer
+ * and one consumer thread.
+ */
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class SpscQueue
+ * @brief A ring of Capacity items that one thread pushes to and one thread
+ * pops from without locking.
+ *
+ * Pushing to a full queue fails instead of overwriting items the consumer
+ * may be reading, so the producer decides what to do with the overflow.
+ *
+ * @tparam T The item type, copied in and out.
+ * @tparam Capacity The number of items, a power of two.
+ */
+template <typename T, size_t Capacity> class SpscQueue {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "SpscQueue capacity must be a power of two");
+
+  std::array<T, Capacity> m_items{};
+  // The indices sit on separate cache lines so the producer and the consumer
+  // do not invalidate each other's line on every item.
+  alignas(64) std::atomic<size_t> m_head{0}; ///< Next slot to write
+  alignas(64) std::atomic<size_t> m_tail{0}; ///< Next slot to read
+
+public:
+  /**
+   * @brief Appends an item. Called by the producer only.
+   *
+   * @param item The item.
+   * @return False if the queue was full and the item was not added.
+   */
+  bool push(const T &item) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+      return false;
+
+    m_items[head & (Capacity - 1)] = item;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Removes the oldest item. Called by the consumer only.
+   *
+   * @param item Receives the item.
+   * @return False if the queue was empty.
+   */
+  bool pop(T &item) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire))
+      return false;
+
+    item = m_items[tail & (Capacity - 1)];
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Gets the number of queued items. Exact only on the consumer
+   * thread while the producer is idle.
+   *
+   * @return The count.
+   */
+  size_t size() const {
+    return m_head.load(std::memory_order_acquire) -
+           m_tail.load(std::memory_order_acquire);
+  }
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,197 @@
+/**
+ * @file static_batch.h
+ * @brief This file contains the StaticBatch class, a retained layer of quads
+ * kept on the GPU.
+ */
+#ifndef STATIC_BATCH_H
+#define STATIC_BATCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include <jelly/ebo.h>
+#include <jelly/rectangle.h>
+#include <jelly/sprite.h>
+#include <jelly/sprite_transform.h>
+#include <jelly/vao.h>
+#include <jelly/vbo.h>
+#include <jelly/vertex_format.h>
+
+/**
+ * @brief Identifies an item recorded into a StaticBatch.
+ */
+using StaticItem = uint32_t;
+
+/**
+ * @brief Returned by StaticBatch when an item could not be recorded.
+ */
+const StaticItem INVALID_STATIC_ITEM = UINT32_MAX;
+
+/**
+ * @brief Upload counters of a StaticBatch.
+ */
+struct StaticBatchStats {
+  size_t uploads;       ///< Buffer uploads since the batch was created
+  size_t bytesUploaded; ///< Bytes uploaded since the batch was created
+};
+
+/**
+ * @brief What one StaticBatch::draw issued.
+ */
+struct StaticBatchDraw {
+  size_t drawCalls; ///< Draw calls, at most one filled and one outline
+  size_t indices;   ///< Indices drawn
+};
+
+/**
+ * @class StaticBatch
+ * @brief Sprites and rectangles recorded once and redrawn from GPU memory.
+ *
+ * Items are converted to vertices when they are added or updated, and only
+ * the vertices that changed since the last draw are uploaded. Drawing an
+ * unchanged batch with Renderer2D::drawStaticBatch costs one draw call for
+ * its filled items plus one for its outlines, and no vertex work on the CPU.
+ *
+ * Sprites are captured when recorded: later changes to a Sprite object only
+ * reach the batch through update(). Their textures must outlive the items
+ * drawing them. A batch holds at most MAX_TEXTURE_SLOTS distinct textures
+ * at a time; a texture's slot is freed once no item draws with it.
+ */
+class StaticBatch {
+  struct Slot {
+    bool live;
+    bool filled;
+    int texture; ///< Index into m_textures, or -1 for rectangles
+  };
+
+  std::vector<BatchQuadVertex> m_vertices; ///< Four vertices per slot
+  std::vector<Slot> m_slots;
+  std::vector<StaticItem> m_freeSlots;
+  std::vector<const Texture *> m_textures;
+  std::vector<size_t> m_textureRefs; ///< Items drawing with each texture
+  size_t m_itemCount;
+
+  // Slots whose vertices changed since the last upload, as [begin, end).
+  size_t m_dirtyBegin;
+  size_t m_dirtyEnd;
+  bool m_indicesDirty;
+
+  std::vector<GLuint> m_indices;
+  size_t m_triangleIndexCount;
+  size_t m_loopIndexCount;
+
+  VAO m_vao;
+  VBO m_vbo;
+  EBO m_ebo;
+  size_t m_gpuSlotCapacity;
+  size_t m_gpuIndexCapacity;
+
+  SpriteTransformSoA m_transform;
+  StaticBatchStats m_stats;
+
+  StaticItem allocateSlot(bool filled);
+  void markDirty(StaticItem item);
+  int acquireTexture(const Texture *texture);
+  void releaseTexture(int index);
+  bool writeSprite(StaticItem item, const Sprite &sprite);
+  void buildIndices();
+  void upload();
+
+public:
+  StaticBatch();
+
+  StaticBatch(const StaticBatch &) = delete;
+  StaticBatch &operator=(const StaticBatch &) = delete;
+
+  /**
+   * @brief Records a sprite.
+   *
+   * @param sprite The sprite to record.
+   * @return The item, or INVALID_STATIC_ITEM if live items already use
+   * MAX_TEXTURE_SLOTS other textures.
+   */
+  StaticItem add(const Sprite &sprite);
+
+  /**
+   * @brief Records a rectangle.
+   *
+   * @param rectangle The rectangle to record.
+   * @return The item.
+   */
+  StaticItem add(const Rectangle &rectangle);
+
+  /**
+   * @brief Replaces a recorded item with a sprite.
+   *
+   * Only the vertices of the item are uploaded again. If the texture does
+   * not fit, the item is left as it was.
+   *
+   * @param item The item to replace.
+   * @param sprite The new sprite.
+   * @return False if the item is not live or the texture does not fit.
+   */
+  bool update(StaticItem item, const Sprite &sprite);
+
+  /**
+   * @brief Replaces a recorded item with a rectangle.
+   *
+   * @param item The item to replace.
+   * @param rectangle The new rectangle.
+   * @return False if the item is not live.
+   */
+  bool update(StaticItem item, const Rectangle &rectangle);
+
+  /**
+   * @brief Removes an item. Its id may be reused by a later add.
+   *
+   * @param item The item to remove.
+   */
+  void remove(StaticItem item);
+
+  /**
+   * @brief Removes all items and textures, keeping the GPU buffers.
+   */
+  void clear();
+
+  /**
+   * @brief Frees the GPU buffers. Requires the OpenGL context.
+   */
+  void Delete();
+
+  /**
+   * @brief Gets the number of live items.
+   *
+   * @return The item count.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Gets the textures the items draw with.
+   *
+   * @return The textures, in slot order. Slots no item uses any more are
+   * nullptr until a new texture takes them.
+   */
+  const std::vector<const Texture *> &getTextures() const;
+
+  /**
+   * @brief Gets the upload counters.
+   *
+   * @return The counters.
+   */
+  const StaticBatchStats &getStats() const;
+
+  /**
+   * @brief Uploads pending changes and draws the items with the program and
+   * textures that are bound.
+   *
+   * Renderer2D::drawStaticBatch binds those and flushes the dynamic batches
+   * first; draw through it rather than calling this directly.
+   *
+   * @return The draw calls and indices issued.
+   */
+  StaticBatchDraw draw();
+};
+
+#endif // STATIC_BATCH_H
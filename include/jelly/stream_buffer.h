@@ -0,0 +1,116 @@
+/**
+ * @file stream_buffer.h
+ * @brief This file contains the definition of the StreamBuffer class.
+ */
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <vector>
+
+#include <glad/gl.h>
+
+/**
+ * @brief Default number of fenced regions in a streaming buffer.
+ */
+const GLuint STREAM_REGION_COUNT = 3;
+
+/**
+ * @class StreamBuffer
+ * @brief A persistently mapped GPU buffer split into fenced frame regions.
+ *
+ * The storage is allocated once with glBufferStorage and stays mapped with
+ * GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT, so data written through the
+ * mapped pointer is visible to the GPU without any upload call. The buffer is
+ * split into regions used as a ring: when a region is left, a fence is
+ * inserted, and a region is only written again once its fence has signaled.
+ *
+ * If the driver cannot map the storage, writes go to a staging copy in
+ * system memory instead and Commit() uploads them with glBufferSubData.
+ */
+class StreamBuffer {
+  GLenum m_target;                      ///< The binding target of the buffer.
+  GLuint m_id;                          ///< The ID of the buffer.
+  unsigned char *m_data;                ///< The mapped or staging storage.
+  GLsizeiptr m_regionSize;              ///< The size of one region in bytes.
+  GLuint m_regionCount;                 ///< The number of regions in the ring.
+  GLuint m_region;                      ///< The region currently written to.
+  GLsizeiptr m_head;                    ///< The write offset in the region.
+  std::vector<GLsync> m_fences;         ///< One fence per region, or null.
+  std::vector<unsigned char> m_staging; ///< Written to when not mapped.
+
+  void waitRegion(GLuint region);
+
+public:
+  /**
+   * @brief Constructs an empty, unmapped StreamBuffer.
+   */
+  StreamBuffer();
+
+  /**
+   * @brief Allocates immutable storage for a buffer and maps it.
+   *
+   * @param target The binding target of the buffer.
+   * @param id The ID of a generated buffer without storage.
+   * @param regionSize The size of one region in bytes.
+   * @param regionCount The number of regions in the ring.
+   * @return False if the storage could not be mapped and writes are staged
+   * and uploaded instead.
+   */
+  bool Init(GLenum target, GLuint id, GLsizeiptr regionSize,
+            GLuint regionCount);
+
+  /**
+   * @brief Returns a write pointer with at least the given space behind it.
+   *
+   * Moves to the next region when the current one cannot fit the request.
+   *
+   * @param size The number of bytes that must be writable.
+   * @return A pointer into mapped or staging memory, or nullptr if the
+   * request is larger than a region.
+   */
+  void *Reserve(GLsizeiptr size);
+
+  /**
+   * @brief Marks bytes written at the current write pointer as used, and
+   * uploads them when the buffer is not mapped.
+   *
+   * @param size The number of bytes written.
+   */
+  void Commit(GLsizeiptr size);
+
+  /**
+   * @brief Fences the current region and moves to the next one.
+   *
+   * Blocks only if the GPU is still reading the next region. Does nothing
+   * when the current region has not been written to.
+   */
+  void NextRegion();
+
+  /**
+   * @brief Unmaps the buffer and releases all fences.
+   */
+  void Delete();
+
+  /**
+   * @brief Gets the number of bytes left in the current region.
+   *
+   * @return The number of free bytes.
+   */
+  GLsizeiptr getAvailable() const;
+
+  /**
+   * @brief Gets the offset of the write pointer from the buffer start.
+   *
+   * @return The offset in bytes.
+   */
+  GLintptr getOffset() const;
+
+  /**
+   * @brief Checks whether the buffer storage is mapped.
+   *
+   * @return True if the buffer is mapped.
+   */
+  bool isMapped() const;
+};
+
+#endif // STREAM_BUFFER_H
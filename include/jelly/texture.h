@@ -26,6 +26,11 @@ class Texture {
   int m_height;
 
 public:
+  /**
+   * @brief Constructs an empty Texture object without an OpenGL texture.
+   */
+  Texture();
+
   /**
    * @brief Constructs a Texture object and loads a texture from a file.
    *
@@ -39,14 +44,51 @@ public:
           GLenum slot = GL_TEXTURE0, GLenum format = GL_RGBA,
           GLenum pixelType = GL_UNSIGNED_BYTE);
 
+  /**
+   * @brief Constructs an empty RGBA8 texture without mipmaps.
+   *
+   * The contents are undefined until written with SetSubImage.
+   *
+   * @param width The width of the texture.
+   * @param height The height of the texture.
+   * @param type The type of the texture (default is GL_TEXTURE_2D).
+   * @param slot The texture slot to bind the texture to.
+   */
+  Texture(int width, int height, GLenum texType = GL_TEXTURE_2D,
+          GLenum slot = GL_TEXTURE0);
+
+  /**
+   * @brief Writes pixels into a rectangle of the texture.
+   *
+   * @param x The left edge of the rectangle.
+   * @param y The bottom edge of the rectangle.
+   * @param width The width of the rectangle.
+   * @param height The height of the rectangle.
+   * @param data The pixel data, tightly packed.
+   * @param format The format of the pixel data.
+   * @param pixelType The data type of the pixel data.
+   */
+  void SetSubImage(int x, int y, int width, int height, const void *data,
+                   GLenum format = GL_RGBA,
+                   GLenum pixelType = GL_UNSIGNED_BYTE) const;
+
+  /**
+   * @brief Builds the mipmap chain from the base level and samples it.
+   */
+  void GenerateMipmaps() const;
+
   /**
    * @brief Sets the texture unit for a shader.
    *
+   * Samplers are already given texture units when the shader is linked, so
+   * this is only needed to point a sampler at a different unit.
+   *
    * @param shader The shader to set the texture unit for.
    * @param uniform The name of the uniform variable in the shader.
    * @param unit The texture unit to set.
    */
-  const void texUnit(Shader shader, const char *uniform, GLuint unit) const;
+  const void texUnit(const Shader &shader, const char *uniform,
+                     GLuint unit) const;
 
   /**
    * @brief Binds the texture.
@@ -55,6 +97,13 @@ public:
    */
   void Bind() const;
 
+  /**
+   * @brief Binds the texture to a texture unit.
+   *
+   * @param unit The texture unit index, starting at 0.
+   */
+  void Bind(GLuint unit) const;
+
   /**
    * @brief Unbinds the texture.
    *
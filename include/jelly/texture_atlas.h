@@ -0,0 +1,223 @@
+/**
+ * @file texture_atlas.h
+ * @brief This file contains the TextureAtlas class and its skyline packer.
+ */
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <memory>
+#include <vector>
+
+#include <jelly/texture.h>
+#include <jelly/vec.h>
+
+/**
+ * @brief Default width and height of an atlas page in texels.
+ */
+const int ATLAS_PAGE_SIZE = 2048;
+
+/**
+ * @brief A rectangle in texels, with its origin at the bottom left.
+ */
+struct AtlasRect {
+  int x;
+  int y;
+  int width;
+  int height;
+};
+
+/**
+ * @class SkylinePacker
+ * @brief Packs rectangles into a fixed-size area with the skyline
+ * bottom-left heuristic.
+ *
+ * The packer tracks the top edge of the placed rectangles as a list of
+ * horizontal segments and puts each new rectangle where its top ends lowest.
+ */
+class SkylinePacker {
+  struct Segment {
+    int x;
+    int y;
+    int width;
+  };
+
+  int m_width;
+  int m_height;
+  size_t m_usedArea;
+  std::vector<Segment> m_skyline;
+
+  bool fits(size_t index, int width, int height, int &y) const;
+  void place(size_t index, const AtlasRect &rect);
+
+public:
+  /**
+   * @brief Constructs a packer for an empty area.
+   *
+   * @param width The width of the area.
+   * @param height The height of the area.
+   */
+  SkylinePacker(int width, int height);
+
+  /**
+   * @brief Finds room for a rectangle and reserves it.
+   *
+   * @param width The width of the rectangle.
+   * @param height The height of the rectangle.
+   * @param rect Receives the placed rectangle.
+   * @return True if the rectangle fit.
+   */
+  bool pack(int width, int height, AtlasRect &rect);
+
+  /**
+   * @brief Empties the area.
+   */
+  void reset();
+
+  /**
+   * @brief Gets the fraction of the area covered by packed rectangles.
+   *
+   * @return The occupancy between 0 and 1.
+   */
+  float getOccupancy() const;
+
+  /**
+   * @brief Gets the number of texels covered by packed rectangles.
+   *
+   * @return The used area.
+   */
+  size_t getUsedArea() const;
+};
+
+/**
+ * @brief A sub-image of an atlas page.
+ *
+ * Regions are owned by their atlas and keep their address for its lifetime,
+ * so sprites can hold a pointer and see the new place after a repack.
+ */
+struct AtlasRegion {
+  const Texture *page; ///< The page texture holding the image
+  size_t pageIndex;    ///< The index of the page in the atlas
+  AtlasRect rect;      ///< The texels of the image on the page
+  Vec4<float> uvRect;  ///< The image as (u0, v0, u1, v1) on the page
+  bool live;           ///< False once the region has been removed
+};
+
+/**
+ * @brief Counters describing how well an atlas is packed.
+ */
+struct AtlasStats {
+  size_t pageCount;     ///< Number of allocated pages
+  size_t regionCount;   ///< Number of live regions
+  size_t usedArea;      ///< Texels covered by live regions
+  size_t wastedArea;    ///< Texels of removed regions not yet reclaimed
+  size_t evictions;     ///< Number of regions removed
+  size_t repacks;       ///< Number of times the atlas was repacked
+  size_t failedInserts; ///< Number of images that did not fit
+  float occupancy;      ///< Used area over the area of all pages
+};
+
+/**
+ * @class TextureAtlas
+ * @brief Packs many small RGBA8 images into a few large page textures.
+ *
+ * Sprites built from atlas regions share page textures, so thousands of
+ * distinct images fit in the texture slots of a single batch.
+ */
+class TextureAtlas {
+  struct Page {
+    std::unique_ptr<Texture> texture;
+    SkylinePacker packer;
+  };
+
+  int m_pageSize;
+  int m_padding;
+  size_t m_maxPages;
+  std::vector<Page> m_pages;
+  std::vector<std::unique_ptr<AtlasRegion>> m_regions;
+  AtlasStats m_stats;
+
+  bool allocate(int width, int height, size_t &pageIndex, AtlasRect &rect);
+  void updateRegion(AtlasRegion &region, size_t pageIndex,
+                    const AtlasRect &rect);
+
+public:
+  /**
+   * @brief Constructs an empty atlas.
+   *
+   * @param pageSize The width and height of each page in texels.
+   * @param maxPages The number of pages after which inserts repack or fail.
+   * @param padding The gap left around each image in texels.
+   */
+  TextureAtlas(int pageSize = ATLAS_PAGE_SIZE, size_t maxPages = 4,
+               int padding = 1);
+  ~TextureAtlas();
+
+  TextureAtlas(const TextureAtlas &) = delete;
+  TextureAtlas &operator=(const TextureAtlas &) = delete;
+
+  /**
+   * @brief Loads an image with load_image and packs it.
+   *
+   * @param path The file path to the image.
+   * @return The region of the image, or nullptr if loading or packing failed.
+   */
+  const AtlasRegion *add(const char *path);
+
+  /**
+   * @brief Packs tightly packed RGBA8 pixels.
+   *
+   * When every page is full and removed regions left gaps, the atlas is
+   * repacked before giving up.
+   *
+   * @param pixels The pixel data, bottom row first.
+   * @param width The width of the image.
+   * @param height The height of the image.
+   * @return The region of the image, or nullptr if it did not fit.
+   */
+  const AtlasRegion *add(const unsigned char *pixels, int width, int height);
+
+  /**
+   * @brief Evicts a region.
+   *
+   * The texels are only reclaimed by the next repack, after which the region
+   * pointer is no longer valid.
+   *
+   * @param region The region to remove.
+   */
+  void remove(const AtlasRegion *region);
+
+  /**
+   * @brief Packs all live regions again, tallest first, into as few pages as
+   * possible.
+   *
+   * The new layout is planned before any texel moves. If it does not fit the
+   * current pages, the atlas keeps its old layout and nothing is reclaimed.
+   *
+   * @return True if the atlas was repacked.
+   */
+  bool repack();
+
+  /**
+   * @brief Gets the packing statistics.
+   *
+   * @return The current statistics.
+   */
+  const AtlasStats &getStats() const;
+
+  /**
+   * @brief Gets the number of allocated pages.
+   *
+   * @return The page count.
+   */
+  size_t getPageCount() const;
+
+  /**
+   * @brief Gets the texture of a page.
+   *
+   * @param index The index of the page.
+   * @return The page texture.
+   */
+  const Texture &getPage(size_t index) const;
+};
+
+#endif // TEXTURE_ATLAS_H
@@ -0,0 +1,208 @@
+/**
+ * @file texture_cache.h
+ * @brief This file contains the TextureCache class and its texture handles.
+ */
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <string>
+#include <unordered_map>
+
+#include <jelly/texture.h>
+
+class TextureCache;
+class TextureLoader;
+
+/**
+ * @brief The loading state of a cached texture.
+ */
+enum class TextureState {
+  Loading, ///< Still decoding or uploading, the placeholder is bound
+  Ready,   ///< The image is uploaded
+  Failed,  ///< The image could not be loaded, the placeholder stays bound
+};
+
+/**
+ * @brief A cached texture shared by all handles loaded with the same key.
+ *
+ * Entries are reference counted by their handles. The cache only keeps a
+ * weak pointer, so the texture is freed as soon as the last handle goes away.
+ */
+struct TextureEntry {
+  Texture texture;     ///< The loaded texture
+  std::string key;     ///< The cache key the texture was loaded under
+  size_t bytes;        ///< Estimated video memory used by the texture
+  size_t refCount;     ///< Number of handles pointing at the entry
+  TextureCache *cache; ///< The owning cache, or nullptr if none or shut down
+  TextureState state;  ///< Whether texture holds the image yet
+};
+
+/**
+ * @class TextureHandle
+ * @brief A reference-counted pointer to a cached texture.
+ *
+ * Copying a handle is as cheap as copying a pointer and never touches the
+ * file system or the GPU.
+ */
+class TextureHandle {
+  TextureEntry *m_entry;
+
+  friend class TextureLoader;
+
+  void release();
+
+public:
+  /**
+   * @brief Constructs an empty handle.
+   */
+  TextureHandle();
+
+  /**
+   * @brief Constructs a handle that takes a reference on a cache entry.
+   *
+   * @param entry The entry to reference.
+   */
+  explicit TextureHandle(TextureEntry *entry);
+
+  TextureHandle(const TextureHandle &other);
+  TextureHandle(TextureHandle &&other) noexcept;
+  TextureHandle &operator=(TextureHandle other) noexcept;
+  ~TextureHandle();
+
+  /**
+   * @brief Gets the texture the handle points at.
+   *
+   * @return A reference to the texture.
+   */
+  const Texture &get() const;
+
+  const Texture &operator*() const;
+  const Texture *operator->() const;
+
+  /**
+   * @brief Checks whether the handle points at a texture.
+   *
+   * @return True if the handle is not empty.
+   */
+  explicit operator bool() const;
+
+  /**
+   * @brief Checks whether the image has been uploaded.
+   *
+   * Until then the handle points at the loader's placeholder texture.
+   *
+   * @return True once the texture is ready.
+   */
+  bool isReady() const;
+
+  /**
+   * @brief Gets the loading state of the texture.
+   *
+   * @return The state, or TextureState::Failed for an empty handle.
+   */
+  TextureState getState() const;
+
+  /**
+   * @brief Gets the number of handles sharing the texture.
+   *
+   * @return The reference count, or 0 for an empty handle.
+   */
+  size_t getRefCount() const;
+};
+
+/**
+ * @brief Counters describing how well the texture cache is doing.
+ */
+struct TextureCacheStats {
+  size_t hits;         ///< Loads served from the cache
+  size_t misses;       ///< Loads that decoded an image
+  size_t evictions;    ///< Textures freed after their last handle went away
+  size_t textureCount; ///< Textures currently loaded
+  size_t memoryBytes;  ///< Estimated video memory of the loaded textures
+};
+
+/**
+ * @class TextureCache
+ * @brief Loads each texture once and shares it between all its users.
+ *
+ * Textures are keyed by their canonical path and load parameters, so
+ * "./textures/a.png" and "textures/a.png" resolve to the same texture.
+ */
+class TextureCache {
+  std::unordered_map<std::string, TextureEntry *> m_entries;
+  TextureCacheStats m_stats;
+
+  friend class TextureHandle;
+  friend class TextureLoader;
+  void release(TextureEntry *entry);
+  void finishLoad(TextureEntry *entry, const Texture &texture, size_t bytes);
+
+public:
+  TextureCache();
+  ~TextureCache();
+
+  TextureCache(const TextureCache &) = delete;
+  TextureCache &operator=(const TextureCache &) = delete;
+
+  /**
+   * @brief Gets a texture, loading it on the first request.
+   *
+   * @param path The file path to the texture image.
+   * @param texType The type of the texture.
+   * @param format The format of the texture image.
+   * @param pixelType The data type of the pixel data.
+   * @return A handle to the shared texture, in TextureState::Failed if the
+   * image could not be loaded.
+   */
+  TextureHandle load(const char *path, GLenum texType = GL_TEXTURE_2D,
+                     GLenum format = GL_RGBA,
+                     GLenum pixelType = GL_UNSIGNED_BYTE);
+
+  /**
+   * @brief Gets a texture, queueing it on a loader on the first request.
+   *
+   * The handle points at the loader's placeholder until the loader has
+   * decoded and uploaded the image. Images are always loaded as RGBA.
+   *
+   * @param path The file path to the texture image.
+   * @param loader The loader that decodes and uploads the image.
+   * @return A handle to the shared texture.
+   */
+  TextureHandle loadAsync(const char *path, TextureLoader &loader);
+
+  /**
+   * @brief Loads a texture that no cache shares.
+   *
+   * The handle owns the texture and frees it with its last reference, while
+   * the OpenGL context must still be current.
+   *
+   * @param path The file path to the texture image.
+   * @param texType The type of the texture.
+   * @param format The format of the texture image.
+   * @param pixelType The data type of the pixel data.
+   * @return A handle to the texture, in TextureState::Failed if the image
+   * could not be loaded.
+   */
+  static TextureHandle loadUncached(const char *path,
+                                    GLenum texType = GL_TEXTURE_2D,
+                                    GLenum format = GL_RGBA,
+                                    GLenum pixelType = GL_UNSIGNED_BYTE);
+
+  /**
+   * @brief Frees every texture.
+   *
+   * Outstanding handles stay valid to destroy, report TextureState::Failed
+   * and must no longer be drawn.
+   * Call this while the OpenGL context is still current.
+   */
+  void clear();
+
+  /**
+   * @brief Gets the cache statistics.
+   *
+   * @return The current statistics.
+   */
+  const TextureCacheStats &getStats() const;
+};
+
+#endif // TEXTURE_CACHE_H
@@ -0,0 +1,146 @@
+/**
+ * @file texture_loader.h
+ * @brief This file contains the TextureLoader class for background texture
+ * loading.
+ */
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <jelly/stream_buffer.h>
+#include <jelly/texture.h>
+#include <jelly/texture_cache.h>
+
+/**
+ * @brief Default number of bytes uploaded per call to TextureLoader::update.
+ */
+const size_t TEXTURE_UPLOAD_BUDGET = 4 * 1024 * 1024;
+
+/**
+ * @brief Counters describing the work done by a texture loader.
+ */
+struct TextureLoaderStats {
+  size_t queued;        ///< Images waiting for or being decoded
+  size_t uploading;     ///< Decoded images waiting for or being uploaded
+  size_t completed;     ///< Images uploaded
+  size_t failed;        ///< Images that could not be decoded
+  size_t bytesUploaded; ///< Pixel bytes copied to the GPU
+};
+
+/**
+ * @class TextureLoader
+ * @brief Decodes images on worker threads and uploads them in bounded slices.
+ *
+ * Decoding runs on a pool of threads. The uploads stay on the render thread:
+ * each update() copies at most the upload budget of decoded rows into a
+ * persistently mapped pixel buffer and streams them into their textures with
+ * glTexSubImage2D. A large image therefore lands over several frames instead
+ * of stalling one.
+ */
+class TextureLoader {
+  struct LoadJob {
+    TextureHandle handle;
+    std::string path;
+    unsigned char *pixels;
+    int width;
+    int height;
+    int rowsUploaded;
+    Texture texture;
+  };
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  std::deque<std::unique_ptr<LoadJob>> m_pending; // Guarded by m_mutex
+  std::deque<std::unique_ptr<LoadJob>> m_decoded; // Guarded by m_mutex
+  size_t m_decoding; // Jobs taken by workers; guarded by m_mutex
+  bool m_stopping;   // Guarded by m_mutex
+
+  std::deque<std::unique_ptr<LoadJob>> m_uploading;
+  GLuint m_pbo;
+  StreamBuffer m_staging;
+  size_t m_uploadBudget;
+  Texture m_placeholder;
+  TextureLoaderStats m_stats;
+
+  void workerLoop();
+  void finish(LoadJob &job);
+
+public:
+  /**
+   * @brief Constructs a loader with no threads or GPU resources.
+   */
+  TextureLoader();
+  ~TextureLoader();
+
+  TextureLoader(const TextureLoader &) = delete;
+  TextureLoader &operator=(const TextureLoader &) = delete;
+
+  /**
+   * @brief Starts the decode threads and creates the staging buffer.
+   *
+   * Must be called with the OpenGL context current.
+   *
+   * @param threadCount The number of decode threads, or 0 for one less than
+   * the number of hardware threads.
+   * @param uploadBudget The number of bytes uploaded per update.
+   */
+  void init(size_t threadCount = 0,
+            size_t uploadBudget = TEXTURE_UPLOAD_BUDGET);
+
+  /**
+   * @brief Stops the decode threads and drops all unfinished loads.
+   *
+   * Must be called with the OpenGL context current.
+   */
+  void shutdown();
+
+  /**
+   * @brief Queues an image for decoding.
+   *
+   * The loader keeps the handle alive until the image has been uploaded and
+   * then points its entry at the new texture. Use TextureCache::loadAsync
+   * rather than calling this directly.
+   *
+   * @param handle The cache entry to fill.
+   * @param path The file path to the image.
+   */
+  void enqueue(const TextureHandle &handle, const char *path);
+
+  /**
+   * @brief Uploads decoded images within the per-call budget.
+   *
+   * Call once per frame on the render thread.
+   */
+  void update();
+
+  /**
+   * @brief Checks whether any image is still being loaded.
+   *
+   * @return True if no loads are queued, decoding or uploading.
+   */
+  bool isIdle();
+
+  /**
+   * @brief Gets the texture shown while an image is loading.
+   *
+   * @return A 1x1 opaque grey texture.
+   */
+  const Texture &getPlaceholder() const;
+
+  /**
+   * @brief Gets the loader statistics.
+   *
+   * @return The current statistics.
+   */
+  TextureLoaderStats getStats();
+};
+
+#endif // TEXTURE_LOADER_H
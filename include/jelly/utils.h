@@ -11,20 +11,12 @@
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 
+#include <jelly/gl_instrument.h>
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-// #ifdef DEBUG
-#define GL_CHECK(stmt)                                                         \
-  do {                                                                         \
-    stmt;                                                                      \
-    checkOpenGLError(#stmt, __FILE__, __LINE__);                               \
-  } while (0)
-// #else
-// #define GL_CHECK(stmt) stmt
-// #endif
-
 /**
  * @brief Converts degrees to radians.
  *
@@ -41,6 +33,4 @@ template <typename T = float> T radians(T deg);
  */
 template <typename T = float> T degrees(T rad);
 
-void checkOpenGLError(const char *stmt, const char *file, int line);
-
 #endif // UTILS_H
\ No newline at end of file
@@ -60,11 +60,29 @@ public:
    *
    * @param vbo The VBO to be linked.
    * @param layout The layout location to which the VBO should be linked.
+   * @param divisor The instance divisor; 0 advances the attribute per vertex,
+   * 1 advances it per instance.
+   * @param normalized Whether integer data is mapped to [0, 1] or [-1, 1].
    *
    * This method links a VBO to the VAO at the specified layout location.
    */
-  void LinkAttrib(VBO vbo, GLuint layout, GLuint numComponents, GLenum type,
-                  GLsizeiptr stride, GLvoid *offset);
+  void LinkAttrib(const VBO &vbo, GLuint layout, GLuint numComponents,
+                  GLenum type, GLsizeiptr stride, GLvoid *offset,
+                  GLuint divisor = 0, GLboolean normalized = GL_FALSE);
+
+  /**
+   * @brief Links an integer attribute of a VBO to the VAO.
+   *
+   * The shader reads the attribute as int or uint without any conversion.
+   *
+   * @param vbo The VBO to be linked.
+   * @param layout The layout location to which the VBO should be linked.
+   * @param divisor The instance divisor; 0 advances the attribute per vertex,
+   * 1 advances it per instance.
+   */
+  void LinkAttribI(const VBO &vbo, GLuint layout, GLuint numComponents,
+                   GLenum type, GLsizeiptr stride, GLvoid *offset,
+                   GLuint divisor = 0);
 
   /**
    * @brief Gets the ID of the VAO.
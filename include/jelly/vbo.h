@@ -4,6 +4,8 @@
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 
+#include <jelly/stream_buffer.h>
+
 /**
  * @class VBO
  * @brief A class to handle Vertex Buffer Objects (VBO) in OpenGL.
@@ -12,6 +14,7 @@
  */
 class VBO {
   GLuint m_id;
+  StreamBuffer m_stream;
 
 public:
   /**
@@ -32,8 +35,57 @@ public:
    *
    * @param vertices A pointer to the array of vertices.
    * @param size The size of the vertices array in bytes.
+   * @param offset The byte offset in the VBO to write at.
+   */
+  void Update(const void *vertices, GLsizeiptr size, GLintptr offset = 0);
+
+  /**
+   * @brief Initializes the VBO as a persistently mapped streaming buffer.
+   *
+   * Vertices are written straight into mapped memory through Reserve() and
+   * Commit() instead of being uploaded with Update().
+   *
+   * @param regionSize The size of one fenced region in bytes.
+   * @param regionCount The number of regions in the ring.
+   * @return False if the buffer could not be mapped and falls back to
+   * uploads.
+   */
+  bool InitStreaming(GLsizeiptr regionSize,
+                     GLuint regionCount = STREAM_REGION_COUNT);
+
+  /**
+   * @brief Returns a mapped write pointer with at least size bytes free.
+   *
+   * @param size The number of bytes that must be writable.
+   * @return A pointer into the mapped buffer.
+   */
+  void *Reserve(GLsizeiptr size);
+
+  /**
+   * @brief Marks bytes written at the write pointer as used.
+   *
+   * @param size The number of bytes written.
+   */
+  void Commit(GLsizeiptr size);
+
+  /**
+   * @brief Fences the current region and moves to the next one.
+   */
+  void NextRegion();
+
+  /**
+   * @brief Gets the number of free bytes in the current region.
+   *
+   * @return The number of free bytes.
+   */
+  GLsizeiptr getAvailable() const;
+
+  /**
+   * @brief Gets the offset of the write pointer in bytes.
+   *
+   * @return The offset from the start of the buffer.
    */
-  void Update(const void *vertices, GLsizeiptr size);
+  GLintptr getStreamOffset() const;
 
   /**
    * @brief Binds the VBO.
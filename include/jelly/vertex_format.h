@@ -0,0 +1,156 @@
+/**
+ * @file vertex_format.h
+ * @brief This file contains the vertex layouts of the batched renderer and
+ * the format traits that link them to vertex arrays and shaders.
+ *
+ * Renderer2D batches BatchQuadVertex and BatchCircleInstance. Building with
+ * JELLY_PACKED_VERTICES defined selects the quantized layouts, which store
+ * colors as normalized RGBA8, UVs as 16-bit UNORM and the texture index as an
+ * integer attribute.
+ */
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include <glad/gl.h>
+
+#include <jelly/shader.h>
+#include <jelly/vao.h>
+#include <jelly/vbo.h>
+#include <jelly/vec.h>
+
+struct QuadVertex {
+  Vec2<float> position;
+  Vec2<float> uv;
+  Vec4<float> color;
+  float textureIndex;
+};
+
+/**
+ * @brief Per-instance record of a circle drawn with a signed distance field.
+ *
+ * The vertex shader expands each instance into a quad around the circle and
+ * the fragment shader evaluates the distance to its edge.
+ */
+struct CircleInstance {
+  Vec2<float> center; ///< Center in world space
+  float radius;       ///< Outer radius in world units
+  float strokeWidth;  ///< Outline width in world units, or 0 when filled
+  Vec4<float> color;  ///< Color
+};
+
+/**
+ * @brief Quantized quad vertex, 20 bytes instead of the 36 of QuadVertex.
+ *
+ * Positions stay 32-bit floats: half floats step by 2 units past 2048, which
+ * would visibly snap sprites on large screens.
+ */
+struct PackedQuadVertex {
+  Vec2<float> position; ///< World position
+  uint16_t uv[2];       ///< Texture coordinates as UNORM16
+  uint8_t color[4];     ///< Color as normalized RGBA8
+  int32_t textureIndex; ///< Texture slot, or -1 for untextured
+};
+
+/**
+ * @brief Quantized circle instance, 20 bytes instead of the 32 of
+ * CircleInstance.
+ */
+struct PackedCircleInstance {
+  Vec2<float> center; ///< Center in world space
+  float radius;       ///< Outer radius in world units
+  float strokeWidth;  ///< Outline width in world units, or 0 when filled
+  uint8_t color[4];   ///< Color as normalized RGBA8
+};
+
+/**
+ * @brief Converts a value in [0, 1] to an unsigned normalized integer.
+ *
+ * @tparam T The unsigned integer type to convert to.
+ * @param value The value to convert; it is clamped to [0, 1].
+ */
+template <typename T> inline T packUnorm(float value) {
+  constexpr float max = static_cast<float>(static_cast<T>(~T(0)));
+  return static_cast<T>(std::clamp(value, 0.0f, 1.0f) * max + 0.5f);
+}
+
+/**
+ * @brief Links a vertex layout to a vertex array and builds its vertices.
+ *
+ * Specializations provide the shaders that read the layout, link() to set
+ * the attribute pointers of a bound VAO, and make() to build a vertex from
+ * float inputs.
+ *
+ * @tparam Vertex The vertex layout.
+ */
+template <typename Vertex> struct VertexFormat;
+
+template <> struct VertexFormat<QuadVertex> {
+  static constexpr const char *vertexShader = quad_vertex_shader;
+  static constexpr const char *fragmentShader = quad_fragment_shader;
+
+  static void link(VAO &vao, const VBO &vbo);
+
+  static QuadVertex make(const Vec2<float> &position, const Vec2<float> &uv,
+                         const Vec4<float> &color, int textureIndex) {
+    return {position, uv, color, static_cast<float>(textureIndex)};
+  }
+};
+
+template <> struct VertexFormat<PackedQuadVertex> {
+  static constexpr const char *vertexShader = packed_quad_vertex_shader;
+  static constexpr const char *fragmentShader = packed_quad_fragment_shader;
+
+  static void link(VAO &vao, const VBO &vbo);
+
+  static PackedQuadVertex make(const Vec2<float> &position,
+                               const Vec2<float> &uv, const Vec4<float> &color,
+                               int textureIndex) {
+    return {position,
+            {packUnorm<uint16_t>(uv.x), packUnorm<uint16_t>(uv.y)},
+            {packUnorm<uint8_t>(color.x), packUnorm<uint8_t>(color.y),
+             packUnorm<uint8_t>(color.z), packUnorm<uint8_t>(color.w)},
+            textureIndex};
+  }
+};
+
+template <> struct VertexFormat<CircleInstance> {
+  static constexpr const char *vertexShader = circle_vertex_shader;
+  static constexpr const char *fragmentShader = circle_fragment_shader;
+
+  static void link(VAO &vao, const VBO &vbo);
+
+  static CircleInstance make(const Vec2<float> &center, float radius,
+                             float strokeWidth, const Vec4<float> &color) {
+    return {center, radius, strokeWidth, color};
+  }
+};
+
+template <> struct VertexFormat<PackedCircleInstance> {
+  static constexpr const char *vertexShader = circle_vertex_shader;
+  static constexpr const char *fragmentShader = circle_fragment_shader;
+
+  static void link(VAO &vao, const VBO &vbo);
+
+  static PackedCircleInstance make(const Vec2<float> &center, float radius,
+                                   float strokeWidth,
+                                   const Vec4<float> &color) {
+    return {center,
+            radius,
+            strokeWidth,
+            {packUnorm<uint8_t>(color.x), packUnorm<uint8_t>(color.y),
+             packUnorm<uint8_t>(color.z), packUnorm<uint8_t>(color.w)}};
+  }
+};
+
+#ifdef JELLY_PACKED_VERTICES
+using BatchQuadVertex = PackedQuadVertex;
+using BatchCircleInstance = PackedCircleInstance;
+#else
+using BatchQuadVertex = QuadVertex;
+using BatchCircleInstance = CircleInstance;
+#endif
+
+#endif // VERTEX_FORMAT_H
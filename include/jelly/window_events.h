@@ -0,0 +1,132 @@
+/**
+ * @file window_events.h
+ * @brief This file contains the cached window state and the queue of window
+ * events GameContext dispatches once per frame.
+ */
+#ifndef WINDOW_EVENTS_H
+#define WINDOW_EVENTS_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include <GLFW/glfw3.h>
+
+#include <jelly/spsc_queue.h>
+
+/**
+ * @brief Number of window events that can queue up between two frames.
+ * Further events are dropped and the whole state is queried again.
+ */
+const size_t WINDOW_EVENT_QUEUE_CAPACITY = 64;
+
+enum class WindowEventType {
+  Resize,            ///< The window size in screen coordinates changed
+  FramebufferResize, ///< The framebuffer size in pixels changed
+  ContentScale,      ///< The window moved to a monitor with another scale
+  Focus,             ///< The window gained or lost input focus
+};
+
+/**
+ * @brief A change of the window. Only the fields of its type are set.
+ */
+struct WindowEvent {
+  WindowEventType type;
+  int width = 0;        ///< Resize and FramebufferResize
+  int height = 0;       ///< Resize and FramebufferResize
+  float xScale = 1.0f;  ///< ContentScale
+  float yScale = 1.0f;  ///< ContentScale
+  bool focused = false; ///< Focus
+};
+
+/**
+ * @brief The window as of the last dispatched events.
+ *
+ * On high-DPI displays the framebuffer is larger than the window; drawing
+ * coordinates are in window units and the viewport is in framebuffer
+ * pixels.
+ */
+struct WindowState {
+  int width = 0;             ///< Window width in screen coordinates
+  int height = 0;            ///< Window height in screen coordinates
+  int framebufferWidth = 0;  ///< Framebuffer width in pixels
+  int framebufferHeight = 0; ///< Framebuffer height in pixels
+  float xScale = 1.0f;       ///< Horizontal content scale
+  float yScale = 1.0f;       ///< Vertical content scale
+  bool focused = true;
+};
+
+/**
+ * @class WindowEvents
+ * @brief Collects window events from GLFW callbacks and applies them to a
+ * cached WindowState once per frame.
+ *
+ * The callbacks only push into a lock-free queue, so they are cheap and
+ * safe to run on a thread other than the one calling poll(). poll() drains
+ * the queue, updates the state and returns the latest event of each type;
+ * a window dragged through dozens of sizes in one frame is resized once.
+ * Reading the state never calls into GLFW.
+ */
+class WindowEvents {
+  GLFWwindow *m_window;
+  SpscQueue<WindowEvent, WINDOW_EVENT_QUEUE_CAPACITY> m_queue;
+  std::atomic<bool> m_overflowed;
+  WindowState m_state;
+  std::vector<WindowEvent> m_events;
+
+  static void onWindowSize(GLFWwindow *window, int width, int height);
+  static void onFramebufferSize(GLFWwindow *window, int width, int height);
+  static void onContentScale(GLFWwindow *window, float xScale, float yScale);
+  static void onFocus(GLFWwindow *window, int focused);
+
+public:
+  WindowEvents();
+
+  WindowEvents(const WindowEvents &) = delete;
+  WindowEvents &operator=(const WindowEvents &) = delete;
+
+  /**
+   * @brief Reads the current state of a window and installs the callbacks.
+   *
+   * Takes the window user pointer. Call before other libraries, such as
+   * the ImGui backend, install callbacks that chain to existing ones.
+   *
+   * @param window The window.
+   */
+  void attach(GLFWwindow *window);
+
+  /**
+   * @brief Sets the state of a window that sends no events, such as a
+   * headless context.
+   *
+   * @param state The state.
+   */
+  void setState(const WindowState &state);
+
+  /**
+   * @brief Queues an event. Called by the producer only.
+   *
+   * @param event The event.
+   * @return False if the queue was full; the next poll() then queries the
+   * whole state again.
+   */
+  bool push(const WindowEvent &event);
+
+  /**
+   * @brief Applies the queued events to the state. Called by the consumer
+   * only.
+   *
+   * @return The latest event of each type that changed the state, in the
+   * order of WindowEventType; valid until the next call.
+   */
+  const std::vector<WindowEvent> &poll();
+
+  /**
+   * @brief Gets the state as of the last poll().
+   *
+   * @return The state.
+   */
+  const WindowState &getState() const;
+};
+
+#endif // WINDOW_EVENTS_H
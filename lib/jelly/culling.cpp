@@ -0,0 +1,104 @@
+#include <jelly/culling.h>
+
+#ifdef JELLY_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+size_t cullScalar(const CullBoundsSoA &bounds, size_t begin,
+                  const CullRect &view, uint32_t *visible) {
+  size_t count = 0;
+  for (size_t i = begin; i < bounds.size(); ++i) {
+    CullRect rect = {bounds.minX[i], bounds.minY[i], bounds.maxX[i],
+                     bounds.maxY[i]};
+    // Branch-free append: the slot is always written, the count only grows
+    // for visible boxes.
+    visible[count] = static_cast<uint32_t>(i);
+    count += rect.overlaps(view) ? 1 : 0;
+  }
+  return count;
+}
+
+#ifdef JELLY_SIMD_X86
+
+inline size_t appendMask(unsigned mask, size_t base, uint32_t *visible) {
+  size_t count = 0;
+  while (mask != 0) {
+    visible[count++] = static_cast<uint32_t>(base + __builtin_ctz(mask));
+    mask &= mask - 1;
+  }
+  return count;
+}
+
+__attribute__((target("sse2"))) size_t
+cullSSE(const CullBoundsSoA &bounds, const CullRect &view, uint32_t *visible,
+        size_t &end) {
+  const __m128 viewMinX = _mm_set1_ps(view.minX);
+  const __m128 viewMinY = _mm_set1_ps(view.minY);
+  const __m128 viewMaxX = _mm_set1_ps(view.maxX);
+  const __m128 viewMaxY = _mm_set1_ps(view.maxY);
+
+  size_t count = 0;
+  size_t i = 0;
+  for (; i + 4 <= bounds.size(); i += 4) {
+    __m128 x = _mm_and_ps(
+        _mm_cmpge_ps(_mm_loadu_ps(&bounds.maxX[i]), viewMinX),
+        _mm_cmple_ps(_mm_loadu_ps(&bounds.minX[i]), viewMaxX));
+    __m128 y = _mm_and_ps(
+        _mm_cmpge_ps(_mm_loadu_ps(&bounds.maxY[i]), viewMinY),
+        _mm_cmple_ps(_mm_loadu_ps(&bounds.minY[i]), viewMaxY));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_and_ps(x, y)));
+    count += appendMask(mask, i, visible + count);
+  }
+  end = i;
+  return count;
+}
+
+__attribute__((target("avx"))) size_t
+cullAVX(const CullBoundsSoA &bounds, const CullRect &view, uint32_t *visible,
+        size_t &end) {
+  const __m256 viewMinX = _mm256_set1_ps(view.minX);
+  const __m256 viewMinY = _mm256_set1_ps(view.minY);
+  const __m256 viewMaxX = _mm256_set1_ps(view.maxX);
+  const __m256 viewMaxY = _mm256_set1_ps(view.maxY);
+
+  size_t count = 0;
+  size_t i = 0;
+  for (; i + 8 <= bounds.size(); i += 8) {
+    __m256 x = _mm256_and_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(&bounds.maxX[i]), viewMinX, _CMP_GE_OQ),
+        _mm256_cmp_ps(_mm256_loadu_ps(&bounds.minX[i]), viewMaxX, _CMP_LE_OQ));
+    __m256 y = _mm256_and_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(&bounds.maxY[i]), viewMinY, _CMP_GE_OQ),
+        _mm256_cmp_ps(_mm256_loadu_ps(&bounds.minY[i]), viewMaxY, _CMP_LE_OQ));
+    unsigned mask =
+        static_cast<unsigned>(_mm256_movemask_ps(_mm256_and_ps(x, y)));
+    count += appendMask(mask, i, visible + count);
+  }
+  end = i;
+  return count;
+}
+
+#endif // JELLY_SIMD_X86
+
+} // namespace
+
+size_t cullBounds(const CullBoundsSoA &bounds, const CullRect &view,
+                  uint32_t *visible, SimdLevel level) {
+  if (!isSimdLevelSupported(level))
+    level = SimdLevel::Scalar;
+
+  // The vector kernels stop at the last full vector; the scalar kernel
+  // finishes the tail.
+  size_t count = 0;
+  size_t end = 0;
+#ifdef JELLY_SIMD_X86
+  if (level == SimdLevel::AVX) {
+    count = cullAVX(bounds, view, visible, end);
+  } else if (level == SimdLevel::SSE) {
+    count = cullSSE(bounds, view, visible, end);
+  }
+#endif
+  return count + cullScalar(bounds, end, view, visible + count);
+}
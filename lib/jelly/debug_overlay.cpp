@@ -1,7 +1,30 @@
+#include <algorithm>
+#include <cfloat>
+
 #include "jelly/debug_overlay.h"
+#include "jelly/frame_limiter.h"
+#include "jelly/gl_state.h"
+#include "jelly/renderer_2d.h"
+#include "jelly/window_events.h"
+
+namespace {
+
+// Nearest-rank percentile of sorted values.
+float percentile(const std::vector<float> &sorted, float fraction) {
+  size_t rank = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5f);
+  return sorted[rank];
+}
 
-void DebugOverlay::init(GLFWwindow *window) {
+} // namespace
+
+void DebugOverlay::init(GLFWwindow *window, Renderer2D &renderer,
+                        FrameLimiter &frameLimiter,
+                        const WindowState &windowState) {
   m_window = window;
+  m_renderer = &renderer;
+  m_frameLimiter = &frameLimiter;
+  m_windowState = &windowState;
+  m_sorted.reserve(OVERLAY_FRAME_HISTORY);
 
   // Initialize ImGui context
   IMGUI_CHECKVERSION();
@@ -22,14 +45,123 @@ void DebugOverlay::beginFrame() {
   ImGui::NewFrame();
 }
 
+void DebugOverlay::recordFrame() {
+  Clock::time_point now = Clock::now();
+  if (!m_timing) {
+    // The first call has no previous frame to measure from.
+    m_lastFrame = now;
+    m_timing = true;
+    return;
+  }
+
+  float milliseconds =
+      std::chrono::duration<float, std::milli>(now - m_lastFrame).count();
+  m_lastFrame = now;
+
+  m_frameTimes[m_historyHead] = milliseconds;
+  m_drawCalls[m_historyHead] =
+      static_cast<float>(m_renderer->getStats().drawCalls);
+  const FrameLatency *latency = m_frameLimiter->getLatest();
+  m_latencies[m_historyHead] =
+      latency != nullptr ? static_cast<float>(latency->inputToComplete) : 0.0f;
+  m_historyHead = (m_historyHead + 1) % OVERLAY_FRAME_HISTORY;
+  m_historyCount = std::min(m_historyCount + 1, OVERLAY_FRAME_HISTORY);
+}
+
+void DebugOverlay::renderFrameTimes() {
+  if (m_historyCount == 0)
+    return;
+
+  m_sorted.assign(m_frameTimes.begin(),
+                  m_frameTimes.begin() + m_historyCount);
+  std::sort(m_sorted.begin(), m_sorted.end());
+
+  ImGui::Text("Frame time over %zu frames (ms):", m_historyCount);
+  ImGui::Text("p50 %.2f  p95 %.2f  p99 %.2f  max %.2f",
+              percentile(m_sorted, 0.50f), percentile(m_sorted, 0.95f),
+              percentile(m_sorted, 0.99f), m_sorted.back());
+
+  // Until the history is full it starts at slot 0; afterwards the oldest
+  // frame is at the head.
+  int offset = m_historyCount == OVERLAY_FRAME_HISTORY
+                   ? static_cast<int>(m_historyHead)
+                   : 0;
+  ImGui::PlotLines("##frameTimes", m_frameTimes.data(),
+                   static_cast<int>(m_historyCount), offset, nullptr, 0.0f,
+                   m_sorted.back() * 1.1f, ImVec2(-1.0f, 60.0f));
+}
+
+void DebugOverlay::renderLatency() {
+  const FrameLatency *latency = m_frameLimiter->getLatest();
+  if (latency == nullptr) {
+    ImGui::Text("Input latency: no frame completed");
+    return;
+  }
+
+  ImGui::Text("Input latency: %.2f ms", latency->inputToComplete);
+  ImGui::Text("  CPU %.2f ms  GPU %.2f ms", latency->inputToSubmit,
+              latency->submitToComplete);
+  ImGui::Text("Frames in flight: %zu of %zu",
+              m_frameLimiter->getFramesInFlight(),
+              m_frameLimiter->getMaxFramesInFlight());
+  int offset = m_historyCount == OVERLAY_FRAME_HISTORY
+                   ? static_cast<int>(m_historyHead)
+                   : 0;
+  ImGui::PlotLines("##latencies", m_latencies.data(),
+                   static_cast<int>(m_historyCount), offset, nullptr, 0.0f,
+                   FLT_MAX, ImVec2(-1.0f, 40.0f));
+}
+
+void DebugOverlay::renderRendererStats() {
+  const RenderStats &stats = m_renderer->getStats();
+
+  ImGui::Text("Draw calls: %zu", stats.drawCalls);
+  int offset = m_historyCount == OVERLAY_FRAME_HISTORY
+                   ? static_cast<int>(m_historyHead)
+                   : 0;
+  ImGui::PlotLines("##drawCalls", m_drawCalls.data(),
+                   static_cast<int>(m_historyCount), offset, nullptr, 0.0f,
+                   FLT_MAX, ImVec2(-1.0f, 40.0f));
+  ImGui::Text("Vertices: %zu  Indices: %zu", stats.vertices, stats.indices);
+  ImGui::Text("Instances: %zu", stats.instances);
+  ImGui::Text("Uploaded: %.1f KiB", stats.bytesUploaded / 1024.0);
+  ImGui::Text("Texture binds: %zu", stats.textureBinds);
+
+  ImGui::Separator();
+  ImGui::Text("Flushes by reason:");
+  for (size_t i = 0; i < FLUSH_REASON_COUNT; ++i) {
+    if (stats.flushes[i] > 0) {
+      ImGui::Text("  %s: %zu", flushReasonName(static_cast<FlushReason>(i)),
+                  stats.flushes[i]);
+    }
+  }
+
+  bool debugMode = m_renderer->isDebugMode();
+  if (ImGui::Checkbox("Log every batch", &debugMode)) {
+    m_renderer->setDebugMode(debugMode);
+  }
+  if (debugMode && ImGui::CollapsingHeader("Batches")) {
+    for (const FlushRecord &record : m_renderer->getFlushLog()) {
+      ImGui::Text("%zu %s, %s", record.items, record.batch,
+                  flushReasonName(record.reason));
+    }
+  }
+}
+
 void DebugOverlay::render() {
-  int fbWidth, fbHeight;
-  glfwGetFramebufferSize(m_window, &fbWidth, &fbHeight);
+  recordFrame();
 
-  // Retrieve the current viewport size
+  // ImGui lays out in window coordinates and renders at the framebuffer
+  // resolution, so high-DPI displays get sharp text at the same size.
+  const WindowState &window = *m_windowState;
   ImGuiIO &io = ImGui::GetIO();
-  io.DisplaySize =
-      ImVec2(static_cast<float>(fbWidth), static_cast<float>(fbHeight));
+  io.DisplaySize = ImVec2(static_cast<float>(window.width),
+                          static_cast<float>(window.height));
+  if (window.width > 0 && window.height > 0) {
+    io.DisplayFramebufferScale = ImVec2(
+        static_cast<float>(window.framebufferWidth) / window.width,
+        static_cast<float>(window.framebufferHeight) / window.height);
+  }
 
   float windowWidth = io.DisplaySize.x;
   float windowHeight = io.DisplaySize.y;
@@ -44,13 +176,28 @@ void DebugOverlay::render() {
   ImGui::Begin("Debug", nullptr, ImGuiWindowFlags_NoResize);
 
   ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
-  ImGui::Text("Window Size: %d x %d", windowWidth, windowHeight);
+  ImGui::Text("Window Size: %.0f x %.0f", windowWidth, windowHeight);
+  ImGui::Text("Framebuffer: %d x %d", window.framebufferWidth,
+              window.framebufferHeight);
+  renderFrameTimes();
+  renderLatency();
+
+  ImGui::Separator();
+  renderRendererStats();
+
+  const GLStateStats &glStats = GLState::getFrameStats();
+  ImGui::Text("GL binds: %zu issued, %zu skipped", glStats.issued,
+              glStats.skipped);
 
   ImGui::End();
 
   // Render the ImGui frame
   ImGui::Render();
   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+  // The backend binds its own program, buffers and textures behind the
+  // state cache's back.
+  GLState::invalidate();
 }
 
 void DebugOverlay::shutdown() {
@@ -1,30 +1,55 @@
 #include <jelly/ebo.h>
-#include <jelly/utils.h>
+#include <jelly/gl_state.h>
+#include <jelly/render_device.h>
 
 EBO::EBO() : m_id(0) {}
 
 void EBO::Init(const void *indices, GLsizeiptr size) {
-  GL_CHECK(glGenBuffers(1, &m_id));
-  GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id));
-  GL_CHECK(
-      glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW));
+  m_id = RenderDevice::get().createBuffer();
+  Bind();
+  RenderDevice::get().bufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices,
+                                 GL_STATIC_DRAW);
+}
+
+void EBO::InitStatic(const void *indices, GLsizeiptr size) {
+  m_id = RenderDevice::get().createBuffer();
+  Bind();
+  RenderDevice::get().bufferStorage(GL_ELEMENT_ARRAY_BUFFER, size, indices, 0);
 }
 
 void EBO::Update(const void *indices, GLsizeiptr size) {
   Bind();
-  GL_CHECK(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, size, indices));
+  RenderDevice::get().bufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, size, indices);
 }
 
-void EBO::Bind() const {
-  GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id));
+bool EBO::InitStreaming(GLsizeiptr regionSize, GLuint regionCount) {
+  m_id = RenderDevice::get().createBuffer();
+  return m_stream.Init(GL_ELEMENT_ARRAY_BUFFER, m_id, regionSize,
+                       regionCount);
 }
 
-void EBO::Unbind() const { GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0)); }
+void *EBO::Reserve(GLsizeiptr size) { return m_stream.Reserve(size); }
+
+void EBO::Commit(GLsizeiptr size) { m_stream.Commit(size); }
+
+void EBO::NextRegion() { m_stream.NextRegion(); }
+
+GLsizeiptr EBO::getAvailable() const { return m_stream.getAvailable(); }
+
+GLintptr EBO::getStreamOffset() const { return m_stream.getOffset(); }
+
+void EBO::Bind() const { GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id); }
+
+void EBO::Unbind() const {
+  GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
 
 void EBO::Delete() {
   if (m_id != 0) {
+    m_stream.Delete();
     Unbind();
-    GL_CHECK(glDeleteBuffers(1, &m_id));
+    GLState::forgetBuffer(m_id);
+    RenderDevice::get().deleteBuffer(m_id);
     m_id = 0; // Reset to prevent accidental re-deletion
   }
 }
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <utility>
+
+#include <jelly/frame_limiter.h>
+#include <jelly/profiler.h>
+#include <jelly/render_device.h>
+
+namespace {
+
+double milliseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+FrameLimiter::FrameLimiter(size_t maxFramesInFlight)
+    : m_maxFramesInFlight(maxFramesInFlight), m_frame(0), m_latest{},
+      m_hasLatest(false) {}
+
+FrameLimiter::~FrameLimiter() {
+  if (!m_pending.empty()) {
+    std::cerr << "Error: FrameLimiter destroyed with " << m_pending.size()
+              << " fences pending; call reset() first" << std::endl;
+  }
+}
+
+void FrameLimiter::setMaxFramesInFlight(size_t maxFramesInFlight) {
+  m_maxFramesInFlight = maxFramesInFlight;
+}
+
+size_t FrameLimiter::getMaxFramesInFlight() const {
+  return m_maxFramesInFlight;
+}
+
+size_t FrameLimiter::getFramesInFlight() const { return m_pending.size(); }
+
+void FrameLimiter::complete(GLenum result) {
+  Clock::time_point now = Clock::now();
+  PendingFrame frame = m_pending.front();
+  m_pending.pop_front();
+  if (result == GL_WAIT_FAILED) {
+    std::cerr << "Error: Waiting on the fence of frame " << frame.frame
+              << " failed" << std::endl;
+  }
+  RenderDevice::get().deleteSync(frame.fence);
+
+  m_latest.frame = frame.frame;
+  m_latest.inputToSubmit = milliseconds(frame.submit - frame.input);
+  m_latest.submitToComplete = milliseconds(now - frame.submit);
+  m_latest.inputToComplete = milliseconds(now - frame.input);
+  m_hasLatest = true;
+  if (m_callback) {
+    m_callback(m_latest);
+  }
+}
+
+void FrameLimiter::retireSignaled() {
+  RenderDevice &device = RenderDevice::get();
+  // Fences signal in order, so the first unsignaled one ends the scan.
+  while (!m_pending.empty()) {
+    GLenum result = device.clientWaitSync(m_pending.front().fence,
+                                          GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+      return;
+    complete(result);
+  }
+}
+
+void FrameLimiter::waitForSlot() {
+  JELLY_PROFILE_ZONE("FrameLimiter::waitForSlot");
+  retireSignaled();
+  if (m_maxFramesInFlight == 0)
+    return;
+
+  RenderDevice &device = RenderDevice::get();
+  while (m_pending.size() >= m_maxFramesInFlight) {
+    GLenum result = device.clientWaitSync(m_pending.front().fence,
+                                          GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    if (result != GL_TIMEOUT_EXPIRED) {
+      complete(result);
+    }
+  }
+}
+
+void FrameLimiter::markInput() { m_input = Clock::now(); }
+
+void FrameLimiter::markSubmit() { m_submit = Clock::now(); }
+
+void FrameLimiter::endFrame() {
+  if (m_maxFramesInFlight > 0) {
+    m_pending.push_back(
+        {RenderDevice::get().fenceSync(), m_frame, m_input, m_submit});
+  }
+  ++m_frame;
+}
+
+const FrameLatency *FrameLimiter::getLatest() const {
+  return m_hasLatest ? &m_latest : nullptr;
+}
+
+void FrameLimiter::setLatencyCallback(
+    std::function<void(const FrameLatency &)> callback) {
+  m_callback = std::move(callback);
+}
+
+void FrameLimiter::reset() {
+  for (const PendingFrame &frame : m_pending) {
+    RenderDevice::get().deleteSync(frame.fence);
+  }
+  m_pending.clear();
+}
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include <jelly/frame_timing.h>
+
+FixedTimestep::FixedTimestep(double step, size_t maxSteps)
+    : m_step(step), m_maxSteps(maxSteps), m_accumulator(0.0) {}
+
+size_t FixedTimestep::advance(double elapsed) {
+  m_accumulator += std::max(elapsed, 0.0);
+
+  size_t steps = static_cast<size_t>(m_accumulator / m_step);
+  if (steps > m_maxSteps) {
+    // Keep the fraction so the alpha stays continuous, and drop the rest.
+    steps = m_maxSteps;
+    m_accumulator -= std::floor(m_accumulator / m_step) * m_step;
+  } else {
+    m_accumulator -= steps * m_step;
+  }
+  return steps;
+}
+
+double FixedTimestep::getStep() const { return m_step; }
+
+double FixedTimestep::getAlpha() const {
+  return std::clamp(m_accumulator / m_step, 0.0, 1.0);
+}
+
+void FixedTimestep::reset() { m_accumulator = 0.0; }
+
+static std::chrono::steady_clock::duration toDuration(double seconds) {
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(seconds));
+}
+
+FramePacer::FramePacer(double frameTime, double spinTime)
+    : m_interval(toDuration(frameTime)), m_spinTime(toDuration(spinTime)),
+      m_started(false) {}
+
+void FramePacer::setFrameTime(double frameTime) {
+  m_interval = toDuration(frameTime);
+  m_started = false;
+}
+
+void FramePacer::wait() {
+  if (m_interval <= Clock::duration::zero())
+    return;
+
+  Clock::time_point now = Clock::now();
+  if (!m_started) {
+    m_started = true;
+    m_deadline = now + m_interval;
+    return;
+  }
+
+  if (now - m_deadline >= m_interval) {
+    m_deadline = now + m_interval;
+    return;
+  }
+
+  if (m_deadline - now > m_spinTime) {
+    std::this_thread::sleep_for(m_deadline - now - m_spinTime);
+  }
+  while (Clock::now() < m_deadline) {
+    std::this_thread::yield();
+  }
+  m_deadline += m_interval;
+}
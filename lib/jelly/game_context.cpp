@@ -1,4 +1,8 @@
+#include <chrono>
+#include <utility>
+
 #include <jelly/game_context.h>
+#include <jelly/profiler.h>
 
 GameContext *GameContext::m_instance = nullptr;
 
@@ -12,10 +16,25 @@ void GameContext::init(int windowWidth, int windowHeight, const char *title,
   }
 
   if (debugOverlayEnabled) {
-    m_instance->m_debugOverlay.init(m_instance->getWindow());
+    m_instance->m_debugOverlay.init(
+        m_instance->getWindow(), m_instance->getRenderer(),
+        m_instance->getFrameLimiter(), m_instance->getWindowState());
   }
 }
 
+bool GameContext::initHeadless(int width, int height) {
+  if (m_instance == nullptr) {
+    std::cout << "\033[34mJelly Engine v0.1\033[0m" << std::endl;
+    GameContext *context = new GameContext(width, height);
+    if (!context->m_headless.isInitialized()) {
+      delete context;
+      return false;
+    }
+    m_instance = context;
+  }
+  return true;
+}
+
 void GameContext::shutdown() {
 
   if (m_instance != nullptr) {
@@ -23,13 +42,22 @@ void GameContext::shutdown() {
       m_instance->m_debugOverlay.shutdown();
     }
 
+#if JELLY_GL_LEVEL != JELLY_GL_OFF
+    GLInstrument::report(std::cout);
+#endif
+
+    m_instance->m_frameLimiter.reset();
     m_instance->m_renderer.shutdown();
+    m_instance->m_textureLoader.shutdown();
+    m_instance->m_textureCache.clear();
 
     delete m_instance;
     m_instance = nullptr;
   }
 }
 
+bool GameContext::isInitialized() { return m_instance != nullptr; }
+
 GameContext &GameContext::getInstance() {
   if (m_instance == nullptr) {
     std::cerr << "GameContext not initialized! Call Jelly::init() first."
@@ -42,7 +70,8 @@ GameContext &GameContext::getInstance() {
 GameContext::GameContext(int windowWidth, int windowHeight, const char *title,
                          bool debugOverlayEnabled)
     : m_renderer(windowWidth, windowHeight, 1.0f),
-      m_debugOverlayEnabled(debugOverlayEnabled) {
+      m_debugOverlayEnabled(debugOverlayEnabled), m_running(false) {
+  JELLY_PROFILE_ZONE("GameContext::init");
   std::cout << "Initializing GLFW..." << std::endl;
 
   if (!glfwInit()) {
@@ -76,22 +105,42 @@ GameContext::GameContext(int windowWidth, int windowHeight, const char *title,
     std::terminate();
   }
 
-  int width, height;
-  glfwGetFramebufferSize(m_window, &width, &height);
-  glViewport(0, 0, width, height);
+  // Before the debug overlay, whose ImGui backend chains to the callbacks
+  // these install.
+  m_windowEvents.attach(m_window);
+  m_input.attach(m_window);
+  const WindowState &state = m_windowEvents.getState();
+  glViewport(0, 0, state.framebufferWidth, state.framebufferHeight);
+
+  initGL();
+  m_renderer.updateProjection(state.width, state.height);
+}
+
+GameContext::GameContext(int width, int height)
+    : m_window(nullptr), m_renderer(width, height, 1.0f),
+      m_debugOverlayEnabled(false), m_running(false) {
+  JELLY_PROFILE_ZONE("GameContext::initHeadless");
+  std::cout << "Initializing headless context..." << std::endl;
+
+  if (!m_headless.init(width, height))
+    return;
+
+  WindowState state;
+  state.width = state.framebufferWidth = width;
+  state.height = state.framebufferHeight = height;
+  m_windowEvents.setState(state);
 
+  initGL();
+}
+
+void GameContext::initGL() {
+  JELLY_PROFILE_ZONE("GameContext::initGL");
   glDisable(GL_DEPTH_TEST);
   glDisable(GL_CULL_FACE);
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-  glEnable(GL_DEBUG_OUTPUT);
-  glDebugMessageCallback(
-      [](GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
-         const GLchar *message, const void *userParam) {
-        std::cerr << "GL Debug: " << message << std::endl;
-      },
-      nullptr);
+  GLInstrument::enableDebugOutput();
 
   std::cout << "Open GL loaded succesfully" << std::endl;
   std::cout << "\t Version: " << glGetString(GL_VERSION) << std::endl;
@@ -99,31 +148,137 @@ GameContext::GameContext(int windowWidth, int windowHeight, const char *title,
   std::cout << "\t Renderer: " << glGetString(GL_RENDERER) << std::endl;
 
   m_renderer.init();
+  m_textureLoader.init();
 }
 
 GameContext::~GameContext() {
+  if (m_window == nullptr) {
+    m_headless.shutdown();
+    return;
+  }
   glfwDestroyWindow(m_window);
   glfwTerminate();
 }
 
 GLFWwindow *GameContext::getWindow() const { return m_window; }
 
+bool GameContext::isHeadless() const { return m_window == nullptr; }
+
+HeadlessContext &GameContext::getHeadlessContext() { return m_headless; }
+
 int GameContext::getWindowWidth() const {
-  int width, height;
-  glfwGetWindowSize(m_window, &width, &height);
-  return width;
+  return m_windowEvents.getState().width;
 }
 
 int GameContext::getWindowHeight() const {
-  int width, height;
-  glfwGetWindowSize(m_window, &width, &height);
-  return height;
+  return m_windowEvents.getState().height;
+}
+
+const WindowState &GameContext::getWindowState() const {
+  return m_windowEvents.getState();
 }
 
 Renderer2D &GameContext::getRenderer() { return m_renderer; }
 
 DebugOverlay &GameContext::getDebugOverlay() { return m_debugOverlay; }
 
+TextureCache &GameContext::getTextureCache() { return m_textureCache; }
+
+TextureLoader &GameContext::getTextureLoader() { return m_textureLoader; }
+
+FrameLimiter &GameContext::getFrameLimiter() { return m_frameLimiter; }
+
+Input &GameContext::getInput() { return m_input; }
+
 bool GameContext::isDebugOverlayEnabled() const {
   return m_debugOverlayEnabled;
-}
\ No newline at end of file
+}
+
+void GameContext::setSwapInterval(int interval) {
+  if (!isHeadless()) {
+    glfwSwapInterval(interval);
+  }
+}
+
+void GameContext::setWindowEventCallback(
+    std::function<void(const WindowEvent &)> callback) {
+  m_windowEventCallback = std::move(callback);
+}
+
+void GameContext::processWindowEvents() {
+  for (const WindowEvent &event : m_windowEvents.poll()) {
+    // A minimized window reports a size of 0, which has no projection.
+    bool visible = event.width > 0 && event.height > 0;
+    if (event.type == WindowEventType::FramebufferResize && visible) {
+      glViewport(0, 0, event.width, event.height);
+    } else if (event.type == WindowEventType::Resize && visible) {
+      m_renderer.updateProjection(event.width, event.height);
+    } else if (event.type == WindowEventType::Focus && !event.focused) {
+      m_input.releaseAll();
+    }
+
+    if (m_windowEventCallback) {
+      m_windowEventCallback(event);
+    }
+  }
+}
+
+void GameContext::run(const std::function<void(double step)> &update,
+                      const std::function<void(double alpha)> &render,
+                      const GameLoopConfig &config) {
+  using Clock = std::chrono::steady_clock;
+
+  setSwapInterval(config.swapInterval);
+  FixedTimestep timestep(1.0 / config.updateRate, config.maxUpdatesPerFrame);
+  FramePacer pacer(
+      config.targetFrameRate > 0.0 ? 1.0 / config.targetFrameRate : 0.0,
+      config.spinTime);
+  m_frameLimiter.setMaxFramesInFlight(config.framesInFlight);
+
+  Clock::time_point previous = Clock::now();
+  m_running = true;
+  while (m_running && (isHeadless() || !glfwWindowShouldClose(m_window))) {
+    JELLY_PROFILE_ZONE("GameContext::frame");
+    // Waiting before the poll rather than after the swap keeps the input
+    // as fresh as the queue allows.
+    m_frameLimiter.waitForSlot();
+    if (!isHeadless()) {
+      glfwPollEvents();
+    }
+    processWindowEvents();
+    m_input.update();
+    m_frameLimiter.markInput();
+    m_textureLoader.update();
+
+    Clock::time_point now = Clock::now();
+    size_t steps =
+        timestep.advance(std::chrono::duration<double>(now - previous).count());
+    previous = now;
+    for (size_t i = 0; i < steps; ++i) {
+      update(timestep.getStep());
+    }
+
+    m_renderer.begin();
+    render(timestep.getAlpha());
+    m_renderer.end();
+
+    if (m_debugOverlayEnabled) {
+      m_debugOverlay.beginFrame();
+      m_debugOverlay.render();
+    }
+
+    m_frameLimiter.markSubmit();
+    if (!isHeadless()) {
+      glfwSwapBuffers(m_window);
+    }
+    m_frameLimiter.endFrame();
+#ifdef JELLY_PROFILE
+    Profiler::collect();
+#endif
+    pacer.wait();
+  }
+  m_frameLimiter.reset();
+  m_running = false;
+}
+
+void GameContext::stop() { m_running = false; }
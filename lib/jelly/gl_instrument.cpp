@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+
+#include <jelly/gl_instrument.h>
+
+namespace {
+
+struct FrameHistory {
+  std::array<GLFrameStats, GL_FRAME_HISTORY> frames;
+  size_t head = 0; // Slot the next finished frame goes to
+  size_t count = 0;
+  uint64_t frame = 0;
+  uint64_t errors = 0; // Errors in the current frame
+};
+
+FrameHistory g_history;
+
+std::vector<GLCallSite *> &callSites() {
+  // Call sites register during static initialization of other files too,
+  // so the list is created on first use.
+  static std::vector<GLCallSite *> sites;
+  return sites;
+}
+
+// Call sites of GL_CHECK_AT, by statement, file and line. The strings are
+// compared by text, since the same literal may have several addresses.
+using CallerKey =
+    std::tuple<std::string_view, std::string_view, uint_least32_t>;
+
+std::map<CallerKey, std::unique_ptr<GLCallSite>> &callerSites() {
+  static std::map<CallerKey, std::unique_ptr<GLCallSite>> sites;
+  return sites;
+}
+
+// The driver may call the debug callback from its own threads.
+struct DebugFilter {
+  std::mutex mutex;
+  GLenum minSeverity = GL_DEBUG_SEVERITY_LOW;
+  std::unordered_map<uint64_t, size_t> seen;
+  size_t suppressed = 0;
+};
+
+DebugFilter g_debugFilter;
+
+int severityRank(GLenum severity) {
+  switch (severity) {
+  case GL_DEBUG_SEVERITY_HIGH:
+    return 3;
+  case GL_DEBUG_SEVERITY_MEDIUM:
+    return 2;
+  case GL_DEBUG_SEVERITY_LOW:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+const char *severityName(GLenum severity) {
+  switch (severity) {
+  case GL_DEBUG_SEVERITY_HIGH:
+    return "high";
+  case GL_DEBUG_SEVERITY_MEDIUM:
+    return "medium";
+  case GL_DEBUG_SEVERITY_LOW:
+    return "low";
+  default:
+    return "note";
+  }
+}
+
+void debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                   GLsizei length, const GLchar *message,
+                   const void *userParam) {
+  std::lock_guard<std::mutex> lock(g_debugFilter.mutex);
+  if (severityRank(severity) < severityRank(g_debugFilter.minSeverity))
+    return;
+
+  // Some drivers report every message with id 0, so the text is part of the
+  // key too.
+  std::string_view text =
+      length >= 0 ? std::string_view(message, length) : message;
+  uint64_t key = std::hash<std::string_view>()(text);
+  key ^= (uint64_t(source) << 48) ^ (uint64_t(type) << 32) ^ id;
+
+  if (g_debugFilter.seen[key]++ > 0) {
+    g_debugFilter.suppressed++;
+    return;
+  }
+  std::cerr << "GL Debug (" << severityName(severity) << "): " << text
+            << '\n';
+}
+
+} // namespace
+
+GLCallSite::GLCallSite(const char *call, const char *file, int line)
+    : call(call), file(file), line(line) {
+  callSites().push_back(this);
+}
+
+#if JELLY_GL_LEVEL >= JELLY_GL_TRACE
+static uint64_t nowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+GLCallTimer::GLCallTimer(GLCallSite &site)
+    : m_site(site), m_start(nowNanos()) {}
+
+GLCallTimer::~GLCallTimer() { m_site.frameNanos += nowNanos() - m_start; }
+#endif
+
+void GLInstrument::nextFrame() {
+#if JELLY_GL_LEVEL != JELLY_GL_OFF
+  GLFrameStats stats;
+  stats.frame = g_history.frame++;
+  stats.errors = g_history.errors;
+  for (GLCallSite *site : callSites()) {
+    stats.calls += site->frameCalls;
+    stats.cpuNanos += site->frameNanos;
+    site->totalCalls += site->frameCalls;
+    site->totalNanos += site->frameNanos;
+    site->frameCalls = 0;
+    site->frameNanos = 0;
+  }
+
+  g_history.frames[g_history.head] = stats;
+  g_history.head = (g_history.head + 1) % GL_FRAME_HISTORY;
+  g_history.count = std::min(g_history.count + 1, GL_FRAME_HISTORY);
+  g_history.errors = 0;
+#endif
+}
+
+size_t GLInstrument::getFrameCount() { return g_history.count; }
+
+const GLFrameStats &GLInstrument::getFrame(size_t framesAgo) {
+  size_t slot = (g_history.head + GL_FRAME_HISTORY - 1 - framesAgo) %
+                GL_FRAME_HISTORY;
+  return g_history.frames[slot];
+}
+
+const std::vector<GLCallSite *> &GLInstrument::getCallSites() {
+  return callSites();
+}
+
+GLCallSite &GLInstrument::getCallSite(const char *call,
+                                      const GLCaller &caller) {
+  std::unique_ptr<GLCallSite> &site =
+      callerSites()[{call, caller.file_name(), caller.line()}];
+  if (!site) {
+    site = std::make_unique<GLCallSite>(call, caller.file_name(),
+                                        static_cast<int>(caller.line()));
+  }
+  return *site;
+}
+
+void GLInstrument::report(std::ostream &out, size_t maxSites) {
+  std::vector<GLCallSite *> sites = callSites();
+  std::sort(sites.begin(), sites.end(),
+            [](const GLCallSite *a, const GLCallSite *b) {
+              if (a->totalNanos != b->totalNanos)
+                return a->totalNanos > b->totalNanos;
+              return a->totalCalls > b->totalCalls;
+            });
+  sites.resize(std::min(sites.size(), maxSites));
+
+  out << "GL calls over " << g_history.frame << " frames:\n";
+  for (const GLCallSite *site : sites) {
+    out << "  " << site->totalCalls << " calls";
+#if JELLY_GL_LEVEL >= JELLY_GL_TRACE
+    out << ", " << site->totalNanos / 1000 << " us";
+#endif
+    out << "  " << site->call << "  (" << site->file << ":" << site->line
+        << ")\n";
+  }
+}
+
+void GLInstrument::enableDebugOutput(GLenum minSeverity) {
+#if JELLY_GL_LEVEL >= JELLY_GL_CHECK
+  {
+    std::lock_guard<std::mutex> lock(g_debugFilter.mutex);
+    g_debugFilter.minSeverity = minSeverity;
+  }
+  glEnable(GL_DEBUG_OUTPUT);
+  glDebugMessageCallback(debugCallback, nullptr);
+#endif
+}
+
+size_t GLInstrument::getSuppressedMessageCount() {
+  std::lock_guard<std::mutex> lock(g_debugFilter.mutex);
+  return g_debugFilter.suppressed;
+}
+
+void GLInstrument::recordError() { g_history.errors++; }
+
+void checkOpenGLError(const char *stmt, const char *file, int line) {
+  GLenum err = glGetError();
+  while (err != GL_NO_ERROR) {
+    GLInstrument::recordError();
+    std::cerr << "OpenGL error " << err << " at " << file << ":" << line
+              << " - for " << stmt << std::endl;
+    err = glGetError();
+  }
+}
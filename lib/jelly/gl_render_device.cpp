@@ -0,0 +1,286 @@
+#include <iostream>
+
+#include <jelly/gl_render_device.h>
+#include <jelly/shader.h>
+#include <jelly/utils.h>
+
+namespace {
+
+void printCompileErrors(GLuint shader) {
+  GLint success = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+  if (!success) {
+    GLchar log[1024];
+    glGetShaderInfoLog(shader, 1024, nullptr, log);
+    std::cerr << "Error: Shader compilation failed: " << log << std::endl;
+  }
+}
+
+void printLinkErrors(GLuint program) {
+  GLint success = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (!success) {
+    GLchar log[1024];
+    glGetProgramInfoLog(program, 1024, nullptr, log);
+    std::cerr << "Error: Shader linking failed: " << log << std::endl;
+  }
+}
+
+GLuint compileShader(GLenum type, const char *source) {
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, nullptr);
+  glCompileShader(shader);
+  printCompileErrors(shader);
+  return shader;
+}
+
+} // namespace
+
+GLuint GLRenderDevice::createBuffer(GLCaller caller) {
+  GLuint buffer = 0;
+  GL_CHECK_AT(glGenBuffers(1, &buffer), caller);
+  return buffer;
+}
+
+void GLRenderDevice::deleteBuffer(GLuint buffer, GLCaller caller) {
+  GL_CHECK_AT(glDeleteBuffers(1, &buffer), caller);
+}
+
+void GLRenderDevice::bindBuffer(GLenum target, GLuint buffer, GLCaller caller) {
+  GL_CHECK_AT(glBindBuffer(target, buffer), caller);
+}
+
+void GLRenderDevice::bufferData(GLenum target, GLsizeiptr size,
+                                const void *data, GLenum usage,
+                                GLCaller caller) {
+  GL_CHECK_AT(glBufferData(target, size, data, usage), caller);
+}
+
+void GLRenderDevice::bufferStorage(GLenum target, GLsizeiptr size,
+                                   const void *data, GLbitfield flags,
+                                   GLCaller caller) {
+  GL_CHECK_AT(glBufferStorage(target, size, data, flags), caller);
+}
+
+void GLRenderDevice::bufferSubData(GLenum target, GLintptr offset,
+                                   GLsizeiptr size, const void *data,
+                                   GLCaller caller) {
+  GL_CHECK_AT(glBufferSubData(target, offset, size, data), caller);
+}
+
+void *GLRenderDevice::mapBufferRange(GLenum target, GLintptr offset,
+                                     GLsizeiptr length, GLbitfield access) {
+  return glMapBufferRange(target, offset, length, access);
+}
+
+void GLRenderDevice::unmapBuffer(GLenum target, GLCaller caller) {
+  GL_CHECK_AT(glUnmapBuffer(target), caller);
+}
+
+void GLRenderDevice::commitMappedRange(GLuint buffer, GLintptr offset,
+                                       GLsizeiptr size) {}
+
+GLsync GLRenderDevice::fenceSync() {
+  return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLenum GLRenderDevice::clientWaitSync(GLsync sync, GLbitfield flags,
+                                      GLuint64 timeout) {
+  return glClientWaitSync(sync, flags, timeout);
+}
+
+void GLRenderDevice::deleteSync(GLsync sync) { glDeleteSync(sync); }
+
+GLuint GLRenderDevice::createVertexArray(GLCaller caller) {
+  GLuint vao = 0;
+  GL_CHECK_AT(glGenVertexArrays(1, &vao), caller);
+  return vao;
+}
+
+void GLRenderDevice::deleteVertexArray(GLuint vao, GLCaller caller) {
+  GL_CHECK_AT(glDeleteVertexArrays(1, &vao), caller);
+}
+
+void GLRenderDevice::bindVertexArray(GLuint vao, GLCaller caller) {
+  GL_CHECK_AT(glBindVertexArray(vao), caller);
+}
+
+void GLRenderDevice::vertexAttribPointer(GLuint index, GLint size, GLenum type,
+                                         GLboolean normalized, GLsizei stride,
+                                         const void *offset, GLCaller caller) {
+  GL_CHECK_AT(
+      glVertexAttribPointer(index, size, type, normalized, stride, offset),
+      caller);
+}
+
+void GLRenderDevice::vertexAttribIPointer(GLuint index, GLint size, GLenum type,
+                                          GLsizei stride, const void *offset,
+                                          GLCaller caller) {
+  GL_CHECK_AT(glVertexAttribIPointer(index, size, type, stride, offset),
+              caller);
+}
+
+void GLRenderDevice::enableVertexAttribArray(GLuint index, GLCaller caller) {
+  GL_CHECK_AT(glEnableVertexAttribArray(index), caller);
+}
+
+void GLRenderDevice::vertexAttribDivisor(GLuint index, GLuint divisor,
+                                         GLCaller caller) {
+  GL_CHECK_AT(glVertexAttribDivisor(index, divisor), caller);
+}
+
+GLuint GLRenderDevice::createTexture(GLCaller caller) {
+  GLuint texture = 0;
+  GL_CHECK_AT(glGenTextures(1, &texture), caller);
+  return texture;
+}
+
+void GLRenderDevice::deleteTexture(GLuint texture, GLCaller caller) {
+  GL_CHECK_AT(glDeleteTextures(1, &texture), caller);
+}
+
+void GLRenderDevice::activeTexture(GLuint unit, GLCaller caller) {
+  GL_CHECK_AT(glActiveTexture(GL_TEXTURE0 + unit), caller);
+}
+
+void GLRenderDevice::bindTexture(GLenum target, GLuint texture,
+                                 GLCaller caller) {
+  GL_CHECK_AT(glBindTexture(target, texture), caller);
+}
+
+void GLRenderDevice::texParameteri(GLenum target, GLenum name, GLint value,
+                                   GLCaller caller) {
+  GL_CHECK_AT(glTexParameteri(target, name, value), caller);
+}
+
+void GLRenderDevice::texImage2D(GLenum target, GLint internalFormat,
+                                GLsizei width, GLsizei height, GLenum format,
+                                GLenum type, const void *pixels,
+                                GLCaller caller) {
+  GL_CHECK_AT(glTexImage2D(target, 0, internalFormat, width, height, 0,
+                           format, type, pixels),
+              caller);
+}
+
+void GLRenderDevice::texSubImage2D(GLenum target, GLint x, GLint y,
+                                   GLsizei width, GLsizei height, GLenum format,
+                                   GLenum type, const void *pixels,
+                                   GLCaller caller) {
+  GL_CHECK_AT(
+      glTexSubImage2D(target, 0, x, y, width, height, format, type, pixels),
+      caller);
+}
+
+void GLRenderDevice::generateMipmap(GLenum target, GLCaller caller) {
+  GL_CHECK_AT(glGenerateMipmap(target), caller);
+}
+
+void GLRenderDevice::pixelStorei(GLenum name, GLint value, GLCaller caller) {
+  GL_CHECK_AT(glPixelStorei(name, value), caller);
+}
+
+void GLRenderDevice::clearTexImage(GLuint texture, GLenum format, GLenum type,
+                                   GLCaller caller) {
+  GL_CHECK_AT(glClearTexImage(texture, 0, format, type, nullptr), caller);
+}
+
+void GLRenderDevice::getTexImage(GLenum target, GLenum format, GLenum type,
+                                 void *pixels, GLCaller caller) {
+  GL_CHECK_AT(glGetTexImage(target, 0, format, type, pixels), caller);
+}
+
+GLuint GLRenderDevice::createProgram(const char *vertexSource,
+                                     const char *fragmentSource) {
+  GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+  GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+
+  GLuint program = glCreateProgram();
+  glAttachShader(program, vertexShader);
+  glAttachShader(program, fragmentShader);
+
+  glLinkProgram(program);
+  printLinkErrors(program);
+
+  glDeleteShader(vertexShader);
+  glDeleteShader(fragmentShader);
+  return program;
+}
+
+void GLRenderDevice::deleteProgram(GLuint program) {
+  glDeleteProgram(program);
+}
+
+void GLRenderDevice::useProgram(GLuint program, GLCaller caller) {
+  GL_CHECK_AT(glUseProgram(program), caller);
+}
+
+void GLRenderDevice::getActiveUniforms(GLuint program,
+                                       std::vector<ShaderUniform> &uniforms) {
+  uniforms.clear();
+
+  GLint linked = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (!linked)
+    return;
+
+  GLint count = 0;
+  GLint maxLength = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+  std::vector<GLchar> name(maxLength > 0 ? maxLength : 1);
+  for (GLint i = 0; i < count; ++i) {
+    ShaderUniform uniform;
+    GLsizei length = 0;
+    glGetActiveUniform(program, static_cast<GLuint>(i), maxLength, &length,
+                       &uniform.size, &uniform.type, name.data());
+    uniform.name.assign(name.data(), length);
+    uniform.location = glGetUniformLocation(program, uniform.name.c_str());
+    uniforms.push_back(std::move(uniform));
+  }
+}
+
+void GLRenderDevice::programUniform1iv(GLuint program, GLint location,
+                                       GLsizei count, const GLint *values,
+                                       GLCaller caller) {
+  GL_CHECK_AT(glProgramUniform1iv(program, location, count, values), caller);
+}
+
+void GLRenderDevice::programUniformMatrix4fv(GLuint program, GLint location,
+                                             GLsizei count, GLboolean transpose,
+                                             const GLfloat *values,
+                                             GLCaller caller) {
+  GL_CHECK_AT(
+      glProgramUniformMatrix4fv(program, location, count, transpose, values),
+      caller);
+}
+
+void GLRenderDevice::clear(GLfloat red, GLfloat green, GLfloat blue,
+                           GLfloat alpha, GLCaller caller) {
+  GL_CHECK_AT(glClearColor(red, green, blue, alpha), caller);
+  GL_CHECK_AT(glClear(GL_COLOR_BUFFER_BIT), caller);
+}
+
+void GLRenderDevice::enable(GLenum capability, GLCaller caller) {
+  GL_CHECK_AT(glEnable(capability), caller);
+}
+
+void GLRenderDevice::disable(GLenum capability, GLCaller caller) {
+  GL_CHECK_AT(glDisable(capability), caller);
+}
+
+void GLRenderDevice::drawElements(GLenum mode, GLsizei count, GLenum type,
+                                  const void *offset, GLint baseVertex,
+                                  GLCaller caller) {
+  GL_CHECK_AT(
+      glDrawElementsBaseVertex(mode, count, type, offset, baseVertex),
+      caller);
+}
+
+void GLRenderDevice::drawArraysInstanced(GLenum mode, GLint first,
+                                         GLsizei count, GLsizei instanceCount,
+                                         GLuint baseInstance, GLCaller caller) {
+  GL_CHECK_AT(glDrawArraysInstancedBaseInstance(mode, first, count,
+                                                instanceCount, baseInstance),
+              caller);
+}
@@ -0,0 +1,132 @@
+#include <jelly/gl_state.h>
+#include <jelly/render_device.h>
+
+namespace {
+
+// Never a valid object name, so the first bind after invalidate() is issued.
+const GLuint UNKNOWN = 0xFFFFFFFF;
+
+struct Bindings {
+  GLuint program = UNKNOWN;
+  GLuint vertexArray = UNKNOWN;
+  GLuint arrayBuffer = UNKNOWN;
+  GLuint elementBuffer = UNKNOWN;
+  GLuint activeUnit = UNKNOWN;
+  GLuint textures[GL_STATE_TEXTURE_UNITS];
+
+  Bindings() {
+    for (GLuint &texture : textures) {
+      texture = UNKNOWN;
+    }
+  }
+};
+
+Bindings g_bindings;
+GLStateStats g_stats;
+
+// Returns true, counting the call as skipped, if current already holds
+// value; otherwise records value and counts the call as issued.
+bool isCurrent(GLuint &current, GLuint value) {
+  if (current == value) {
+    g_stats.skipped++;
+    return true;
+  }
+  current = value;
+  g_stats.issued++;
+  return false;
+}
+
+void forget(GLuint &current, GLuint id) {
+  if (current == id) {
+    current = UNKNOWN;
+  }
+}
+
+} // namespace
+
+void GLState::useProgram(GLuint program, GLCaller caller) {
+  if (!isCurrent(g_bindings.program, program)) {
+    RenderDevice::get().useProgram(program, caller);
+  }
+}
+
+void GLState::bindVertexArray(GLuint vao, GLCaller caller) {
+  if (!isCurrent(g_bindings.vertexArray, vao)) {
+    RenderDevice::get().bindVertexArray(vao, caller);
+    g_bindings.elementBuffer = UNKNOWN;
+  }
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer, GLCaller caller) {
+  GLuint *current = nullptr;
+  if (target == GL_ARRAY_BUFFER) {
+    current = &g_bindings.arrayBuffer;
+  } else if (target == GL_ELEMENT_ARRAY_BUFFER) {
+    current = &g_bindings.elementBuffer;
+  }
+
+  if (current == nullptr) {
+    g_stats.issued++;
+    RenderDevice::get().bindBuffer(target, buffer, caller);
+  } else if (!isCurrent(*current, buffer)) {
+    RenderDevice::get().bindBuffer(target, buffer, caller);
+  }
+}
+
+void GLState::activeTexture(GLuint unit, GLCaller caller) {
+  if (!isCurrent(g_bindings.activeUnit, unit)) {
+    RenderDevice::get().activeTexture(unit, caller);
+  }
+}
+
+void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture,
+                          GLCaller caller) {
+  if (target != GL_TEXTURE_2D || unit >= GL_STATE_TEXTURE_UNITS) {
+    activeTexture(unit, caller);
+    g_stats.issued++;
+    RenderDevice::get().bindTexture(target, texture, caller);
+    return;
+  }
+
+  // Only switch units when the texture actually changes.
+  if (g_bindings.textures[unit] == texture) {
+    g_stats.skipped++;
+    return;
+  }
+  activeTexture(unit, caller);
+  isCurrent(g_bindings.textures[unit], texture);
+  RenderDevice::get().bindTexture(target, texture, caller);
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture, GLCaller caller) {
+  if (g_bindings.activeUnit == UNKNOWN) {
+    activeTexture(0, caller);
+  }
+  bindTexture(g_bindings.activeUnit, target, texture, caller);
+}
+
+void GLState::forgetProgram(GLuint program) {
+  forget(g_bindings.program, program);
+}
+
+void GLState::forgetVertexArray(GLuint vao) {
+  forget(g_bindings.vertexArray, vao);
+  g_bindings.elementBuffer = UNKNOWN;
+}
+
+void GLState::forgetBuffer(GLuint buffer) {
+  forget(g_bindings.arrayBuffer, buffer);
+  forget(g_bindings.elementBuffer, buffer);
+}
+
+void GLState::forgetTexture(GLuint texture) {
+  for (GLuint &current : g_bindings.textures) {
+    forget(current, texture);
+  }
+}
+
+void GLState::invalidate() { g_bindings = Bindings(); }
+
+void GLState::beginFrame() { g_stats = GLStateStats(); }
+
+const GLStateStats &GLState::getFrameStats() { return g_stats; }
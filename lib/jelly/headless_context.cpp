@@ -0,0 +1,193 @@
+#include <iostream>
+
+#include <jelly/headless_context.h>
+#include <jelly/image.h>
+#include <jelly/utils.h>
+
+#ifdef JELLY_HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstring>
+#endif
+
+HeadlessContext::HeadlessContext()
+    : m_display(nullptr), m_context(nullptr), m_surface(nullptr),
+      m_framebuffer(0), m_colorBuffer(0), m_width(0), m_height(0) {}
+
+#ifdef JELLY_HEADLESS_EGL
+
+static EGLDisplay openDisplay() {
+  // The surfaceless platform needs no X or Wayland server at all.
+  const char *extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+  auto getPlatformDisplay =
+      reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+          eglGetProcAddress("eglGetPlatformDisplayEXT"));
+  if (extensions != nullptr && getPlatformDisplay != nullptr &&
+      std::strstr(extensions, "EGL_MESA_platform_surfaceless") != nullptr) {
+    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                            EGL_DEFAULT_DISPLAY, nullptr);
+    if (display != EGL_NO_DISPLAY)
+      return display;
+  }
+  return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+bool HeadlessContext::init(int width, int height) {
+  EGLDisplay display = openDisplay();
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+    std::cerr << "Error: No EGL display available" << std::endl;
+    return false;
+  }
+  m_display = display;
+
+  const EGLint configAttributes[] = {EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+                                     EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                     EGL_NONE};
+  EGLConfig config = nullptr;
+  EGLint configCount = 0;
+  eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+
+  const char *extensions = eglQueryString(display, EGL_EXTENSIONS);
+  bool surfaceless =
+      extensions != nullptr &&
+      std::strstr(extensions, "EGL_KHR_surfaceless_context") != nullptr;
+  bool noConfig = extensions != nullptr &&
+                  std::strstr(extensions, "EGL_KHR_no_config_context") !=
+                      nullptr;
+  if (configCount == 0 && !(surfaceless && noConfig)) {
+    std::cerr << "Error: No EGL config for OpenGL rendering" << std::endl;
+    shutdown();
+    return false;
+  }
+  if (configCount == 0) {
+    config = EGL_NO_CONFIG_KHR;
+  }
+
+  // Renderer2D needs OpenGL 4.5, the newest version llvmpipe provides.
+  const EGLint contextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION,
+                                      4,
+                                      EGL_CONTEXT_MINOR_VERSION,
+                                      5,
+                                      EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                                      EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                                      EGL_NONE};
+  eglBindAPI(EGL_OPENGL_API);
+  EGLContext context =
+      eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+  if (context == EGL_NO_CONTEXT) {
+    std::cerr << "Error: Failed to create an OpenGL 4.5 context through EGL"
+              << std::endl;
+    shutdown();
+    return false;
+  }
+  m_context = context;
+
+  EGLSurface surface = EGL_NO_SURFACE;
+  if (!surfaceless) {
+    // Everything is drawn into the framebuffer object; the pbuffer only
+    // exists to make the context current.
+    const EGLint surfaceAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1,
+                                        EGL_NONE};
+    surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+    if (surface == EGL_NO_SURFACE) {
+      std::cerr << "Error: Failed to create an EGL pbuffer" << std::endl;
+      shutdown();
+      return false;
+    }
+  }
+  m_surface = surface;
+
+  if (!eglMakeCurrent(display, surface, surface, context)) {
+    std::cerr << "Error: Failed to make the EGL context current" << std::endl;
+    shutdown();
+    return false;
+  }
+
+  if (gladLoadGL((GLADloadfunc)eglGetProcAddress) == 0) {
+    std::cerr << "Error: Failed to load OpenGL through EGL" << std::endl;
+    shutdown();
+    return false;
+  }
+
+  m_width = width;
+  m_height = height;
+
+  // Like the window setup in GameContext, these calls are not instrumented:
+  // they happen once, and the completeness check below covers them.
+  glGenRenderbuffers(1, &m_colorBuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+  glGenFramebuffers(1, &m_framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_RENDERBUFFER, m_colorBuffer);
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    std::cerr << "Error: Headless framebuffer is incomplete" << std::endl;
+    shutdown();
+    return false;
+  }
+  glViewport(0, 0, width, height);
+
+  return true;
+}
+
+void HeadlessContext::shutdown() {
+  if (m_display == nullptr)
+    return;
+
+  if (m_context != nullptr) {
+    if (m_framebuffer != 0) {
+      glDeleteFramebuffers(1, &m_framebuffer);
+      glDeleteRenderbuffers(1, &m_colorBuffer);
+      m_framebuffer = 0;
+      m_colorBuffer = 0;
+    }
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                   EGL_NO_CONTEXT);
+    eglDestroyContext(m_display, m_context);
+    m_context = nullptr;
+  }
+  if (m_surface != nullptr && m_surface != EGL_NO_SURFACE) {
+    eglDestroySurface(m_display, m_surface);
+  }
+  m_surface = nullptr;
+
+  eglTerminate(m_display);
+  m_display = nullptr;
+}
+
+#else // JELLY_HEADLESS_EGL
+
+bool HeadlessContext::init(int width, int height) {
+  std::cerr << "Error: Headless rendering needs EGL, which was not found "
+               "when jelly was built"
+            << std::endl;
+  return false;
+}
+
+void HeadlessContext::shutdown() {}
+
+#endif // JELLY_HEADLESS_EGL
+
+bool HeadlessContext::isInitialized() const { return m_framebuffer != 0; }
+
+int HeadlessContext::getWidth() const { return m_width; }
+
+int HeadlessContext::getHeight() const { return m_height; }
+
+GLuint HeadlessContext::getFramebuffer() const { return m_framebuffer; }
+
+void HeadlessContext::readPixels(std::vector<unsigned char> &pixels) const {
+  pixels.resize(static_cast<size_t>(m_width) * m_height * 4);
+  GL_CHECK(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer));
+  GL_CHECK(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+  GL_CHECK(glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE,
+                        pixels.data()));
+  GL_CHECK(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+}
+
+bool HeadlessContext::savePNG(const char *path) const {
+  std::vector<unsigned char> pixels;
+  readPixels(pixels);
+  return write_png(path, m_width, m_height, pixels.data());
+}
@@ -1,12 +1,17 @@
 #define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <jelly/image.h>
+#include <stb_image_write.h>
 #include <iostream>
 
 unsigned char *load_image(const char *path, int &width, int &height,
-                          int &channels) {
-  stbi_set_flip_vertically_on_load(true); // Flip the image for OpenGL
+                          int &channels, int desiredChannels) {
+  // Flip the image for OpenGL. The per-thread setting keeps concurrent
+  // decodes on loader threads from racing on stb_image's global flag.
+  stbi_set_flip_vertically_on_load_thread(true);
 
-  unsigned char *data = stbi_load(path, &width, &height, &channels, 0);
+  unsigned char *data =
+      stbi_load(path, &width, &height, &channels, desiredChannels);
   if (!data) {
     std::cerr << "stb_image failed to load image: " << path << std::endl;
     std::cerr << "Error: " << stbi_failure_reason() << std::endl;
@@ -16,4 +21,19 @@ unsigned char *load_image(const char *path, int &width, int &height,
   return data;
 }
 
-void free_image(unsigned char *data) { stbi_image_free(data); }
\ No newline at end of file
+void free_image(unsigned char *data) { stbi_image_free(data); }
+
+bool write_png(const char *path, int width, int height,
+               const unsigned char *pixels) {
+  // Rows arrive bottom first, as load_image returns them and glReadPixels
+  // reads them.
+  stbi_flip_vertically_on_write(true);
+  int written = stbi_write_png(path, width, height, 4, pixels, width * 4);
+  stbi_flip_vertically_on_write(false);
+
+  if (!written) {
+    std::cerr << "Error: Failed to write image: " << path << std::endl;
+    return false;
+  }
+  return true;
+}
\ No newline at end of file
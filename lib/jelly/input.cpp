@@ -0,0 +1,216 @@
+#include <iostream>
+
+#include <jelly/input.h>
+
+namespace {
+
+// GLFW callbacks carry no context besides the window user pointer, which
+// WindowEvents owns, and joystick callbacks not even that.
+std::atomic<Input *> g_attached{nullptr};
+
+void pushAttached(const InputEvent &event) {
+  Input *input = g_attached.load(std::memory_order_relaxed);
+  if (input != nullptr) {
+    input->push(event);
+  }
+}
+
+} // namespace
+
+Input::Input() : m_window(nullptr), m_overflowed(false), m_releaseAll(false),
+                 m_published(0) {}
+
+Input::~Input() {
+  Input *self = this;
+  g_attached.compare_exchange_strong(self, nullptr);
+}
+
+void Input::attach(GLFWwindow *window) {
+  m_window = window;
+  g_attached.store(this);
+
+  glfwSetKeyCallback(window, onKey);
+  glfwSetMouseButtonCallback(window, onMouseButton);
+  glfwSetCursorPosCallback(window, onCursorPos);
+  glfwSetScrollCallback(window, onScroll);
+  glfwSetJoystickCallback(onJoystick);
+
+  // Nothing is down yet, but the cursor and gamepads start somewhere.
+  InputSnapshot &snapshot = m_snapshots[m_published.load()];
+  glfwGetCursorPos(window, &snapshot.mouseX, &snapshot.mouseY);
+  for (size_t i = 0; i < GAMEPAD_COUNT; ++i) {
+    snapshot.gamepads[i].connected =
+        glfwJoystickIsGamepad(static_cast<int>(i)) == GLFW_TRUE;
+  }
+}
+
+bool Input::push(const InputEvent &event) {
+  if (!m_queue.push(event)) {
+    m_overflowed.store(true, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+void Input::releaseAll() { m_releaseAll = true; }
+
+void Input::apply(InputSnapshot &snapshot, const InputEvent &event) {
+  switch (event.type) {
+  case InputEventType::Key:
+    // Repeats keep the key down and are not new presses.
+    if (!InputSnapshot::validKey(event.code) || event.action == GLFW_REPEAT)
+      return;
+    if (event.action == GLFW_PRESS) {
+      snapshot.keys.set(event.code);
+      snapshot.pressedKeys.set(event.code);
+    } else {
+      snapshot.keys.reset(event.code);
+      snapshot.releasedKeys.set(event.code);
+    }
+    return;
+  case InputEventType::MouseButton:
+    if (!InputSnapshot::validMouseButton(event.code))
+      return;
+    if (event.action == GLFW_PRESS) {
+      snapshot.mouseButtons.set(event.code);
+      snapshot.pressedMouseButtons.set(event.code);
+    } else {
+      snapshot.mouseButtons.reset(event.code);
+      snapshot.releasedMouseButtons.set(event.code);
+    }
+    return;
+  case InputEventType::CursorPos:
+    snapshot.mouseX = event.x;
+    snapshot.mouseY = event.y;
+    return;
+  case InputEventType::Scroll:
+    snapshot.scrollX += event.x;
+    snapshot.scrollY += event.y;
+    return;
+  case InputEventType::GamepadConnection:
+    if (event.code >= 0 && static_cast<size_t>(event.code) < GAMEPAD_COUNT) {
+      // Joysticks without a gamepad mapping stay disconnected.
+      snapshot.gamepads[event.code].connected =
+          event.action == GLFW_CONNECTED &&
+          glfwJoystickIsGamepad(event.code) == GLFW_TRUE;
+    }
+    return;
+  }
+}
+
+void Input::resync(InputSnapshot &snapshot) {
+  std::cerr << "Error: Input event queue overflowed; querying the keys "
+               "and buttons instead"
+            << std::endl;
+
+  // Key codes below the first named key, GLFW_KEY_SPACE, are unused.
+  for (int key = GLFW_KEY_SPACE; key <= GLFW_KEY_LAST; ++key) {
+    bool down = glfwGetKey(m_window, key) == GLFW_PRESS;
+    if (down != snapshot.keys[key]) {
+      snapshot.keys[key] = down;
+      (down ? snapshot.pressedKeys : snapshot.releasedKeys).set(key);
+    }
+  }
+  for (int button = 0; button <= GLFW_MOUSE_BUTTON_LAST; ++button) {
+    bool down = glfwGetMouseButton(m_window, button) == GLFW_PRESS;
+    if (down != snapshot.mouseButtons[button]) {
+      snapshot.mouseButtons[button] = down;
+      (down ? snapshot.pressedMouseButtons : snapshot.releasedMouseButtons)
+          .set(button);
+    }
+  }
+  glfwGetCursorPos(m_window, &snapshot.mouseX, &snapshot.mouseY);
+}
+
+void Input::readGamepads(InputSnapshot &snapshot,
+                         const InputSnapshot &previous) const {
+  for (size_t i = 0; i < GAMEPAD_COUNT; ++i) {
+    GamepadSnapshot &gamepad = snapshot.gamepads[i];
+    GLFWgamepadstate state;
+    if (!gamepad.connected ||
+        glfwGetGamepadState(static_cast<int>(i), &state) != GLFW_TRUE) {
+      gamepad.buttons.reset();
+      gamepad.axes.fill(0.0f);
+    } else {
+      for (size_t button = 0; button < GAMEPAD_BUTTON_COUNT; ++button) {
+        gamepad.buttons[button] = state.buttons[button] == GLFW_PRESS;
+      }
+      for (size_t axis = 0; axis < GAMEPAD_AXIS_COUNT; ++axis) {
+        gamepad.axes[axis] = state.axes[axis];
+      }
+    }
+
+    // Gamepads are sampled, so only changes between samples are edges.
+    const std::bitset<GAMEPAD_BUTTON_COUNT> &before =
+        previous.gamepads[i].buttons;
+    gamepad.pressed = gamepad.buttons & ~before;
+    gamepad.released = before & ~gamepad.buttons;
+  }
+}
+
+void Input::update() {
+  size_t published = m_published.load(std::memory_order_relaxed);
+  const InputSnapshot &previous = m_snapshots[published];
+  size_t next = (published + 1) % m_snapshots.size();
+  InputSnapshot &snapshot = m_snapshots[next];
+
+  // Held keys, the cursor and connections carry over; edges and motion
+  // start again.
+  snapshot = previous;
+  snapshot.frame = previous.frame + 1;
+  snapshot.previousKeys = previous.keys;
+  snapshot.pressedKeys.reset();
+  snapshot.releasedKeys.reset();
+  snapshot.pressedMouseButtons.reset();
+  snapshot.releasedMouseButtons.reset();
+  snapshot.scrollX = 0.0;
+  snapshot.scrollY = 0.0;
+
+  InputEvent event;
+  while (m_queue.pop(event)) {
+    apply(snapshot, event);
+  }
+  if (m_overflowed.exchange(false, std::memory_order_relaxed) &&
+      m_window != nullptr) {
+    resync(snapshot);
+  }
+  if (m_releaseAll) {
+    m_releaseAll = false;
+    snapshot.releasedKeys |= snapshot.keys;
+    snapshot.keys.reset();
+    snapshot.releasedMouseButtons |= snapshot.mouseButtons;
+    snapshot.mouseButtons.reset();
+  }
+  readGamepads(snapshot, previous);
+
+  snapshot.mouseDeltaX = snapshot.mouseX - previous.mouseX;
+  snapshot.mouseDeltaY = snapshot.mouseY - previous.mouseY;
+
+  m_published.store(next, std::memory_order_release);
+}
+
+const InputSnapshot &Input::getSnapshot() const {
+  return m_snapshots[m_published.load(std::memory_order_acquire)];
+}
+
+void Input::onKey(GLFWwindow *window, int key, int scancode, int action,
+                  int mods) {
+  pushAttached({InputEventType::Key, key, action});
+}
+
+void Input::onMouseButton(GLFWwindow *window, int button, int action,
+                          int mods) {
+  pushAttached({InputEventType::MouseButton, button, action});
+}
+
+void Input::onCursorPos(GLFWwindow *window, double x, double y) {
+  pushAttached({InputEventType::CursorPos, 0, 0, x, y});
+}
+
+void Input::onScroll(GLFWwindow *window, double x, double y) {
+  pushAttached({InputEventType::Scroll, 0, 0, x, y});
+}
+
+void Input::onJoystick(int joystick, int event) {
+  pushAttached({InputEventType::GamepadConnection, joystick, event});
+}
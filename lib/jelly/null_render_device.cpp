@@ -0,0 +1,323 @@
+#include <cstdint>
+#include <cstring>
+
+#include <jelly/null_render_device.h>
+#include <jelly/shader.h>
+
+namespace {
+
+size_t pixelSize(GLenum format, GLenum type) {
+  size_t channels = 4;
+  switch (format) {
+  case GL_RED:
+    channels = 1;
+    break;
+  case GL_RG:
+    channels = 2;
+    break;
+  case GL_RGB:
+  case GL_BGR:
+    channels = 3;
+    break;
+  default:
+    break;
+  }
+
+  switch (type) {
+  case GL_UNSIGNED_SHORT:
+  case GL_SHORT:
+  case GL_HALF_FLOAT:
+    return channels * 2;
+  case GL_UNSIGNED_INT:
+  case GL_INT:
+  case GL_FLOAT:
+    return channels * 4;
+  default:
+    return channels;
+  }
+}
+
+} // namespace
+
+NullRenderDevice::NullRenderDevice()
+    : m_nextObject(0), m_arrayBuffer(0), m_elementBuffer(0),
+      m_unpackBuffer(0), m_activeUnit(0), m_logging(true) {}
+
+const std::vector<DeviceCommand> &NullRenderDevice::getLog() const {
+  return m_log;
+}
+
+const RenderDeviceStats &NullRenderDevice::getStats() const {
+  return m_stats;
+}
+
+void NullRenderDevice::setLogging(bool enabled) { m_logging = enabled; }
+
+void NullRenderDevice::reset() {
+  m_log.clear();
+  m_stats = RenderDeviceStats();
+}
+
+GLuint &NullRenderDevice::boundBuffer(GLenum target) {
+  // Other targets are never cached by GLState; treat them as the array
+  // buffer, which is only used to attribute uploads.
+  switch (target) {
+  case GL_ELEMENT_ARRAY_BUFFER:
+    return m_elementBuffer;
+  case GL_PIXEL_UNPACK_BUFFER:
+    return m_unpackBuffer;
+  default:
+    return m_arrayBuffer;
+  }
+}
+
+GLuint NullRenderDevice::boundTexture() const {
+  return m_activeUnit < m_textures.size() ? m_textures[m_activeUnit] : 0;
+}
+
+void NullRenderDevice::record(DeviceCommandType type, GLenum target,
+                              GLuint object, size_t bytes, size_t count,
+                              size_t instances) {
+  switch (type) {
+  case DeviceCommandType::Upload:
+    m_stats.uploads++;
+    m_stats.bytesUploaded += bytes;
+    break;
+  case DeviceCommandType::Draw:
+    m_stats.drawCalls++;
+    m_stats.elementsDrawn += count * instances;
+    break;
+  case DeviceCommandType::Clear:
+    break;
+  default:
+    m_stats.stateChanges++;
+    break;
+  }
+
+  if (m_logging) {
+    m_log.push_back({type, target, object, bytes, count, instances});
+  }
+}
+
+GLuint NullRenderDevice::createBuffer(GLCaller caller) {
+  GLuint buffer = ++m_nextObject;
+  m_buffers[buffer] = Buffer();
+  return buffer;
+}
+
+void NullRenderDevice::deleteBuffer(GLuint buffer, GLCaller caller) {
+  m_buffers.erase(buffer);
+  if (m_arrayBuffer == buffer)
+    m_arrayBuffer = 0;
+  if (m_elementBuffer == buffer)
+    m_elementBuffer = 0;
+  if (m_unpackBuffer == buffer)
+    m_unpackBuffer = 0;
+}
+
+void NullRenderDevice::bindBuffer(GLenum target, GLuint buffer,
+                                  GLCaller caller) {
+  boundBuffer(target) = buffer;
+  record(DeviceCommandType::BindBuffer, target, buffer);
+}
+
+void NullRenderDevice::bufferData(GLenum target, GLsizeiptr size,
+                                  const void *data, GLenum usage,
+                                  GLCaller caller) {
+  GLuint buffer = boundBuffer(target);
+  m_buffers[buffer].size = size;
+  if (data != nullptr) {
+    record(DeviceCommandType::Upload, target, buffer, size);
+  }
+}
+
+void NullRenderDevice::bufferStorage(GLenum target, GLsizeiptr size,
+                                     const void *data, GLbitfield flags,
+                                     GLCaller caller) {
+  bufferData(target, size, data, 0);
+}
+
+void NullRenderDevice::bufferSubData(GLenum target, GLintptr offset,
+                                     GLsizeiptr size, const void *data,
+                                     GLCaller caller) {
+  record(DeviceCommandType::Upload, target, boundBuffer(target), size);
+}
+
+void *NullRenderDevice::mapBufferRange(GLenum target, GLintptr offset,
+                                       GLsizeiptr length, GLbitfield access) {
+  Buffer &buffer = m_buffers[boundBuffer(target)];
+  if (offset + length > buffer.size)
+    return nullptr;
+
+  buffer.mapping.resize(buffer.size);
+  return buffer.mapping.data() + offset;
+}
+
+void NullRenderDevice::unmapBuffer(GLenum target, GLCaller caller) {
+  Buffer &buffer = m_buffers[boundBuffer(target)];
+  buffer.mapping.clear();
+  buffer.mapping.shrink_to_fit();
+}
+
+void NullRenderDevice::commitMappedRange(GLuint buffer, GLintptr offset,
+                                         GLsizeiptr size) {
+  record(DeviceCommandType::Upload, 0, buffer, size);
+}
+
+GLsync NullRenderDevice::fenceSync() {
+  // Never dereferenced; it only has to be non-null.
+  return reinterpret_cast<GLsync>(static_cast<uintptr_t>(++m_nextObject));
+}
+
+GLenum NullRenderDevice::clientWaitSync(GLsync sync, GLbitfield flags,
+                                        GLuint64 timeout) {
+  return GL_ALREADY_SIGNALED;
+}
+
+void NullRenderDevice::deleteSync(GLsync sync) {}
+
+GLuint NullRenderDevice::createVertexArray(GLCaller caller) {
+  return ++m_nextObject;
+}
+
+void NullRenderDevice::deleteVertexArray(GLuint vao, GLCaller caller) {}
+
+void NullRenderDevice::bindVertexArray(GLuint vao, GLCaller caller) {
+  record(DeviceCommandType::BindVertexArray, 0, vao);
+}
+
+void NullRenderDevice::vertexAttribPointer(GLuint index, GLint size,
+                                           GLenum type, GLboolean normalized,
+                                           GLsizei stride, const void *offset,
+                                           GLCaller caller) {}
+
+void NullRenderDevice::vertexAttribIPointer(GLuint index, GLint size,
+                                            GLenum type, GLsizei stride,
+                                            const void *offset,
+                                            GLCaller caller) {}
+
+void NullRenderDevice::enableVertexAttribArray(GLuint index, GLCaller caller) {}
+
+void NullRenderDevice::vertexAttribDivisor(GLuint index, GLuint divisor,
+                                           GLCaller caller) {}
+
+GLuint NullRenderDevice::createTexture(GLCaller caller) {
+  return ++m_nextObject;
+}
+
+void NullRenderDevice::deleteTexture(GLuint texture, GLCaller caller) {
+  m_textureSizes.erase(texture);
+  for (GLuint &bound : m_textures) {
+    if (bound == texture)
+      bound = 0;
+  }
+}
+
+void NullRenderDevice::activeTexture(GLuint unit, GLCaller caller) {
+  m_activeUnit = unit;
+  record(DeviceCommandType::ActiveTexture, 0, unit);
+}
+
+void NullRenderDevice::bindTexture(GLenum target, GLuint texture,
+                                   GLCaller caller) {
+  if (m_activeUnit >= m_textures.size()) {
+    m_textures.resize(m_activeUnit + 1, 0);
+  }
+  m_textures[m_activeUnit] = texture;
+  record(DeviceCommandType::BindTexture, target, texture);
+}
+
+void NullRenderDevice::texParameteri(GLenum target, GLenum name, GLint value,
+                                     GLCaller caller) {}
+
+void NullRenderDevice::texImage2D(GLenum target, GLint internalFormat,
+                                  GLsizei width, GLsizei height, GLenum format,
+                                  GLenum type, const void *pixels,
+                                  GLCaller caller) {
+  m_textureSizes[boundTexture()] = static_cast<size_t>(width) * height;
+  if (pixels != nullptr || m_unpackBuffer != 0) {
+    texSubImage2D(target, 0, 0, width, height, format, type, pixels);
+  }
+}
+
+void NullRenderDevice::texSubImage2D(GLenum target, GLint x, GLint y,
+                                     GLsizei width, GLsizei height,
+                                     GLenum format, GLenum type,
+                                     const void *pixels, GLCaller caller) {
+  // From a pixel unpack buffer the bytes were counted when the buffer was
+  // written.
+  if (m_unpackBuffer != 0)
+    return;
+
+  record(DeviceCommandType::Upload, target, boundTexture(),
+         static_cast<size_t>(width) * height * pixelSize(format, type));
+}
+
+void NullRenderDevice::generateMipmap(GLenum target, GLCaller caller) {}
+
+void NullRenderDevice::pixelStorei(GLenum name, GLint value, GLCaller caller) {}
+
+void NullRenderDevice::clearTexImage(GLuint texture, GLenum format,
+                                     GLenum type, GLCaller caller) {}
+
+void NullRenderDevice::getTexImage(GLenum target, GLenum format, GLenum type,
+                                   void *pixels, GLCaller caller) {
+  // Texture contents are not kept, so every texel reads back as zero.
+  auto size = m_textureSizes.find(boundTexture());
+  if (size != m_textureSizes.end()) {
+    std::memset(pixels, 0, size->second * pixelSize(format, type));
+  }
+}
+
+GLuint NullRenderDevice::createProgram(const char *vertexSource,
+                                       const char *fragmentSource) {
+  return ++m_nextObject;
+}
+
+void NullRenderDevice::deleteProgram(GLuint program) {}
+
+void NullRenderDevice::useProgram(GLuint program, GLCaller caller) {
+  record(DeviceCommandType::UseProgram, 0, program);
+}
+
+void NullRenderDevice::getActiveUniforms(
+    GLuint program, std::vector<ShaderUniform> &uniforms) {
+  uniforms.clear();
+}
+
+void NullRenderDevice::programUniform1iv(GLuint program, GLint location,
+                                         GLsizei count, const GLint *values,
+                                         GLCaller caller) {
+}
+
+void NullRenderDevice::programUniformMatrix4fv(GLuint program, GLint location,
+                                               GLsizei count,
+                                               GLboolean transpose,
+                                               const GLfloat *values,
+                                               GLCaller caller) {}
+
+void NullRenderDevice::clear(GLfloat red, GLfloat green, GLfloat blue,
+                             GLfloat alpha, GLCaller caller) {
+  record(DeviceCommandType::Clear, GL_COLOR_BUFFER_BIT, 0);
+}
+
+void NullRenderDevice::enable(GLenum capability, GLCaller caller) {
+  record(DeviceCommandType::Enable, capability, 0);
+}
+
+void NullRenderDevice::disable(GLenum capability, GLCaller caller) {
+  record(DeviceCommandType::Disable, capability, 0);
+}
+
+void NullRenderDevice::drawElements(GLenum mode, GLsizei count, GLenum type,
+                                    const void *offset, GLint baseVertex,
+                                    GLCaller caller) {
+  record(DeviceCommandType::Draw, mode, 0, 0, count, 1);
+}
+
+void NullRenderDevice::drawArraysInstanced(GLenum mode, GLint first,
+                                           GLsizei count, GLsizei instanceCount,
+                                           GLuint baseInstance,
+                                           GLCaller caller) {
+  record(DeviceCommandType::Draw, mode, 0, 0, count, instanceCount);
+}
@@ -0,0 +1,245 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <jelly/profiler.h>
+
+namespace {
+
+struct ThreadProfile {
+  ProfileRing ring;
+  uint32_t index = 0;
+  std::atomic<const char *> name{nullptr};
+  std::atomic<bool> exited{false};
+};
+
+// Threads register once, on their first zone. A thread's ring outlives it
+// until its zones are collected, and then waits in spare for the next new
+// thread, so short-lived threads do not each keep a ring.
+struct ProfilerState {
+  std::mutex mutex; // Guards everything below
+  std::vector<std::unique_ptr<ThreadProfile>> threads;
+  std::vector<std::unique_ptr<ThreadProfile>> spare;
+  std::vector<std::pair<uint32_t, const char *>> exitedNames;
+  uint32_t nextIndex = 0;
+  std::vector<ProfileEvent> drained;
+  std::deque<ProfileEvent> events; // At most PROFILER_EVENT_CAPACITY
+  size_t discarded = 0;
+};
+
+ProfilerState &state() {
+  static ProfilerState profiler;
+  return profiler;
+}
+
+// Marks the thread's ring for recycling when the thread exits.
+struct ThreadExit {
+  ThreadProfile *profile = nullptr;
+  ~ThreadExit() {
+    if (profile != nullptr)
+      profile->exited.store(true, std::memory_order_release);
+  }
+};
+
+ThreadProfile &threadProfile() {
+  thread_local ThreadProfile *profile = nullptr;
+  thread_local ThreadExit guard;
+  if (profile == nullptr) {
+    ProfilerState &profiler = state();
+    std::lock_guard<std::mutex> lock(profiler.mutex);
+    if (profiler.spare.empty()) {
+      profiler.threads.push_back(std::make_unique<ThreadProfile>());
+    } else {
+      profiler.threads.push_back(std::move(profiler.spare.back()));
+      profiler.spare.pop_back();
+    }
+    profile = profiler.threads.back().get();
+    profile->index = profiler.nextIndex++;
+    profile->name.store(nullptr, std::memory_order_relaxed);
+    profile->exited.store(false, std::memory_order_relaxed);
+    guard.profile = profile;
+  }
+  return *profile;
+}
+
+void collectLocked(ProfilerState &profiler) {
+  for (size_t i = 0; i < profiler.threads.size();) {
+    ThreadProfile &thread = *profiler.threads[i];
+    // Read before draining: once the flag is seen, every zone of the thread
+    // is in the ring.
+    bool exited = thread.exited.load(std::memory_order_acquire);
+    thread.ring.drain(profiler.drained);
+    if (!exited) {
+      ++i;
+      continue;
+    }
+
+    const char *name = thread.name.load(std::memory_order_relaxed);
+    if (name != nullptr)
+      profiler.exitedNames.emplace_back(thread.index, name);
+    profiler.spare.push_back(std::move(profiler.threads[i]));
+    profiler.threads.erase(profiler.threads.begin() + i);
+  }
+
+  profiler.events.insert(profiler.events.end(), profiler.drained.begin(),
+                         profiler.drained.end());
+  profiler.drained.clear();
+  if (profiler.events.size() > PROFILER_EVENT_CAPACITY) {
+    size_t excess = profiler.events.size() - PROFILER_EVENT_CAPACITY;
+    profiler.events.erase(profiler.events.begin(),
+                          profiler.events.begin() + excess);
+    profiler.discarded += excess;
+  }
+}
+
+void writeEscaped(FILE *file, const char *text) {
+  for (; *text != '\0'; ++text) {
+    if (*text == '"' || *text == '\\') {
+      fputc('\\', file);
+    }
+    fputc(*text, file);
+  }
+}
+
+} // namespace
+
+ProfileRing::ProfileRing() : m_head(0), m_tail(0), m_dropped(0) {}
+
+bool ProfileRing::push(const ProfileEvent &event) {
+  size_t head = m_head.load(std::memory_order_relaxed);
+  if (head - m_tail.load(std::memory_order_acquire) ==
+      PROFILER_RING_CAPACITY) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  m_events[head % PROFILER_RING_CAPACITY] = event;
+  m_head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+void ProfileRing::drain(std::vector<ProfileEvent> &events) {
+  size_t tail = m_tail.load(std::memory_order_relaxed);
+  size_t head = m_head.load(std::memory_order_acquire);
+  for (; tail != head; ++tail) {
+    events.push_back(m_events[tail % PROFILER_RING_CAPACITY]);
+  }
+  m_tail.store(tail, std::memory_order_release);
+}
+
+size_t ProfileRing::getDroppedCount() const {
+  return m_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now() {
+  using Clock = std::chrono::steady_clock;
+  static const Clock::time_point epoch = Clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                              epoch)
+      .count();
+}
+
+void Profiler::record(const char *name, uint64_t start, uint64_t end) {
+  ThreadProfile &profile = threadProfile();
+  profile.ring.push({name, start, end, profile.index});
+}
+
+void Profiler::setThreadName(const char *name) {
+  threadProfile().name.store(name, std::memory_order_relaxed);
+}
+
+void Profiler::collect() {
+  ProfilerState &profiler = state();
+  std::lock_guard<std::mutex> lock(profiler.mutex);
+  collectLocked(profiler);
+}
+
+const std::deque<ProfileEvent> &Profiler::getEvents() {
+  return state().events;
+}
+
+size_t Profiler::getDroppedCount() {
+  ProfilerState &profiler = state();
+  std::lock_guard<std::mutex> lock(profiler.mutex);
+  size_t dropped = 0;
+  for (const std::unique_ptr<ThreadProfile> &thread : profiler.threads) {
+    dropped += thread->ring.getDroppedCount();
+  }
+  for (const std::unique_ptr<ThreadProfile> &thread : profiler.spare) {
+    dropped += thread->ring.getDroppedCount();
+  }
+  return dropped;
+}
+
+size_t Profiler::getDiscardedCount() {
+  ProfilerState &profiler = state();
+  std::lock_guard<std::mutex> lock(profiler.mutex);
+  return profiler.discarded;
+}
+
+size_t Profiler::getRingCount() {
+  ProfilerState &profiler = state();
+  std::lock_guard<std::mutex> lock(profiler.mutex);
+  return profiler.threads.size() + profiler.spare.size();
+}
+
+void Profiler::clear() {
+  ProfilerState &profiler = state();
+  std::lock_guard<std::mutex> lock(profiler.mutex);
+  collectLocked(profiler);
+  profiler.events.clear();
+}
+
+bool Profiler::writeChromeTrace(const char *path) {
+  ProfilerState &profiler = state();
+  std::lock_guard<std::mutex> lock(profiler.mutex);
+  collectLocked(profiler);
+
+  FILE *file = fopen(path, "w");
+  if (file == nullptr) {
+    fprintf(stderr, "Error: Unable to open file for writing: %s\n", path);
+    return false;
+  }
+
+  // Complete ("X") events take microseconds; the fractional part keeps the
+  // nanosecond resolution.
+  fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+  std::vector<std::pair<uint32_t, const char *>> names =
+      profiler.exitedNames;
+  for (const std::unique_ptr<ThreadProfile> &thread : profiler.threads) {
+    const char *name = thread->name.load(std::memory_order_relaxed);
+    if (name != nullptr)
+      names.emplace_back(thread->index, name);
+  }
+
+  const char *separator = "\n";
+  for (const auto &[index, name] : names) {
+    fprintf(file,
+            "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+            "\"tid\": %u, \"args\": {\"name\": \"",
+            separator, index);
+    writeEscaped(file, name);
+    fprintf(file, "\"}}");
+    separator = ",\n";
+  }
+  for (const ProfileEvent &event : profiler.events) {
+    fprintf(file, "%s{\"name\": \"", separator);
+    writeEscaped(file, event.name);
+    fprintf(file,
+            "\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, "
+            "\"dur\": %.3f}",
+            event.thread, event.start / 1000.0,
+            (event.end - event.start) / 1000.0);
+    separator = ",\n";
+  }
+  fprintf(file, "\n]}\n");
+
+  bool ok = ferror(file) == 0;
+  fclose(file);
+  if (!ok) {
+    fprintf(stderr, "Error: Failed to write data to file: %s\n", path);
+  }
+  return ok;
+}
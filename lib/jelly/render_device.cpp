@@ -0,0 +1,17 @@
+#include <jelly/gl_render_device.h>
+#include <jelly/gl_state.h>
+#include <jelly/render_device.h>
+
+namespace {
+
+GLRenderDevice g_glDevice;
+RenderDevice *g_device = &g_glDevice;
+
+} // namespace
+
+RenderDevice &RenderDevice::get() { return *g_device; }
+
+void RenderDevice::set(RenderDevice *device) {
+  g_device = device != nullptr ? device : &g_glDevice;
+  GLState::invalidate();
+}
@@ -0,0 +1,77 @@
+#include <cstring>
+#include <utility>
+
+#include <jelly/render_queue.h>
+
+uint32_t layerSortBits(float layer) {
+  uint32_t bits;
+  std::memcpy(&bits, &layer, sizeof(bits));
+
+  // Flip all bits of negatives and the sign bit of positives so the unsigned
+  // order matches the float order.
+  return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+uint64_t makeSortKey(float layer, uint32_t pipeline, uint32_t mode,
+                     uint32_t texture) {
+  return static_cast<uint64_t>(layerSortBits(layer)) << 32 |
+         static_cast<uint64_t>(pipeline & 0xF) << 28 |
+         static_cast<uint64_t>(mode & 0xF) << 24 |
+         static_cast<uint64_t>(texture & 0xFFFFFF);
+}
+
+void RenderQueue::push(uint64_t key, RenderCommandType type, uint32_t index) {
+  m_commands.push_back({key, index, type});
+}
+
+void RenderQueue::sort() {
+  size_t count = m_commands.size();
+  if (count < 2)
+    return;
+
+  // Build the histograms of all eight key bytes in a single pass.
+  size_t histograms[8][256] = {};
+  for (const RenderCommand &command : m_commands) {
+    for (int pass = 0; pass < 8; ++pass) {
+      ++histograms[pass][(command.key >> (pass * 8)) & 0xFF];
+    }
+  }
+
+  m_scratch.resize(count);
+  RenderCommand *source = m_commands.data();
+  RenderCommand *destination = m_scratch.data();
+
+  for (int pass = 0; pass < 8; ++pass) {
+    size_t *histogram = histograms[pass];
+
+    // Every key has the same byte here, so this pass would not move anything.
+    if (histogram[(source[0].key >> (pass * 8)) & 0xFF] == count)
+      continue;
+
+    size_t offset = 0;
+    for (int bucket = 0; bucket < 256; ++bucket) {
+      size_t bucketCount = histogram[bucket];
+      histogram[bucket] = offset;
+      offset += bucketCount;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      size_t bucket = (source[i].key >> (pass * 8)) & 0xFF;
+      destination[histogram[bucket]++] = source[i];
+    }
+
+    std::swap(source, destination);
+  }
+
+  if (source != m_commands.data()) {
+    m_commands.swap(m_scratch);
+  }
+}
+
+void RenderQueue::clear() { m_commands.clear(); }
+
+const std::vector<RenderCommand> &RenderQueue::getCommands() const {
+  return m_commands;
+}
+
+bool RenderQueue::empty() const { return m_commands.empty(); }
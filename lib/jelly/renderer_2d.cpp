@@ -1,7 +1,17 @@
+#include <algorithm>
+#include <cmath>
+
+#include <jelly/gl_state.h>
+#include <jelly/profiler.h>
+#include <jelly/render_device.h>
 #include <jelly/renderer_2d.h>
 
 Renderer2D::Renderer2D(int windowWidth, int windowHeight, float scale)
     : m_windowWidth(windowWidth), m_windowHeight(windowHeight), m_scale(scale),
+      m_debugMode(false), m_spritePipeline(SpritePipeline::Batched),
+      m_sortMode(RenderSortMode::Immediate), m_culling(true),
+      m_viewBounds{0.0f, 0.0f, static_cast<float>(windowWidth),
+                   static_cast<float>(windowHeight)},
       m_projection(Mat4<float>::ortho(0.0f, static_cast<float>(windowWidth),
                                       static_cast<float>(windowHeight), 0.0f,
                                       -1.0f, 1.0f)) {}
@@ -14,6 +24,9 @@ void Renderer2D::init() {
   initQuadShaders();
   initQuadBuffers();
 
+  initInstanceShaders();
+  initInstanceBuffers();
+
   initCircleShaders();
   initCircleBuffers();
 
@@ -21,229 +34,694 @@ void Renderer2D::init() {
 }
 
 void Renderer2D::initQuadShaders() {
-  m_quadShader.Compile(quad_vertex_shader, quad_fragment_shader);
-  m_quadShader.Activate();
-  GLuint projectionLoc =
-      glGetUniformLocation(m_quadShader.GetID(), "projection");
-  glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, m_projection.value_ptr());
+  m_quadShader.Compile(VertexFormat<BatchQuadVertex>::vertexShader,
+                       VertexFormat<BatchQuadVertex>::fragmentShader);
+  uploadProjection(m_quadShader);
 }
 
 void Renderer2D::initQuadBuffers() {
   m_quadVao.Init();
-  m_quadVbo.Init(nullptr, MAX_BATCH_SIZE * 4 * sizeof(QuadVertex));
-  m_quadEbo.Init(nullptr, MAX_BATCH_SIZE * 6 * sizeof(GLuint));
+  m_quadVbo.InitStreaming(MAX_BATCH_SIZE * 4 * sizeof(BatchQuadVertex));
+
+  // Every quad uses the same index pattern, so one immutable buffer serves
+  // all batches: triangles for filled quads, then restart-separated line
+  // loops for outlines.
+  std::vector<QuadIndex> indices;
+  indices.reserve(MAX_BATCH_SIZE * (6 + 5));
+  for (size_t i = 0; i < MAX_BATCH_SIZE; ++i) {
+    QuadIndex base = static_cast<QuadIndex>(i * 4);
+    indices.insert(indices.end(), {base, QuadIndex(base + 1),
+                                   QuadIndex(base + 2), base,
+                                   QuadIndex(base + 2), QuadIndex(base + 3)});
+  }
+  for (size_t i = 0; i < MAX_BATCH_SIZE; ++i) {
+    QuadIndex base = static_cast<QuadIndex>(i * 4);
+    indices.insert(indices.end(),
+                   {base, QuadIndex(base + 1), QuadIndex(base + 2),
+                    QuadIndex(base + 3), QuadIndex(0xFFFF)});
+  }
+  m_quadEbo.InitStatic(indices.data(), indices.size() * sizeof(QuadIndex));
 
   m_quadVao.Bind();
   m_quadVbo.Bind();
   m_quadEbo.Bind();
 
-  m_quadVao.LinkAttrib(m_quadVbo, 0, 2, GL_FLOAT, sizeof(QuadVertex),
-                       (void *)offsetof(QuadVertex, position));
-  m_quadVao.LinkAttrib(m_quadVbo, 1, 2, GL_FLOAT, sizeof(QuadVertex),
-                       (void *)offsetof(QuadVertex, uv));
-  m_quadVao.LinkAttrib(m_quadVbo, 2, 4, GL_FLOAT, sizeof(QuadVertex),
-                       (void *)offsetof(QuadVertex, color));
-  m_quadVao.LinkAttrib(m_quadVbo, 3, 1, GL_FLOAT, sizeof(QuadVertex),
-                       (void *)offsetof(QuadVertex, textureIndex));
+  VertexFormat<BatchQuadVertex>::link(m_quadVao, m_quadVbo);
 
   m_quadVao.Unbind();
 }
 
+void Renderer2D::initInstanceShaders() {
+  m_instanceShader.Compile(sprite_instance_vertex_shader, quad_fragment_shader);
+  uploadProjection(m_instanceShader);
+}
+
+void Renderer2D::initInstanceBuffers() {
+  m_instanceVao.Init();
+  m_instanceVbo.InitStreaming(MAX_INSTANCE_BATCH_SIZE *
+                              sizeof(SpriteInstance));
+
+  m_instanceVao.Bind();
+  m_instanceVbo.Bind();
+
+  // The quad corners come from gl_VertexID; every attribute is per instance.
+  m_instanceVao.LinkAttrib(m_instanceVbo, 0, 2, GL_FLOAT,
+                           sizeof(SpriteInstance),
+                           (void *)offsetof(SpriteInstance, position), 1);
+  m_instanceVao.LinkAttrib(m_instanceVbo, 1, 2, GL_FLOAT,
+                           sizeof(SpriteInstance),
+                           (void *)offsetof(SpriteInstance, size), 1);
+  m_instanceVao.LinkAttrib(m_instanceVbo, 2, 4, GL_FLOAT,
+                           sizeof(SpriteInstance),
+                           (void *)offsetof(SpriteInstance, uvRect), 1);
+  m_instanceVao.LinkAttrib(m_instanceVbo, 3, 4, GL_FLOAT,
+                           sizeof(SpriteInstance),
+                           (void *)offsetof(SpriteInstance, color), 1);
+  m_instanceVao.LinkAttrib(m_instanceVbo, 4, 1, GL_FLOAT,
+                           sizeof(SpriteInstance),
+                           (void *)offsetof(SpriteInstance, textureIndex), 1);
+  m_instanceVao.LinkAttrib(m_instanceVbo, 5, 1, GL_FLOAT,
+                           sizeof(SpriteInstance),
+                           (void *)offsetof(SpriteInstance, rotation), 1);
+  m_instanceVao.LinkAttrib(m_instanceVbo, 6, 2, GL_FLOAT,
+                           sizeof(SpriteInstance),
+                           (void *)offsetof(SpriteInstance, pivot), 1);
+
+  m_instanceVao.Unbind();
+}
+
 void Renderer2D::initCircleShaders() {
-  m_circleShader.Compile(circle_vertex_shader, circle_fragment_shader);
-  m_circleShader.Activate();
-  GLuint projectionLoc =
-      glGetUniformLocation(m_circleShader.GetID(), "projection");
-  glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, m_projection.value_ptr());
+  m_circleShader.Compile(VertexFormat<BatchCircleInstance>::vertexShader,
+                         VertexFormat<BatchCircleInstance>::fragmentShader);
+  uploadProjection(m_circleShader);
 }
 
 void Renderer2D::initCircleBuffers() {
   m_circleVao.Init();
-  m_circleVbo.Init(nullptr, MAX_BATCH_SIZE * 4 * sizeof(CircleVertex));
-  m_circleEbo.Init(nullptr, MAX_BATCH_SIZE * 6 * sizeof(GLuint));
+  m_circleVbo.InitStreaming(MAX_INSTANCE_BATCH_SIZE *
+                            sizeof(BatchCircleInstance));
 
   m_circleVao.Bind();
   m_circleVbo.Bind();
-  m_circleEbo.Bind();
-
-  m_circleVao.LinkAttrib(m_circleVbo, 0, 2, GL_FLOAT, sizeof(CircleVertex),
-                         (void *)offsetof(CircleVertex, position));
-  m_circleVao.LinkAttrib(m_circleVbo, 1, 2, GL_FLOAT, sizeof(CircleVertex),
-                         (void *)offsetof(CircleVertex, uv));
-  m_circleVao.LinkAttrib(m_circleVbo, 2, 4, GL_FLOAT, sizeof(CircleVertex),
-                         (void *)offsetof(CircleVertex, color));
-  m_circleVao.LinkAttrib(m_circleVbo, 3, 2, GL_FLOAT, sizeof(CircleVertex),
-                         (void *)offsetof(CircleVertex, center));
-  m_circleVao.LinkAttrib(m_circleVbo, 4, 1, GL_FLOAT, sizeof(CircleVertex),
-                         (void *)offsetof(CircleVertex, radius));
+
+  VertexFormat<BatchCircleInstance>::link(m_circleVao, m_circleVbo);
 
   m_circleVao.Unbind();
 }
 
 void Renderer2D::begin() {
-  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-  glClear(GL_COLOR_BUFFER_BIT);
-  m_quadBatch.vertices.clear();
-  m_quadBatch.indices.clear();
+  JELLY_PROFILE_ZONE("Renderer2D::begin");
+  GLInstrument::nextFrame();
+  GLState::beginFrame();
+  RenderDevice::get().clear(0.0f, 0.0f, 0.0f, 1.0f);
+  m_quadBatch.vertexCount = 0;
   m_quadBatch.textures.clear();
-  m_circleBatch.vertices.clear();
-  m_circleBatch.indices.clear();
+  m_spriteTransforms.clear();
+  m_pendingSprites.clear();
+  m_instanceBatch.count = 0;
+  m_instanceBatch.textures.clear();
+  m_circleBatch.count = 0;
+  m_queue.clear();
+  m_queuedSprites.clear();
+  m_queuedRects.clear();
+  m_queuedCircles.clear();
+  m_cullStats = CullStats();
+  m_stats = RenderStats();
+  m_flushLog.clear();
+}
+
+void Renderer2D::reserveQuad() {
+  if (m_quadBatch.vertexCount + 4 <= m_quadBatch.vertexCapacity)
+    return;
+
+  flushQuad(FlushReason::BatchFull);
+
+  m_quadBatch.vertices = static_cast<BatchQuadVertex *>(
+      m_quadVbo.Reserve(4 * sizeof(BatchQuadVertex)));
+  m_quadBatch.vertexCapacity =
+      m_quadVbo.getAvailable() / sizeof(BatchQuadVertex);
+}
+
+void Renderer2D::reserveInstance() {
+  if (m_instanceBatch.count < m_instanceBatch.capacity)
+    return;
+
+  flushInstances(FlushReason::BatchFull);
+
+  m_instanceBatch.instances = static_cast<SpriteInstance *>(
+      m_instanceVbo.Reserve(sizeof(SpriteInstance)));
+  m_instanceBatch.capacity =
+      m_instanceVbo.getAvailable() / sizeof(SpriteInstance);
+}
+
+void Renderer2D::reserveCircle() {
+  if (m_circleBatch.count < m_circleBatch.capacity)
+    return;
+
+  flushCircle(FlushReason::BatchFull);
+
+  m_circleBatch.instances = static_cast<BatchCircleInstance *>(
+      m_circleVbo.Reserve(sizeof(BatchCircleInstance)));
+  m_circleBatch.capacity =
+      m_circleVbo.getAvailable() / sizeof(BatchCircleInstance);
+}
+
+static int findTextureSlot(const std::vector<const Texture *> &textures,
+                           const Texture *texture) {
+  for (size_t i = 0; i < textures.size(); ++i) {
+    if (textures[i] == texture) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+static SpriteInstance makeSpriteInstance(const Sprite &sprite) {
+  const Vec3<float> &position = sprite.getPosition();
+
+  SpriteInstance instance;
+  instance.position = Vec2<float>(position.x, position.y);
+  instance.size = sprite.getScaledSize();
+  instance.uvRect = sprite.getUVRect();
+  instance.color = sprite.getColor();
+  instance.textureIndex = -1.0f; // Assigned when the sprite is batched
+  instance.rotation = sprite.getRotation().z;
+  instance.pivot = sprite.getPivot();
+  return instance;
+}
+
+static CullRect rectBounds(const Vec2<float> &position,
+                           const Vec2<float> &size) {
+  return {std::min(position.x, position.x + size.x),
+          std::min(position.y, position.y + size.y),
+          std::max(position.x, position.x + size.x),
+          std::max(position.y, position.y + size.y)};
+}
+
+static CullRect spriteBounds(const SpriteInstance &sprite) {
+  Vec2<float> corner(-sprite.pivot.x * sprite.size.x,
+                     -sprite.pivot.y * sprite.size.y);
+  if (sprite.rotation != 0.0f) {
+    // A rotated sprite stays within its farthest corner of the pivot.
+    float reachX = std::max(std::fabs(corner.x),
+                            std::fabs(corner.x + sprite.size.x));
+    float reachY = std::max(std::fabs(corner.y),
+                            std::fabs(corner.y + sprite.size.y));
+    float reach = std::sqrt(reachX * reachX + reachY * reachY);
+    return {sprite.position.x - reach, sprite.position.y - reach,
+            sprite.position.x + reach, sprite.position.y + reach};
+  }
+  return rectBounds(sprite.position + corner, sprite.size);
+}
+
+static CullRect circleBounds(const Circle &circle) {
+  const Vec2<float> &center = circle.getPosition();
+  float radius = circle.getRadius();
+  return {center.x - radius, center.y - radius, center.x + radius,
+          center.y + radius};
+}
+
+size_t Renderer2D::cullBulk() {
+  size_t count = m_cullBounds.size();
+  m_visible.resize(count);
+  size_t visibleCount =
+      cullBounds(m_cullBounds, m_viewBounds, m_visible.data());
+  m_cullStats.tested += count;
+  m_cullStats.culled += count - visibleCount;
+  return visibleCount;
+}
+
+bool Renderer2D::cull(const CullRect &bounds) {
+  if (!m_culling)
+    return false;
+
+  ++m_cullStats.tested;
+  if (bounds.overlaps(m_viewBounds))
+    return false;
+
+  ++m_cullStats.culled;
+  return true;
 }
 
 void Renderer2D::drawSprite(const Sprite &sprite) {
-  if (m_quadBatch.vertices.size() >= MAX_BATCH_SIZE) {
-    flushQuad();
+  SpriteInstance instance = makeSpriteInstance(sprite);
+  if (cull(spriteBounds(instance)))
+    return;
+
+  queueSprite(instance, &sprite.getTexture(), sprite.getPosition().z);
+}
+
+void Renderer2D::drawSprites(std::span<const Sprite> sprites) {
+  if (!m_culling) {
+    for (const Sprite &sprite : sprites) {
+      drawSprite(sprite);
+    }
+    return;
   }
 
-  if (!m_quadBatch.filled) {
-    flushQuad();
-    m_quadBatch.filled = true;
+  m_cullBounds.clear();
+  m_bulkSprites.clear();
+  for (const Sprite &sprite : sprites) {
+    m_bulkSprites.push_back(makeSpriteInstance(sprite));
+    m_cullBounds.push(spriteBounds(m_bulkSprites.back()));
   }
 
-  const Texture *texture = &sprite.getTexture();
+  size_t visibleCount = cullBulk();
+  for (size_t i = 0; i < visibleCount; ++i) {
+    const Sprite &sprite = sprites[m_visible[i]];
+    queueSprite(m_bulkSprites[m_visible[i]], &sprite.getTexture(),
+                sprite.getPosition().z);
+  }
+}
 
-  // Find or add texture to batch
-  float textureIndex = -1.0f;
-  for (size_t i = 0; i < m_quadBatch.textures.size(); ++i) {
-    if (m_quadBatch.textures[i] == texture) {
-      textureIndex = static_cast<float>(i);
-      break;
+void Renderer2D::queueSprite(const SpriteInstance &instance,
+                             const Texture *texture, float layer) {
+  if (m_sortMode == RenderSortMode::Immediate) {
+    submitSprite(instance, texture);
+    return;
+  }
+
+  uint64_t key;
+  if (m_sortMode == RenderSortMode::Batch) {
+    uint32_t pipeline = m_spritePipeline == SpritePipeline::Instanced
+                            ? InstancePipeline
+                            : QuadPipeline;
+    key = makeSortKey(layer, pipeline, 0, texture->getID());
+  } else {
+    key = makeSortKey(layer, 0, 0, 0);
+  }
+
+  m_queue.push(key, RenderCommandType::Sprite,
+               static_cast<uint32_t>(m_queuedSprites.size()));
+  m_queuedSprites.push_back({instance, texture});
+}
+
+void Renderer2D::drawRect(const Rectangle &rectangle) {
+  if (cull(rectBounds(rectangle.getPosition(), rectangle.getSize())))
+    return;
+
+  queueRect(rectangle);
+}
+
+void Renderer2D::drawRects(std::span<const Rectangle> rectangles) {
+  if (!m_culling) {
+    for (const Rectangle &rectangle : rectangles) {
+      queueRect(rectangle);
     }
+    return;
   }
-  if (textureIndex == -1.0f) {
-    if (m_quadBatch.textures.size() >= MAX_TEXTURE_SLOTS) {
-      flushQuad();
+
+  m_cullBounds.clear();
+  for (const Rectangle &rectangle : rectangles) {
+    m_cullBounds.push(rectBounds(rectangle.getPosition(), rectangle.getSize()));
+  }
+
+  size_t visibleCount = cullBulk();
+  for (size_t i = 0; i < visibleCount; ++i) {
+    queueRect(rectangles[m_visible[i]]);
+  }
+}
+
+void Renderer2D::queueRect(const Rectangle &rectangle) {
+  if (m_sortMode == RenderSortMode::Immediate) {
+    submitRect(rectangle);
+    return;
+  }
+
+  // Shapes have no z; they live on layer 0.
+  uint64_t key = m_sortMode == RenderSortMode::Batch
+                     ? makeSortKey(0.0f, QuadPipeline,
+                                   rectangle.isFilled() ? 0 : 1, 0)
+                     : makeSortKey(0.0f, 0, 0, 0);
+
+  m_queue.push(key, RenderCommandType::Rectangle,
+               static_cast<uint32_t>(m_queuedRects.size()));
+  m_queuedRects.push_back(rectangle);
+}
+
+void Renderer2D::drawCircle(const Circle &circle) {
+  if (cull(circleBounds(circle)))
+    return;
+
+  queueCircle(circle);
+}
+
+void Renderer2D::drawCircles(std::span<const Circle> circles) {
+  if (!m_culling) {
+    for (const Circle &circle : circles) {
+      queueCircle(circle);
     }
-    m_quadBatch.textures.push_back(texture);
-    textureIndex = static_cast<float>(m_quadBatch.textures.size() - 1);
+    return;
+  }
+
+  m_cullBounds.clear();
+  for (const Circle &circle : circles) {
+    m_cullBounds.push(circleBounds(circle));
   }
 
-  Vec3<float> sPos = sprite.getPosition();
+  size_t visibleCount = cullBulk();
+  for (size_t i = 0; i < visibleCount; ++i) {
+    queueCircle(circles[m_visible[i]]);
+  }
+}
+
+void Renderer2D::queueCircle(const Circle &circle) {
+  if (m_sortMode == RenderSortMode::Immediate) {
+    submitCircle(circle);
+    return;
+  }
 
-  // Add vertices and indices to batch
-  Vec2<float> position = Vec2<float>(sPos.x, sPos.y);
-  Vec2<float> size = sprite.getSize();
-  Vec4<float> color = sprite.getColor();
+  // Filled and outlined circles share a batch.
+  uint64_t key = m_sortMode == RenderSortMode::Batch
+                     ? makeSortKey(0.0f, CirclePipeline, 0, 0)
+                     : makeSortKey(0.0f, 0, 0, 0);
 
-  Vec2<float> uv0(0.0f, 1.0f);
-  Vec2<float> uv1(1.0f, 1.0f);
-  Vec2<float> uv2(1.0f, 0.0f);
-  Vec2<float> uv3(0.0f, 0.0f);
+  m_queue.push(key, RenderCommandType::Circle,
+               static_cast<uint32_t>(m_queuedCircles.size()));
+  m_queuedCircles.push_back(circle);
+}
 
-  GLuint baseIndex = static_cast<GLuint>(m_quadBatch.vertices.size());
+void Renderer2D::drawStaticBatch(StaticBatch &batch) {
+  flushQueue();
+  flushQuad(FlushReason::StaticBatch);
+  flushInstances(FlushReason::StaticBatch);
+  flushCircle(FlushReason::StaticBatch);
 
-  m_quadBatch.vertices.push_back(
-      {{position.x, position.y}, uv0, color, textureIndex});
-  m_quadBatch.vertices.push_back(
-      {{position.x + size.x, position.y}, uv1, color, textureIndex});
-  m_quadBatch.vertices.push_back(
-      {{position.x + size.x, position.y + size.y}, uv2, color, textureIndex});
-  m_quadBatch.vertices.push_back(
-      {{position.x, position.y + size.y}, uv3, color, textureIndex});
+  if (batch.size() == 0)
+    return;
 
-  m_quadBatch.indices.insert(m_quadBatch.indices.end(),
-                             {baseIndex, baseIndex + 1, baseIndex + 2,
-                              baseIndex, baseIndex + 2, baseIndex + 3});
+  m_quadShader.Activate();
+  bindTextures(batch.getTextures());
+
+  size_t uploaded = batch.getStats().bytesUploaded;
+  StaticBatchDraw issued = batch.draw();
+
+  m_stats.drawCalls += issued.drawCalls;
+  m_stats.vertices += batch.size() * 4;
+  m_stats.indices += issued.indices;
+  m_stats.bytesUploaded += batch.getStats().bytesUploaded - uploaded;
+  const std::vector<const Texture *> &textures = batch.getTextures();
+  m_stats.textureBinds +=
+      textures.size() - std::count(textures.begin(), textures.end(), nullptr);
 }
 
-void Renderer2D::drawRect(const Rectangle &rectangle) {
-  bool filled = rectangle.isFilled();
-  if (m_quadBatch.filled != filled) {
-    flushQuad();
-    m_quadBatch.filled = filled;
+void Renderer2D::submitSprite(const SpriteInstance &sprite,
+                              const Texture *texture) {
+  if (m_spritePipeline == SpritePipeline::Instanced) {
+    submitSpriteInstanced(sprite, texture);
+  } else {
+    submitSpriteBatched(sprite, texture);
+  }
+}
+
+void Renderer2D::submitSpriteBatched(const SpriteInstance &sprite,
+                                     const Texture *texture) {
+  flushInstances(FlushReason::PipelineSwitch);
+
+  if (!m_quadBatch.filled) {
+    flushQuad(FlushReason::FillMode);
+    m_quadBatch.filled = true;
   }
 
-  const auto &vertices = rectangle.getVertices();
-  const auto &indices =
-      rectangle.getIndices(static_cast<GLuint>(m_quadBatch.vertices.size()));
+  reserveQuad();
 
-  for (const auto &vertex : vertices) {
-    m_quadBatch.vertices.push_back(
-        {vertex, {0.0f, 0.0f}, rectangle.getColor(), -1.0f});
+  // Find or add texture to batch
+  int textureIndex = findTextureSlot(m_quadBatch.textures, texture);
+  if (textureIndex == -1) {
+    if (m_quadBatch.textures.size() >= MAX_TEXTURE_SLOTS) {
+      flushQuad(FlushReason::TextureSlots);
+      reserveQuad();
+    }
+    m_quadBatch.textures.push_back(texture);
+    textureIndex = static_cast<int>(m_quadBatch.textures.size() - 1);
   }
 
-  m_quadBatch.indices.insert(m_quadBatch.indices.end(), indices.begin(),
-                             indices.end());
+  // The vertices are written when the batch is flushed.
+  m_spriteTransforms.push(sprite.position, sprite.size, sprite.pivot,
+                          sprite.rotation);
+  m_pendingSprites.push_back(
+      {m_quadBatch.vertexCount, sprite.uvRect, sprite.color, textureIndex});
+  m_quadBatch.vertexCount += 4;
 }
 
-void Renderer2D::drawCircle(const Circle &circle) {
-  bool filled = circle.isFilled();
-  if (m_circleBatch.filled != filled) {
-    flushCircle();
-    m_circleBatch.filled = filled;
+void Renderer2D::submitSpriteInstanced(const SpriteInstance &sprite,
+                                       const Texture *texture) {
+  // Rectangles share the quad batch; flush it to keep painter's order.
+  flushQuad(FlushReason::PipelineSwitch);
+  reserveInstance();
+
+  int textureIndex = findTextureSlot(m_instanceBatch.textures, texture);
+  if (textureIndex == -1) {
+    if (m_instanceBatch.textures.size() >= MAX_TEXTURE_SLOTS) {
+      flushInstances(FlushReason::TextureSlots);
+      reserveInstance();
+    }
+    m_instanceBatch.textures.push_back(texture);
+    textureIndex = static_cast<int>(m_instanceBatch.textures.size() - 1);
   }
 
-  const auto &vertices = circle.getVertices();
-  const auto &indices =
-      circle.getIndices(static_cast<GLuint>(m_circleBatch.vertices.size()));
+  SpriteInstance &instance =
+      m_instanceBatch.instances[m_instanceBatch.count++];
+  instance = sprite;
+  instance.textureIndex = static_cast<float>(textureIndex);
+}
 
-  Vec2<float> circleCenter = circle.getPosition();
-  float radius = circle.getRadius();
+void Renderer2D::submitRect(const Rectangle &rectangle) {
+  flushInstances(FlushReason::PipelineSwitch);
 
-  for (const auto &vertex : vertices) {
-    m_circleBatch.vertices.push_back(
-        {vertex, {0.0f, 0.0f}, circle.getColor(), circleCenter, radius});
+  bool filled = rectangle.isFilled();
+  if (m_quadBatch.filled != filled) {
+    flushQuad(FlushReason::FillMode);
+    m_quadBatch.filled = filled;
   }
 
-  m_circleBatch.indices.insert(m_circleBatch.indices.end(), indices.begin(),
-                               indices.end());
+  // The static index buffer supplies the triangles or the outline loop.
+  reserveQuad();
+  rectangle.emit(m_quadBatch.vertices + m_quadBatch.vertexCount);
+  m_quadBatch.vertexCount += 4;
+}
+
+void Renderer2D::submitCircle(const Circle &circle) {
+  reserveCircle();
+  circle.emit(m_circleBatch.instances + m_circleBatch.count);
+  m_circleBatch.count++;
+}
+
+void Renderer2D::bindTextures(const std::vector<const Texture *> &textures) {
+  // The shaders' sampler arrays were pointed at units 0 to N-1 when they
+  // were linked, and textures that stay in their unit are not rebound.
+  // Static batches leave the slots of released textures empty.
+  for (size_t i = 0; i < textures.size(); ++i) {
+    if (textures[i] != nullptr)
+      textures[i]->Bind(static_cast<GLuint>(i));
+  }
 }
 
-void Renderer2D::flushQuad() {
-  if (m_quadBatch.vertices.empty())
+void Renderer2D::expandSprites() {
+  if (m_pendingSprites.empty())
     return;
 
-  m_quadVao.Bind();
-  m_quadVbo.Update(m_quadBatch.vertices.data(),
-                   m_quadBatch.vertices.size() * sizeof(QuadVertex));
-  m_quadEbo.Update(m_quadBatch.indices.data(),
-                   m_quadBatch.indices.size() * sizeof(GLuint));
+  m_spriteCorners.resize(m_spriteTransforms.size() * 8);
+  transformQuads(m_spriteTransforms, m_spriteCorners.data());
+
+  using Format = VertexFormat<BatchQuadVertex>;
+  for (size_t i = 0; i < m_pendingSprites.size(); ++i) {
+    const PendingSprite &sprite = m_pendingSprites[i];
+    const float *corner = &m_spriteCorners[i * 8];
+    const Vec4<float> &uvRect = sprite.uvRect;
+    int textureIndex = sprite.textureIndex;
+
+    BatchQuadVertex *vertex = m_quadBatch.vertices + sprite.vertexOffset;
+    vertex[0] = Format::make({corner[0], corner[1]}, {uvRect.x, uvRect.w},
+                             sprite.color, textureIndex);
+    vertex[1] = Format::make({corner[2], corner[3]}, {uvRect.z, uvRect.w},
+                             sprite.color, textureIndex);
+    vertex[2] = Format::make({corner[4], corner[5]}, {uvRect.z, uvRect.y},
+                             sprite.color, textureIndex);
+    vertex[3] = Format::make({corner[6], corner[7]}, {uvRect.x, uvRect.y},
+                             sprite.color, textureIndex);
+  }
 
-  m_quadShader.Activate();
+  m_spriteTransforms.clear();
+  m_pendingSprites.clear();
+}
 
-  for (size_t i = 0; i < m_quadBatch.textures.size(); ++i) {
-    glActiveTexture(GL_TEXTURE0 + i);
-    m_quadBatch.textures[i]->Bind();
-    m_quadBatch.textures[i]->texUnit(
-        m_quadShader, ("textures[" + std::to_string(i) + "]").c_str(), i);
+void Renderer2D::recordFlush(FlushReason reason, const char *batch,
+                             size_t items, size_t textures) {
+  m_stats.drawCalls++;
+  m_stats.textureBinds += textures;
+  m_stats.flushes[static_cast<size_t>(reason)]++;
+  if (m_debugMode) {
+    m_flushLog.push_back({reason, batch, items});
   }
+}
 
-  GLenum drawMode = m_quadBatch.filled ? GL_TRIANGLES : GL_LINES;
-  GL_CHECK(glDrawElements(drawMode,
-                          static_cast<GLsizei>(m_quadBatch.indices.size()),
-                          GL_UNSIGNED_INT, nullptr));
+void Renderer2D::flushQuad(FlushReason reason) {
+  JELLY_PROFILE_ZONE("Renderer2D::flushQuad");
+  expandSprites();
+  if (m_quadBatch.vertexCount == 0)
+    return;
+
+  m_quadVao.Bind();
+  m_quadShader.Activate();
+  bindTextures(m_quadBatch.textures);
+
+  // The static indices are batch-relative; the base vertex points them at
+  // the batch.
+  GLint baseVertex = static_cast<GLint>(m_quadVbo.getStreamOffset() /
+                                        sizeof(BatchQuadVertex));
+  size_t quadCount = m_quadBatch.vertexCount / 4;
+
+  size_t indexCount = quadCount * (m_quadBatch.filled ? 6 : 5);
+  recordFlush(reason, "quads", quadCount, m_quadBatch.textures.size());
+  m_stats.vertices += m_quadBatch.vertexCount;
+  m_stats.indices += indexCount;
+  m_stats.bytesUploaded += m_quadBatch.vertexCount * sizeof(BatchQuadVertex);
+  m_quadVbo.Commit(m_quadBatch.vertexCount * sizeof(BatchQuadVertex));
+
+  RenderDevice &device = RenderDevice::get();
+  if (m_quadBatch.filled) {
+    device.drawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount),
+                        GL_UNSIGNED_SHORT, nullptr, baseVertex);
+  } else {
+    size_t loopOffset = MAX_BATCH_SIZE * 6 * sizeof(QuadIndex);
+    device.enable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+    device.drawElements(GL_LINE_LOOP, static_cast<GLsizei>(indexCount),
+                        GL_UNSIGNED_SHORT,
+                        reinterpret_cast<void *>(loopOffset), baseVertex);
+    device.disable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+  }
 
   m_quadVao.Unbind();
-  m_quadBatch.vertices.clear();
-  m_quadBatch.indices.clear();
+
+  m_quadBatch.vertices = nullptr;
+  m_quadBatch.vertexCount = 0;
+  m_quadBatch.vertexCapacity = 0;
   m_quadBatch.textures.clear();
 }
 
-void Renderer2D::flushCircle() {
-  if (m_circleBatch.vertices.empty())
+void Renderer2D::flushInstances(FlushReason reason) {
+  JELLY_PROFILE_ZONE("Renderer2D::flushInstances");
+  if (m_instanceBatch.count == 0)
     return;
 
-  m_circleVao.Bind();
-  m_circleVbo.Update(m_circleBatch.vertices.data(),
-                     m_circleBatch.vertices.size() * sizeof(CircleVertex));
-  m_circleEbo.Update(m_circleBatch.indices.data(),
-                     m_circleBatch.indices.size() * sizeof(GLuint));
+  recordFlush(reason, "sprite instances", m_instanceBatch.count,
+              m_instanceBatch.textures.size());
+  m_stats.vertices += m_instanceBatch.count * 4;
+  m_stats.instances += m_instanceBatch.count;
+  m_stats.bytesUploaded += m_instanceBatch.count * sizeof(SpriteInstance);
+
+  m_instanceVao.Bind();
+  m_instanceShader.Activate();
+  bindTextures(m_instanceBatch.textures);
+
+  GLuint baseInstance = static_cast<GLuint>(m_instanceVbo.getStreamOffset() /
+                                            sizeof(SpriteInstance));
+  m_instanceVbo.Commit(m_instanceBatch.count * sizeof(SpriteInstance));
+  RenderDevice::get().drawArraysInstanced(
+      GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(m_instanceBatch.count),
+      baseInstance);
+
+  m_instanceVao.Unbind();
+
+  m_instanceBatch.instances = nullptr;
+  m_instanceBatch.count = 0;
+  m_instanceBatch.capacity = 0;
+  m_instanceBatch.textures.clear();
+}
 
+void Renderer2D::flushCircle(FlushReason reason) {
+  JELLY_PROFILE_ZONE("Renderer2D::flushCircle");
+  if (m_circleBatch.count == 0)
+    return;
+
+  recordFlush(reason, "circles", m_circleBatch.count, 0);
+  m_stats.vertices += m_circleBatch.count * 4;
+  m_stats.instances += m_circleBatch.count;
+  m_stats.bytesUploaded += m_circleBatch.count * sizeof(BatchCircleInstance);
+
+  m_circleVao.Bind();
   m_circleShader.Activate();
 
-  GLenum drawMode = m_circleBatch.filled ? GL_TRIANGLES : GL_LINES;
-  GL_CHECK(glDrawElements(drawMode,
-                          static_cast<GLsizei>(m_circleBatch.indices.size()),
-                          GL_UNSIGNED_INT, nullptr));
+  GLuint baseInstance = static_cast<GLuint>(m_circleVbo.getStreamOffset() /
+                                            sizeof(BatchCircleInstance));
+  m_circleVbo.Commit(m_circleBatch.count * sizeof(BatchCircleInstance));
+  RenderDevice::get().drawArraysInstanced(
+      GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(m_circleBatch.count),
+      baseInstance);
 
   m_circleVao.Unbind();
-  m_circleBatch.vertices.clear();
-  m_circleBatch.indices.clear();
+
+  m_circleBatch.instances = nullptr;
+  m_circleBatch.count = 0;
+  m_circleBatch.capacity = 0;
+}
+
+void Renderer2D::flushQueue() {
+  JELLY_PROFILE_ZONE("Renderer2D::flushQueue");
+  if (m_queue.empty())
+    return;
+
+  m_queue.sort();
+
+  const std::vector<RenderCommand> &commands = m_queue.getCommands();
+  uint32_t layer = sortKeyLayer(commands.front().key);
+  // Stable mode promises painter's order within a layer too, so circles and
+  // quads end each other's batch instead of drawing in two passes.
+  bool stable = m_sortMode == RenderSortMode::Stable;
+
+  for (const RenderCommand &command : commands) {
+    // Circles batch separately from quads, so finish a layer before the next
+    // one starts drawing on top of it.
+    if (sortKeyLayer(command.key) != layer) {
+      flushQuad(FlushReason::LayerChange);
+      flushInstances(FlushReason::LayerChange);
+      flushCircle(FlushReason::LayerChange);
+      layer = sortKeyLayer(command.key);
+    }
+
+    if (stable) {
+      if (command.type == RenderCommandType::Circle) {
+        flushQuad(FlushReason::PipelineSwitch);
+        flushInstances(FlushReason::PipelineSwitch);
+      } else {
+        flushCircle(FlushReason::PipelineSwitch);
+      }
+    }
+
+    switch (command.type) {
+    case RenderCommandType::Sprite: {
+      const QueuedSprite &sprite = m_queuedSprites[command.index];
+      submitSprite(sprite.instance, sprite.texture);
+      break;
+    }
+    case RenderCommandType::Rectangle:
+      submitRect(m_queuedRects[command.index]);
+      break;
+    case RenderCommandType::Circle:
+      submitCircle(m_queuedCircles[command.index]);
+      break;
+    }
+  }
+
+  m_queue.clear();
+  m_queuedSprites.clear();
+  m_queuedRects.clear();
+  m_queuedCircles.clear();
 }
 
 void Renderer2D::end() {
-  flushQuad();
-  flushCircle();
+  JELLY_PROFILE_ZONE("Renderer2D::end");
+  flushQueue();
+  flushQuad(FlushReason::EndOfFrame);
+  flushInstances(FlushReason::EndOfFrame);
+  flushCircle(FlushReason::EndOfFrame);
+
+  // Start the next frame in fresh regions so the CPU never writes memory the
+  // GPU may still be reading for this frame.
+  m_quadVbo.NextRegion();
+  m_instanceVbo.NextRegion();
+  m_circleVbo.NextRegion();
 }
 
 void Renderer2D::shutdown() {
@@ -252,27 +730,94 @@ void Renderer2D::shutdown() {
   m_quadEbo.Delete();
   m_quadVao.Delete();
 
+  m_instanceShader.Delete();
+  m_instanceVbo.Delete();
+  m_instanceVao.Delete();
+
   m_circleShader.Delete();
   m_circleVbo.Delete();
-  m_circleEbo.Delete();
   m_circleVao.Delete();
 }
 
 void Renderer2D::updateProjection(int windowWidth, int windowHeight) {
   m_windowWidth = windowWidth;
   m_windowHeight = windowHeight;
+  m_viewBounds = {0.0f, 0.0f, static_cast<float>(windowWidth),
+                  static_cast<float>(windowHeight)};
   m_projection =
       Mat4<float>::ortho(0.0f, static_cast<float>(windowWidth),
                          static_cast<float>(windowHeight), 0.0f, -1.0f, 1.0f);
 
-  m_quadShader.Activate();
-  GLuint projectionLoc =
-      glGetUniformLocation(m_quadShader.GetID(), "projection");
-  glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, m_projection.value_ptr());
+  uploadProjection(m_quadShader);
+  uploadProjection(m_instanceShader);
+  uploadProjection(m_circleShader);
+}
 
-  m_circleShader.Activate();
-  projectionLoc = glGetUniformLocation(m_circleShader.GetID(), "projection");
-  glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, m_projection.value_ptr());
+void Renderer2D::uploadProjection(const Shader &shader) {
+  // The location comes from the shader's table; setting it through the
+  // program avoids switching the current program.
+  RenderDevice::get().programUniformMatrix4fv(
+      shader.GetID(), shader.getUniformLocation("projection"), 1, GL_FALSE,
+      m_projection.value_ptr());
 }
 
 void Renderer2D::setDebugMode(bool debug) { m_debugMode = debug; }
+
+bool Renderer2D::isDebugMode() const { return m_debugMode; }
+
+void Renderer2D::setSpritePipeline(SpritePipeline pipeline) {
+  if (pipeline == m_spritePipeline)
+    return;
+
+  flushQuad(FlushReason::PipelineSwitch);
+  flushInstances(FlushReason::PipelineSwitch);
+  m_spritePipeline = pipeline;
+}
+
+SpritePipeline Renderer2D::getSpritePipeline() const {
+  return m_spritePipeline;
+}
+
+void Renderer2D::setSortMode(RenderSortMode mode) {
+  if (mode == m_sortMode)
+    return;
+
+  flushQueue();
+  m_sortMode = mode;
+}
+
+RenderSortMode Renderer2D::getSortMode() const { return m_sortMode; }
+
+void Renderer2D::setCulling(bool enabled) { m_culling = enabled; }
+
+bool Renderer2D::isCullingEnabled() const { return m_culling; }
+
+const CullRect &Renderer2D::getViewBounds() const { return m_viewBounds; }
+
+const CullStats &Renderer2D::getCullStats() const { return m_cullStats; }
+
+const RenderStats &Renderer2D::getStats() const { return m_stats; }
+
+const std::vector<FlushRecord> &Renderer2D::getFlushLog() const {
+  return m_flushLog;
+}
+
+const char *flushReasonName(FlushReason reason) {
+  switch (reason) {
+  case FlushReason::BatchFull:
+    return "batch full";
+  case FlushReason::TextureSlots:
+    return "texture slots";
+  case FlushReason::FillMode:
+    return "fill mode";
+  case FlushReason::PipelineSwitch:
+    return "pipeline switch";
+  case FlushReason::LayerChange:
+    return "layer change";
+  case FlushReason::StaticBatch:
+    return "static batch";
+  case FlushReason::EndOfFrame:
+    return "end of frame";
+  }
+  return "unknown";
+}
@@ -1,55 +1,82 @@
-#include <iostream>
-
+#include <jelly/gl_state.h>
+#include <jelly/render_device.h>
 #include <jelly/shader.h>
 
-void Shader::compileErrors(unsigned int shader, const char *type) {
-  int success;
-
-  if (strcmp(type, "PROGRAM") != 0) {
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-
-    if (!success) {
-      GLchar log[1024];
-      glGetShaderInfoLog(shader, 1024, nullptr, log);
-      std::cerr << "Error: Shader compilation failed: " << log << std::endl;
-    }
-  } else {
-    glGetProgramiv(shader, GL_LINK_STATUS, &success);
+namespace {
 
-    if (!success) {
-      GLchar log[1024];
-      glGetProgramInfoLog(shader, 1024, nullptr, log);
-      std::cerr << "Error: Shader linking failed: " << log << std::endl;
-    }
+bool isSamplerType(GLenum type) {
+  switch (type) {
+  case GL_SAMPLER_1D:
+  case GL_SAMPLER_2D:
+  case GL_SAMPLER_3D:
+  case GL_SAMPLER_CUBE:
+  case GL_SAMPLER_2D_ARRAY:
+  case GL_SAMPLER_2D_MULTISAMPLE:
+  case GL_SAMPLER_BUFFER:
+  case GL_INT_SAMPLER_2D:
+  case GL_UNSIGNED_INT_SAMPLER_2D:
+    return true;
+  default:
+    return false;
   }
 }
 
+} // namespace
+
 Shader::Shader() : m_id(0) {}
 
 void Shader::Compile(const char *vertex_source, const char *fragment_source) {
-  GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-  glShaderSource(vertexShader, 1, &vertex_source, nullptr);
-  glCompileShader(vertexShader);
-  compileErrors(vertexShader, "VERTEX");
+  m_id = RenderDevice::get().createProgram(vertex_source, fragment_source);
+  loadUniforms();
+}
 
-  GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-  glShaderSource(fragmentShader, 1, &fragment_source, nullptr);
-  glCompileShader(fragmentShader);
-  compileErrors(fragmentShader, "FRAGMENT");
+void Shader::loadUniforms() {
+  RenderDevice &device = RenderDevice::get();
+  device.getActiveUniforms(m_id, m_uniforms);
 
-  m_id = glCreateProgram();
-  glAttachShader(m_id, vertexShader);
-  glAttachShader(m_id, fragmentShader);
+  // Uniforms in blocks have no location and are not set through it.
+  std::erase_if(m_uniforms, [](const ShaderUniform &uniform) {
+    return uniform.location == -1;
+  });
 
-  glLinkProgram(m_id);
-  compileErrors(m_id, "PROGRAM");
+  std::vector<GLint> units;
+  GLint nextUnit = 0;
+  for (ShaderUniform &uniform : m_uniforms) {
+    size_t bracket = uniform.name.find('[');
+    if (bracket != std::string::npos) {
+      uniform.name.resize(bracket);
+    }
 
-  glDeleteShader(vertexShader);
-  glDeleteShader(fragmentShader);
+    // Samplers never change units afterwards, so set them once here.
+    if (isSamplerType(uniform.type)) {
+      units.resize(uniform.size);
+      for (GLint &unit : units) {
+        unit = nextUnit++;
+      }
+      device.programUniform1iv(m_id, uniform.location, uniform.size,
+                               units.data());
+    }
+  }
 }
 
-GLuint Shader::GetID() { return m_id; }
+GLuint Shader::GetID() const { return m_id; }
 
-void Shader::Activate() const { glUseProgram(m_id); }
+void Shader::Activate() const { GLState::useProgram(m_id); }
+
+GLint Shader::getUniformLocation(const char *name) const {
+  for (const ShaderUniform &uniform : m_uniforms) {
+    if (uniform.name == name)
+      return uniform.location;
+  }
+  return -1;
+}
+
+const std::vector<ShaderUniform> &Shader::getUniforms() const {
+  return m_uniforms;
+}
 
-void Shader::Delete() { glDeleteProgram(m_id); }
\ No newline at end of file
+void Shader::Delete() {
+  GLState::forgetProgram(m_id);
+  RenderDevice::get().deleteProgram(m_id);
+  m_uniforms.clear();
+}
\ No newline at end of file
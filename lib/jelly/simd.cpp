@@ -0,0 +1,25 @@
+#include <jelly/simd.h>
+
+bool isSimdLevelSupported(SimdLevel level) {
+  switch (level) {
+  case SimdLevel::Scalar:
+    return true;
+#ifdef JELLY_SIMD_X86
+  case SimdLevel::SSE:
+    return __builtin_cpu_supports("sse2");
+  case SimdLevel::AVX:
+    return __builtin_cpu_supports("avx");
+#endif
+  default:
+    return false;
+  }
+}
+
+SimdLevel bestSimdLevel() {
+  static const SimdLevel best = isSimdLevelSupported(SimdLevel::AVX)
+                                    ? SimdLevel::AVX
+                                : isSimdLevelSupported(SimdLevel::SSE)
+                                    ? SimdLevel::SSE
+                                    : SimdLevel::Scalar;
+  return best;
+}
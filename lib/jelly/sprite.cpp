@@ -1,14 +1,28 @@
 #include <jelly/sprite.h>
 #include <jelly/game_context.h>
 
+namespace {
+
+TextureHandle loadSpriteTexture(const char *path) {
+  if (GameContext::isInitialized())
+    return GameContext::getInstance().getTextureCache().load(path);
+  return TextureCache::loadUncached(path);
+}
+
+} // namespace
+
 Sprite::Sprite(const char *texturePath, Vec4<float> color, int width,
                int height)
-    : m_texture(texturePath) {
-  m_width = width == 0 ? m_texture.getWidth() : width;
-  m_height = height == 0 ? m_texture.getHeight() : height;
-}
+    : Sprite(loadSpriteTexture(texturePath), color, width, height) {}
 
-Sprite::~Sprite() { m_texture.Delete(); }
+Sprite::Sprite(TextureHandle texture, Vec4<float> color, int width,
+               int height)
+    : m_width(width), m_height(height), m_color(color),
+      m_texture(std::move(texture)) {}
+
+Sprite::Sprite(const AtlasRegion &region, Vec4<float> color, int width,
+               int height)
+    : m_width(width), m_height(height), m_color(color), m_region(&region) {}
 
 void Sprite::setPosition(const Vec3<float> &position) { m_position = position; }
 
@@ -16,18 +30,42 @@ void Sprite::setScale(const Vec3<float> &scale) { m_scale = scale; }
 
 void Sprite::setRotation(const Vec3<float> &rotation) { m_rotation = rotation; }
 
+void Sprite::setPivot(const Vec2<float> &pivot) { m_pivot = pivot; }
+
 const Vec3<float> &Sprite::getPosition() const { return m_position; }
 
 const Vec3<float> &Sprite::getScale() const { return m_scale; }
 
 const Vec3<float> &Sprite::getRotation() const { return m_rotation; }
 
-float Sprite::getWidth() const { return m_width; }
+const Vec2<float> &Sprite::getPivot() const { return m_pivot; }
 
-float Sprite::getHeight() const { return m_height; }
+float Sprite::getWidth() const {
+  if (m_width != 0.0f)
+    return m_width;
+  return m_region ? m_region->rect.width : m_texture->getWidth();
+}
 
-Vec2<float> Sprite::getSize() const { return Vec2<float>(m_width, m_height); }
+float Sprite::getHeight() const {
+  if (m_height != 0.0f)
+    return m_height;
+  return m_region ? m_region->rect.height : m_texture->getHeight();
+}
 
-const Texture &Sprite::getTexture() const { return m_texture; }
+Vec2<float> Sprite::getSize() const {
+  return Vec2<float>(getWidth(), getHeight());
+}
+
+Vec2<float> Sprite::getScaledSize() const {
+  return Vec2<float>(getWidth() * m_scale.x, getHeight() * m_scale.y);
+}
+
+const Texture &Sprite::getTexture() const {
+  return m_region ? *m_region->page : *m_texture;
+}
+
+Vec4<float> Sprite::getUVRect() const {
+  return m_region ? m_region->uvRect : Vec4<float>(0.0f, 0.0f, 1.0f, 1.0f);
+}
 
 const Vec4<float> &Sprite::getColor() const { return m_color; }
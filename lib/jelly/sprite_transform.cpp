@@ -0,0 +1,201 @@
+#include <cmath>
+
+#include <jelly/sprite_transform.h>
+
+#ifdef JELLY_SIMD_X86
+#include <immintrin.h>
+#endif
+
+void SpriteTransformSoA::push(const Vec2<float> &position,
+                              const Vec2<float> &size,
+                              const Vec2<float> &pivot, float rotation) {
+  x.push_back(position.x);
+  y.push_back(position.y);
+  offsetX.push_back(-pivot.x * size.x);
+  offsetY.push_back(-pivot.y * size.y);
+  width.push_back(size.x);
+  height.push_back(size.y);
+  // Most sprites are not rotated; skip the trigonometry for them.
+  sin.push_back(rotation != 0.0f ? std::sin(rotation) : 0.0f);
+  cos.push_back(rotation != 0.0f ? std::cos(rotation) : 1.0f);
+}
+
+void SpriteTransformSoA::clear() {
+  x.clear();
+  y.clear();
+  offsetX.clear();
+  offsetY.clear();
+  width.clear();
+  height.clear();
+  sin.clear();
+  cos.clear();
+}
+
+// All kernels evaluate the same expressions in the same order, so they
+// produce identical corners:
+//   p0 = position + R * offset
+//   p1 = p0 + R * (width, 0)
+//   p2 = p1 + R * (0, height)
+//   p3 = p0 + R * (0, height)
+
+namespace {
+
+void transformScalar(const SpriteTransformSoA &t, size_t begin,
+                     float *corners) {
+  for (size_t i = begin; i < t.size(); ++i) {
+    float s = t.sin[i];
+    float c = t.cos[i];
+    float p0x = t.x[i] + (c * t.offsetX[i] - s * t.offsetY[i]);
+    float p0y = t.y[i] + (s * t.offsetX[i] + c * t.offsetY[i]);
+    float ax = c * t.width[i];
+    float ay = s * t.width[i];
+    float bx = -(s * t.height[i]);
+    float by = c * t.height[i];
+
+    float *out = corners + i * 8;
+    out[0] = p0x;
+    out[1] = p0y;
+    out[2] = p0x + ax;
+    out[3] = p0y + ay;
+    out[4] = out[2] + bx;
+    out[5] = out[3] + by;
+    out[6] = p0x + bx;
+    out[7] = p0y + by;
+  }
+}
+
+#ifdef JELLY_SIMD_X86
+
+__attribute__((target("sse2"))) size_t
+transformSSE(const SpriteTransformSoA &t, float *corners) {
+  const __m128 sign = _mm_set1_ps(-0.0f);
+
+  size_t i = 0;
+  for (; i + 4 <= t.size(); i += 4) {
+    __m128 s = _mm_loadu_ps(&t.sin[i]);
+    __m128 c = _mm_loadu_ps(&t.cos[i]);
+    __m128 ox = _mm_loadu_ps(&t.offsetX[i]);
+    __m128 oy = _mm_loadu_ps(&t.offsetY[i]);
+    __m128 w = _mm_loadu_ps(&t.width[i]);
+    __m128 h = _mm_loadu_ps(&t.height[i]);
+
+    __m128 p0x = _mm_add_ps(_mm_loadu_ps(&t.x[i]),
+                            _mm_sub_ps(_mm_mul_ps(c, ox), _mm_mul_ps(s, oy)));
+    __m128 p0y = _mm_add_ps(_mm_loadu_ps(&t.y[i]),
+                            _mm_add_ps(_mm_mul_ps(s, ox), _mm_mul_ps(c, oy)));
+    __m128 bx = _mm_xor_ps(_mm_mul_ps(s, h), sign);
+    __m128 by = _mm_mul_ps(c, h);
+    __m128 p1x = _mm_add_ps(p0x, _mm_mul_ps(c, w));
+    __m128 p1y = _mm_add_ps(p0y, _mm_mul_ps(s, w));
+    __m128 p2x = _mm_add_ps(p1x, bx);
+    __m128 p2y = _mm_add_ps(p1y, by);
+    __m128 p3x = _mm_add_ps(p0x, bx);
+    __m128 p3y = _mm_add_ps(p0y, by);
+
+    // Transpose from one register per coordinate to eight floats per sprite.
+    __m128 c0lo = _mm_unpacklo_ps(p0x, p0y);
+    __m128 c0hi = _mm_unpackhi_ps(p0x, p0y);
+    __m128 c1lo = _mm_unpacklo_ps(p1x, p1y);
+    __m128 c1hi = _mm_unpackhi_ps(p1x, p1y);
+    __m128 c2lo = _mm_unpacklo_ps(p2x, p2y);
+    __m128 c2hi = _mm_unpackhi_ps(p2x, p2y);
+    __m128 c3lo = _mm_unpacklo_ps(p3x, p3y);
+    __m128 c3hi = _mm_unpackhi_ps(p3x, p3y);
+
+    float *out = corners + i * 8;
+    _mm_storeu_ps(out + 0, _mm_movelh_ps(c0lo, c1lo));
+    _mm_storeu_ps(out + 4, _mm_movelh_ps(c2lo, c3lo));
+    _mm_storeu_ps(out + 8, _mm_movehl_ps(c1lo, c0lo));
+    _mm_storeu_ps(out + 12, _mm_movehl_ps(c3lo, c2lo));
+    _mm_storeu_ps(out + 16, _mm_movelh_ps(c0hi, c1hi));
+    _mm_storeu_ps(out + 20, _mm_movelh_ps(c2hi, c3hi));
+    _mm_storeu_ps(out + 24, _mm_movehl_ps(c1hi, c0hi));
+    _mm_storeu_ps(out + 28, _mm_movehl_ps(c3hi, c2hi));
+  }
+  return i;
+}
+
+__attribute__((target("avx"))) size_t
+transformAVX(const SpriteTransformSoA &t, float *corners) {
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+
+  size_t i = 0;
+  for (; i + 8 <= t.size(); i += 8) {
+    __m256 s = _mm256_loadu_ps(&t.sin[i]);
+    __m256 c = _mm256_loadu_ps(&t.cos[i]);
+    __m256 ox = _mm256_loadu_ps(&t.offsetX[i]);
+    __m256 oy = _mm256_loadu_ps(&t.offsetY[i]);
+    __m256 w = _mm256_loadu_ps(&t.width[i]);
+    __m256 h = _mm256_loadu_ps(&t.height[i]);
+
+    __m256 p0x = _mm256_add_ps(
+        _mm256_loadu_ps(&t.x[i]),
+        _mm256_sub_ps(_mm256_mul_ps(c, ox), _mm256_mul_ps(s, oy)));
+    __m256 p0y = _mm256_add_ps(
+        _mm256_loadu_ps(&t.y[i]),
+        _mm256_add_ps(_mm256_mul_ps(s, ox), _mm256_mul_ps(c, oy)));
+    __m256 bx = _mm256_xor_ps(_mm256_mul_ps(s, h), sign);
+    __m256 by = _mm256_mul_ps(c, h);
+    __m256 p1x = _mm256_add_ps(p0x, _mm256_mul_ps(c, w));
+    __m256 p1y = _mm256_add_ps(p0y, _mm256_mul_ps(s, w));
+    __m256 p2x = _mm256_add_ps(p1x, bx);
+    __m256 p2y = _mm256_add_ps(p1y, by);
+    __m256 p3x = _mm256_add_ps(p0x, bx);
+    __m256 p3y = _mm256_add_ps(p0y, by);
+
+    // Unpacks and shuffles work within 128-bit lanes: the low lane holds
+    // sprites 0-3 and the high lane sprites 4-7.
+    __m256 c0lo = _mm256_unpacklo_ps(p0x, p0y);
+    __m256 c0hi = _mm256_unpackhi_ps(p0x, p0y);
+    __m256 c1lo = _mm256_unpacklo_ps(p1x, p1y);
+    __m256 c1hi = _mm256_unpackhi_ps(p1x, p1y);
+    __m256 c2lo = _mm256_unpacklo_ps(p2x, p2y);
+    __m256 c2hi = _mm256_unpackhi_ps(p2x, p2y);
+    __m256 c3lo = _mm256_unpacklo_ps(p3x, p3y);
+    __m256 c3hi = _mm256_unpackhi_ps(p3x, p3y);
+
+    const int even = _MM_SHUFFLE(1, 0, 1, 0);
+    const int odd = _MM_SHUFFLE(3, 2, 3, 2);
+    __m256 front0 = _mm256_shuffle_ps(c0lo, c1lo, even); // sprites 0 and 4
+    __m256 back0 = _mm256_shuffle_ps(c2lo, c3lo, even);
+    __m256 front1 = _mm256_shuffle_ps(c0lo, c1lo, odd); // sprites 1 and 5
+    __m256 back1 = _mm256_shuffle_ps(c2lo, c3lo, odd);
+    __m256 front2 = _mm256_shuffle_ps(c0hi, c1hi, even); // sprites 2 and 6
+    __m256 back2 = _mm256_shuffle_ps(c2hi, c3hi, even);
+    __m256 front3 = _mm256_shuffle_ps(c0hi, c1hi, odd); // sprites 3 and 7
+    __m256 back3 = _mm256_shuffle_ps(c2hi, c3hi, odd);
+
+    float *out = corners + i * 8;
+    _mm256_storeu_ps(out + 0, _mm256_permute2f128_ps(front0, back0, 0x20));
+    _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(front1, back1, 0x20));
+    _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(front2, back2, 0x20));
+    _mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(front3, back3, 0x20));
+    _mm256_storeu_ps(out + 32, _mm256_permute2f128_ps(front0, back0, 0x31));
+    _mm256_storeu_ps(out + 40, _mm256_permute2f128_ps(front1, back1, 0x31));
+    _mm256_storeu_ps(out + 48, _mm256_permute2f128_ps(front2, back2, 0x31));
+    _mm256_storeu_ps(out + 56, _mm256_permute2f128_ps(front3, back3, 0x31));
+  }
+  return i;
+}
+
+#endif // JELLY_SIMD_X86
+
+} // namespace
+
+void transformQuads(const SpriteTransformSoA &transforms, float *corners,
+                    SimdLevel level) {
+  if (!isSimdLevelSupported(level))
+    level = SimdLevel::Scalar;
+
+  // The vector kernels stop at the last full vector; the scalar kernel
+  // finishes the tail.
+  size_t end = 0;
+#ifdef JELLY_SIMD_X86
+  if (level == SimdLevel::AVX) {
+    end = transformAVX(transforms, corners);
+  } else if (level == SimdLevel::SSE) {
+    end = transformSSE(transforms, corners);
+  }
+#endif
+  transformScalar(transforms, end, corners);
+}
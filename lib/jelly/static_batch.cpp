@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <iostream>
+
+#include <jelly/render_device.h>
+#include <jelly/renderer_2d.h>
+#include <jelly/static_batch.h>
+
+// Index that ends one outline loop and starts the next.
+const GLuint RESTART_INDEX = 0xFFFFFFFF;
+
+StaticBatch::StaticBatch()
+    : m_itemCount(0), m_dirtyBegin(0), m_dirtyEnd(0), m_indicesDirty(false),
+      m_triangleIndexCount(0), m_loopIndexCount(0), m_gpuSlotCapacity(0),
+      m_gpuIndexCapacity(0), m_stats() {}
+
+StaticItem StaticBatch::allocateSlot(bool filled) {
+  StaticItem item;
+  if (!m_freeSlots.empty()) {
+    item = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  } else {
+    item = static_cast<StaticItem>(m_slots.size());
+    m_slots.push_back({});
+    m_vertices.resize(m_vertices.size() + 4);
+  }
+
+  m_slots[item] = {true, filled, -1};
+  m_itemCount++;
+  m_indicesDirty = true;
+  return item;
+}
+
+void StaticBatch::markDirty(StaticItem item) {
+  if (m_dirtyBegin == m_dirtyEnd) {
+    m_dirtyBegin = item;
+    m_dirtyEnd = item + 1;
+    return;
+  }
+  m_dirtyBegin = std::min<size_t>(m_dirtyBegin, item);
+  m_dirtyEnd = std::max<size_t>(m_dirtyEnd, item + 1);
+}
+
+int StaticBatch::acquireTexture(const Texture *texture) {
+  auto slot = std::find(m_textures.begin(), m_textures.end(), texture);
+  if (slot == m_textures.end()) {
+    // Vertices hold slot indices, so freed slots are reused in place.
+    slot = std::find(m_textures.begin(), m_textures.end(), nullptr);
+    if (slot == m_textures.end()) {
+      if (m_textures.size() >= MAX_TEXTURE_SLOTS) {
+        std::cerr << "Error: Static batch has no texture slot left for "
+                  << "texture " << texture->getID() << std::endl;
+        return -1;
+      }
+      slot = m_textures.insert(m_textures.end(), nullptr);
+      m_textureRefs.push_back(0);
+    }
+    *slot = texture;
+  }
+
+  size_t index = slot - m_textures.begin();
+  m_textureRefs[index]++;
+  return static_cast<int>(index);
+}
+
+void StaticBatch::releaseTexture(int index) {
+  if (index < 0 || --m_textureRefs[index] > 0)
+    return;
+
+  m_textures[index] = nullptr;
+  while (!m_textures.empty() && m_textures.back() == nullptr) {
+    m_textures.pop_back();
+    m_textureRefs.pop_back();
+  }
+}
+
+bool StaticBatch::writeSprite(StaticItem item, const Sprite &sprite) {
+  // Taken before the old texture is released, so an item keeping its
+  // texture keeps its slot.
+  int textureIndex = acquireTexture(&sprite.getTexture());
+  if (textureIndex < 0)
+    return false;
+  releaseTexture(m_slots[item].texture);
+  m_slots[item].texture = textureIndex;
+
+  const Vec3<float> &position = sprite.getPosition();
+  m_transform.clear();
+  m_transform.push(Vec2<float>(position.x, position.y), sprite.getScaledSize(),
+                   sprite.getPivot(), sprite.getRotation().z);
+  float corner[8];
+  transformQuads(m_transform, corner);
+
+  const Vec4<float> uvRect = sprite.getUVRect();
+  const Vec4<float> &color = sprite.getColor();
+
+  using Format = VertexFormat<BatchQuadVertex>;
+  BatchQuadVertex *vertex = &m_vertices[item * 4];
+  vertex[0] = Format::make({corner[0], corner[1]}, {uvRect.x, uvRect.w}, color,
+                           textureIndex);
+  vertex[1] = Format::make({corner[2], corner[3]}, {uvRect.z, uvRect.w}, color,
+                           textureIndex);
+  vertex[2] = Format::make({corner[4], corner[5]}, {uvRect.z, uvRect.y}, color,
+                           textureIndex);
+  vertex[3] = Format::make({corner[6], corner[7]}, {uvRect.x, uvRect.y}, color,
+                           textureIndex);
+  markDirty(item);
+  return true;
+}
+
+StaticItem StaticBatch::add(const Sprite &sprite) {
+  StaticItem item = allocateSlot(true);
+  if (!writeSprite(item, sprite)) {
+    remove(item);
+    return INVALID_STATIC_ITEM;
+  }
+  return item;
+}
+
+StaticItem StaticBatch::add(const Rectangle &rectangle) {
+  StaticItem item = allocateSlot(rectangle.isFilled());
+  rectangle.emit(&m_vertices[item * 4]);
+  markDirty(item);
+  return item;
+}
+
+bool StaticBatch::update(StaticItem item, const Sprite &sprite) {
+  if (item >= m_slots.size() || !m_slots[item].live)
+    return false;
+
+  if (!writeSprite(item, sprite))
+    return false;
+  if (!m_slots[item].filled) {
+    m_slots[item].filled = true;
+    m_indicesDirty = true;
+  }
+  return true;
+}
+
+bool StaticBatch::update(StaticItem item, const Rectangle &rectangle) {
+  if (item >= m_slots.size() || !m_slots[item].live)
+    return false;
+
+  if (m_slots[item].filled != rectangle.isFilled()) {
+    m_slots[item].filled = rectangle.isFilled();
+    m_indicesDirty = true;
+  }
+  releaseTexture(m_slots[item].texture);
+  m_slots[item].texture = -1;
+  rectangle.emit(&m_vertices[item * 4]);
+  markDirty(item);
+  return true;
+}
+
+void StaticBatch::remove(StaticItem item) {
+  if (item >= m_slots.size() || !m_slots[item].live)
+    return;
+
+  // The vertices stay in place; dropping the slot from the index buffer is
+  // enough to stop drawing it.
+  m_slots[item].live = false;
+  releaseTexture(m_slots[item].texture);
+  m_slots[item].texture = -1;
+  m_freeSlots.push_back(item);
+  m_itemCount--;
+  m_indicesDirty = true;
+}
+
+void StaticBatch::clear() {
+  m_vertices.clear();
+  m_slots.clear();
+  m_freeSlots.clear();
+  m_textures.clear();
+  m_textureRefs.clear();
+  m_itemCount = 0;
+  m_dirtyBegin = 0;
+  m_dirtyEnd = 0;
+  m_indicesDirty = true;
+}
+
+void StaticBatch::buildIndices() {
+  m_indices.clear();
+  for (size_t i = 0; i < m_slots.size(); ++i) {
+    if (m_slots[i].live && m_slots[i].filled) {
+      GLuint base = static_cast<GLuint>(i * 4);
+      m_indices.insert(m_indices.end(),
+                       {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+  }
+  m_triangleIndexCount = m_indices.size();
+
+  for (size_t i = 0; i < m_slots.size(); ++i) {
+    if (m_slots[i].live && !m_slots[i].filled) {
+      GLuint base = static_cast<GLuint>(i * 4);
+      m_indices.insert(m_indices.end(), {base, base + 1, base + 2, base + 3,
+                                         RESTART_INDEX});
+    }
+  }
+  m_loopIndexCount = m_indices.size() - m_triangleIndexCount;
+}
+
+void StaticBatch::upload() {
+  size_t slotCount = m_slots.size();
+  if (slotCount > m_gpuSlotCapacity) {
+    // Grow geometrically so recording items across frames does not
+    // reallocate the buffers every frame.
+    size_t capacity = std::max(slotCount, m_gpuSlotCapacity * 2);
+
+    m_vao.Delete();
+    m_vbo.Delete();
+    m_ebo.Delete();
+    m_gpuIndexCapacity = 0;
+
+    m_vao.Init();
+    m_vao.Bind();
+    m_vbo.Init(nullptr, capacity * 4 * sizeof(BatchQuadVertex));
+    VertexFormat<BatchQuadVertex>::link(m_vao, m_vbo);
+    m_vao.Unbind();
+
+    m_gpuSlotCapacity = capacity;
+    m_dirtyBegin = 0;
+    m_dirtyEnd = slotCount;
+    m_indicesDirty = true;
+  }
+
+  if (m_dirtyBegin < m_dirtyEnd) {
+    GLsizeiptr slotBytes = 4 * sizeof(BatchQuadVertex);
+    GLsizeiptr size = (m_dirtyEnd - m_dirtyBegin) * slotBytes;
+    m_vbo.Update(&m_vertices[m_dirtyBegin * 4], size,
+                 m_dirtyBegin * slotBytes);
+    m_stats.uploads++;
+    m_stats.bytesUploaded += size;
+    m_dirtyBegin = 0;
+    m_dirtyEnd = 0;
+  }
+
+  if (m_indicesDirty) {
+    buildIndices();
+    GLsizeiptr size = m_indices.size() * sizeof(GLuint);
+
+    // The index buffer binding is part of the vertex array state.
+    m_vao.Bind();
+    if (m_indices.size() > m_gpuIndexCapacity) {
+      m_gpuIndexCapacity = std::max(m_indices.size(), m_gpuIndexCapacity * 2);
+      m_ebo.Delete();
+      m_ebo.Init(nullptr, m_gpuIndexCapacity * sizeof(GLuint));
+    }
+    if (size > 0) {
+      m_ebo.Update(m_indices.data(), size);
+    }
+    m_vao.Unbind();
+
+    m_stats.uploads++;
+    m_stats.bytesUploaded += size;
+    m_indicesDirty = false;
+  }
+}
+
+StaticBatchDraw StaticBatch::draw() {
+  upload();
+  StaticBatchDraw issued = {0, m_triangleIndexCount + m_loopIndexCount};
+  if (issued.indices == 0)
+    return issued;
+
+  RenderDevice &device = RenderDevice::get();
+  m_vao.Bind();
+  if (m_triangleIndexCount > 0) {
+    device.drawElements(GL_TRIANGLES,
+                        static_cast<GLsizei>(m_triangleIndexCount),
+                        GL_UNSIGNED_INT, nullptr);
+    issued.drawCalls++;
+  }
+  if (m_loopIndexCount > 0) {
+    size_t loopOffset = m_triangleIndexCount * sizeof(GLuint);
+    device.enable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+    device.drawElements(GL_LINE_LOOP, static_cast<GLsizei>(m_loopIndexCount),
+                        GL_UNSIGNED_INT,
+                        reinterpret_cast<void *>(loopOffset));
+    device.disable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+    issued.drawCalls++;
+  }
+  m_vao.Unbind();
+  return issued;
+}
+
+void StaticBatch::Delete() {
+  m_vao.Delete();
+  m_vbo.Delete();
+  m_ebo.Delete();
+  m_gpuSlotCapacity = 0;
+  m_gpuIndexCapacity = 0;
+  m_dirtyBegin = 0;
+  m_dirtyEnd = m_slots.size();
+  m_indicesDirty = true;
+}
+
+size_t StaticBatch::size() const { return m_itemCount; }
+
+const std::vector<const Texture *> &StaticBatch::getTextures() const {
+  return m_textures;
+}
+
+const StaticBatchStats &StaticBatch::getStats() const { return m_stats; }
@@ -0,0 +1,129 @@
+#include <iostream>
+
+#include <jelly/gl_state.h>
+#include <jelly/render_device.h>
+#include <jelly/stream_buffer.h>
+
+StreamBuffer::StreamBuffer()
+    : m_target(0), m_id(0), m_data(nullptr), m_regionSize(0),
+      m_regionCount(0), m_region(0), m_head(0) {}
+
+bool StreamBuffer::Init(GLenum target, GLuint id, GLsizeiptr regionSize,
+                        GLuint regionCount) {
+  m_target = target;
+  m_id = id;
+  m_regionSize = regionSize;
+  m_regionCount = regionCount;
+  m_region = 0;
+  m_head = 0;
+  m_fences.assign(regionCount, nullptr);
+  m_staging.clear();
+
+  GLbitfield flags =
+      GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  GLsizeiptr size = regionSize * regionCount;
+
+  // Dynamic storage keeps glBufferSubData allowed for the fallback below.
+  RenderDevice &device = RenderDevice::get();
+  GLState::bindBuffer(m_target, m_id);
+  device.bufferStorage(m_target, size, nullptr,
+                       flags | GL_DYNAMIC_STORAGE_BIT);
+  m_data = static_cast<unsigned char *>(
+      device.mapBufferRange(m_target, 0, size, flags));
+
+  if (m_data == nullptr) {
+    std::cerr << "Error: Failed to map streaming buffer " << m_id
+              << "; uploading with glBufferSubData instead" << std::endl;
+    m_staging.resize(size);
+    m_data = m_staging.data();
+    return false;
+  }
+  return true;
+}
+
+void StreamBuffer::waitRegion(GLuint region) {
+  GLsync fence = m_fences[region];
+  if (fence == nullptr)
+    return;
+
+  // Poll first: in the common case the GPU is frames ahead of this region.
+  RenderDevice &device = RenderDevice::get();
+  GLenum result = device.clientWaitSync(fence, 0, 0);
+  while (result == GL_TIMEOUT_EXPIRED) {
+    result =
+        device.clientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+  }
+  if (result == GL_WAIT_FAILED) {
+    std::cerr << "Error: Waiting on streaming buffer region " << region
+              << " failed" << std::endl;
+  }
+
+  device.deleteSync(fence);
+  m_fences[region] = nullptr;
+}
+
+void *StreamBuffer::Reserve(GLsizeiptr size) {
+  if (m_data == nullptr || size > m_regionSize) {
+    std::cerr << "Error: Streaming buffer reservation of " << size
+              << " bytes exceeds region size " << m_regionSize << std::endl;
+    return nullptr;
+  }
+
+  if (m_head + size > m_regionSize) {
+    NextRegion();
+  }
+
+  return m_data + m_region * m_regionSize + m_head;
+}
+
+void StreamBuffer::Commit(GLsizeiptr size) {
+  GLintptr offset = getOffset();
+  if (m_staging.empty()) {
+    RenderDevice::get().commitMappedRange(m_id, offset, size);
+  } else {
+    GLState::bindBuffer(m_target, m_id);
+    RenderDevice::get().bufferSubData(m_target, offset, size,
+                                      m_staging.data() + offset);
+  }
+  m_head += size;
+}
+
+void StreamBuffer::NextRegion() {
+  if (m_head == 0)
+    return;
+
+  m_fences[m_region] = RenderDevice::get().fenceSync();
+  m_region = (m_region + 1) % m_regionCount;
+  m_head = 0;
+
+  waitRegion(m_region);
+}
+
+void StreamBuffer::Delete() {
+  for (GLsync &fence : m_fences) {
+    if (fence != nullptr) {
+      RenderDevice::get().deleteSync(fence);
+      fence = nullptr;
+    }
+  }
+
+  if (isMapped()) {
+    GLState::bindBuffer(m_target, m_id);
+    RenderDevice::get().unmapBuffer(m_target);
+  }
+  m_data = nullptr;
+  m_staging.clear();
+  m_staging.shrink_to_fit();
+}
+
+GLsizeiptr StreamBuffer::getAvailable() const {
+  return m_regionSize - m_head;
+}
+
+GLintptr StreamBuffer::getOffset() const {
+  return m_region * m_regionSize + m_head;
+}
+
+bool StreamBuffer::isMapped() const {
+  return m_data != nullptr && m_staging.empty();
+}
@@ -1,11 +1,20 @@
+#include <jelly/gl_state.h>
+#include <jelly/profiler.h>
+#include <jelly/render_device.h>
 #include <jelly/texture.h>
 
+Texture::Texture()
+    : m_id(0), m_type(GL_TEXTURE_2D), m_slot(GL_TEXTURE0), m_width(0),
+      m_height(0) {}
+
 Texture::Texture(const char *path, GLenum texType, GLenum slot, GLenum format,
                  GLenum pixelType) {
+  JELLY_PROFILE_ZONE("Texture::load");
+  m_id = 0;
   m_type = texType;
   m_slot = slot;
 
-  int width, height, channels;
+  int width = 0, height = 0, channels = 0;
   unsigned char *data = load_image(path, width, height, channels);
 
   m_width = width;
@@ -16,38 +25,90 @@ Texture::Texture(const char *path, GLenum texType, GLenum slot, GLenum format,
     return;
   }
 
-  glGenTextures(1, &m_id);
-  glActiveTexture(m_slot);
-  glBindTexture(m_type, m_id);
+  RenderDevice &device = RenderDevice::get();
+  m_id = device.createTexture();
+  Bind(m_slot - GL_TEXTURE0);
 
-  glTexParameteri(m_type, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
-  glTexParameteri(m_type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  device.texParameteri(m_type, GL_TEXTURE_MIN_FILTER,
+                       GL_NEAREST_MIPMAP_NEAREST);
+  device.texParameteri(m_type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-  glTexParameteri(m_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(m_type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  device.texParameteri(m_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  device.texParameteri(m_type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-  glTexImage2D(m_type, 0, format, width, height, 0, format, pixelType, data);
-  glGenerateMipmap(m_type);
+  device.texImage2D(m_type, format, width, height, format, pixelType, data);
+  device.generateMipmap(m_type);
 
   free_image(data);
-  glBindTexture(m_type, 0);
+  Unbind();
 }
 
-const void Texture::texUnit(Shader shader, const char *uniform,
+Texture::Texture(int width, int height, GLenum texType, GLenum slot) {
+  m_type = texType;
+  m_slot = slot;
+  m_width = width;
+  m_height = height;
+
+  RenderDevice &device = RenderDevice::get();
+  m_id = device.createTexture();
+  Bind(m_slot - GL_TEXTURE0);
+
+  // No mipmaps: they would blend neighbouring sub-images together.
+  device.texParameteri(m_type, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  device.texParameteri(m_type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  device.texParameteri(m_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  device.texParameteri(m_type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  device.texImage2D(m_type, GL_RGBA8, width, height, GL_RGBA,
+                    GL_UNSIGNED_BYTE, nullptr);
+
+  Unbind();
+}
+
+void Texture::SetSubImage(int x, int y, int width, int height,
+                          const void *data, GLenum format,
+                          GLenum pixelType) const {
+  RenderDevice &device = RenderDevice::get();
+  Bind();
+  device.pixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  device.texSubImage2D(m_type, x, y, width, height, format, pixelType, data);
+  device.pixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  Unbind();
+}
+
+void Texture::GenerateMipmaps() const {
+  RenderDevice &device = RenderDevice::get();
+  Bind();
+  device.texParameteri(m_type, GL_TEXTURE_MIN_FILTER,
+                       GL_NEAREST_MIPMAP_NEAREST);
+  device.generateMipmap(m_type);
+  Unbind();
+}
+
+const void Texture::texUnit(const Shader &shader, const char *uniform,
                             GLuint unit) const {
-  GLint location = glGetUniformLocation(shader.GetID(), uniform);
+  GLint location = shader.getUniformLocation(uniform);
   if (location == -1) {
     std::cerr << "Error: Texture uniform '" << uniform
               << "' not found in shader!" << std::endl;
   }
-  glUniform1i(location, unit);
+  GLint value = static_cast<GLint>(unit);
+  RenderDevice::get().programUniform1iv(shader.GetID(), location, 1, &value);
 }
 
-void Texture::Bind() const { glBindTexture(m_type, m_id); }
+void Texture::Bind() const { GLState::bindTexture(m_type, m_id); }
+
+void Texture::Bind(GLuint unit) const {
+  GLState::bindTexture(unit, m_type, m_id);
+}
 
-void Texture::Unbind() const { glBindTexture(m_type, 0); }
+void Texture::Unbind() const { GLState::bindTexture(m_type, 0); }
 
-void Texture::Delete() { glDeleteTextures(1, &m_id); }
+void Texture::Delete() {
+  GLState::forgetTexture(m_id);
+  RenderDevice::get().deleteTexture(m_id);
+}
 
 int Texture::getWidth() const { return m_width; }
 
@@ -0,0 +1,346 @@
+#include <algorithm>
+#include <iostream>
+
+#include <jelly/image.h>
+#include <jelly/profiler.h>
+#include <jelly/render_device.h>
+#include <jelly/texture_atlas.h>
+#include <jelly/utils.h>
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : m_width(width), m_height(height) {
+  reset();
+}
+
+bool SkylinePacker::fits(size_t index, int width, int height, int &y) const {
+  int x = m_skyline[index].x;
+  if (x + width > m_width)
+    return false;
+
+  // The rectangle rests on the highest segment it spans.
+  y = m_skyline[index].y;
+  int widthLeft = width;
+  for (size_t i = index; widthLeft > 0; ++i) {
+    y = std::max(y, m_skyline[i].y);
+    if (y + height > m_height)
+      return false;
+    widthLeft -= m_skyline[i].width;
+  }
+  return true;
+}
+
+void SkylinePacker::place(size_t index, const AtlasRect &rect) {
+  Segment top = {rect.x, rect.y + rect.height, rect.width};
+  m_skyline.insert(m_skyline.begin() + index, top);
+
+  // Trim the segments now hidden under the new one.
+  int right = rect.x + rect.width;
+  size_t i = index + 1;
+  while (i < m_skyline.size() && m_skyline[i].x < right) {
+    int overlap = right - m_skyline[i].x;
+    if (overlap < m_skyline[i].width) {
+      m_skyline[i].x += overlap;
+      m_skyline[i].width -= overlap;
+      break;
+    }
+    m_skyline.erase(m_skyline.begin() + i);
+  }
+
+  // Merge neighbours of equal height to keep the skyline short.
+  for (size_t j = 0; j + 1 < m_skyline.size();) {
+    if (m_skyline[j].y == m_skyline[j + 1].y) {
+      m_skyline[j].width += m_skyline[j + 1].width;
+      m_skyline.erase(m_skyline.begin() + j + 1);
+    } else {
+      ++j;
+    }
+  }
+
+  m_usedArea += static_cast<size_t>(rect.width) * rect.height;
+}
+
+bool SkylinePacker::pack(int width, int height, AtlasRect &rect) {
+  if (width <= 0 || height <= 0)
+    return false;
+
+  size_t bestIndex = m_skyline.size();
+  int bestTop = m_height + 1;
+  int bestWidth = m_width + 1;
+  int bestY = 0;
+
+  for (size_t i = 0; i < m_skyline.size(); ++i) {
+    int y;
+    if (!fits(i, width, height, y))
+      continue;
+
+    // Bottom-left: lowest top edge, then the narrowest segment as tie break.
+    int top = y + height;
+    if (top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth)) {
+      bestIndex = i;
+      bestTop = top;
+      bestWidth = m_skyline[i].width;
+      bestY = y;
+    }
+  }
+
+  if (bestIndex == m_skyline.size())
+    return false;
+
+  rect = {m_skyline[bestIndex].x, bestY, width, height};
+  place(bestIndex, rect);
+  return true;
+}
+
+void SkylinePacker::reset() {
+  m_usedArea = 0;
+  m_skyline.clear();
+  m_skyline.push_back({0, 0, m_width});
+}
+
+float SkylinePacker::getOccupancy() const {
+  return static_cast<float>(m_usedArea) /
+         (static_cast<float>(m_width) * m_height);
+}
+
+size_t SkylinePacker::getUsedArea() const { return m_usedArea; }
+
+TextureAtlas::TextureAtlas(int pageSize, size_t maxPages, int padding)
+    : m_pageSize(pageSize), m_padding(padding), m_maxPages(maxPages),
+      m_stats() {}
+
+TextureAtlas::~TextureAtlas() {
+  for (Page &page : m_pages) {
+    page.texture->Delete();
+  }
+}
+
+bool TextureAtlas::allocate(int width, int height, size_t &pageIndex,
+                            AtlasRect &rect) {
+  int paddedWidth = width + m_padding;
+  int paddedHeight = height + m_padding;
+
+  pageIndex = m_pages.size();
+  for (size_t i = 0; i < m_pages.size(); ++i) {
+    if (m_pages[i].packer.pack(paddedWidth, paddedHeight, rect)) {
+      pageIndex = i;
+      break;
+    }
+  }
+
+  if (pageIndex == m_pages.size()) {
+    if (m_pages.size() >= m_maxPages)
+      return false;
+
+    Page page = {std::make_unique<Texture>(m_pageSize, m_pageSize),
+                 SkylinePacker(m_pageSize, m_pageSize)};
+    // Clear the page so padding texels are transparent.
+    RenderDevice::get().clearTexImage(page.texture->getID(), GL_RGBA,
+                                      GL_UNSIGNED_BYTE);
+    if (!page.packer.pack(paddedWidth, paddedHeight, rect)) {
+      page.texture->Delete();
+      return false;
+    }
+
+    m_pages.push_back(std::move(page));
+    pageIndex = m_pages.size() - 1;
+    m_stats.pageCount = m_pages.size();
+  }
+
+  rect.width = width;
+  rect.height = height;
+  return true;
+}
+
+void TextureAtlas::updateRegion(AtlasRegion &region, size_t pageIndex,
+                                const AtlasRect &rect) {
+  float size = static_cast<float>(m_pageSize);
+
+  region.page = m_pages[pageIndex].texture.get();
+  region.pageIndex = pageIndex;
+  region.rect = rect;
+  region.uvRect = Vec4<float>(rect.x / size, rect.y / size,
+                              (rect.x + rect.width) / size,
+                              (rect.y + rect.height) / size);
+}
+
+const AtlasRegion *TextureAtlas::add(const char *path) {
+  JELLY_PROFILE_ZONE("TextureAtlas::add");
+  int width, height, channels;
+  unsigned char *data = load_image(path, width, height, channels, 4);
+  if (!data) {
+    std::cerr << "Error: Failed to load atlas image: " << path << std::endl;
+    return nullptr;
+  }
+
+  const AtlasRegion *region = add(data, width, height);
+  free_image(data);
+  return region;
+}
+
+const AtlasRegion *TextureAtlas::add(const unsigned char *pixels, int width,
+                                     int height) {
+  if (width + m_padding > m_pageSize || height + m_padding > m_pageSize) {
+    std::cerr << "Error: Image of " << width << "x" << height
+              << " does not fit an atlas page of " << m_pageSize << std::endl;
+    m_stats.failedInserts++;
+    return nullptr;
+  }
+
+  size_t pageIndex = 0;
+  AtlasRect rect;
+  bool packed = allocate(width, height, pageIndex, rect);
+  if (!packed && m_stats.wastedArea > 0 && repack()) {
+    packed = allocate(width, height, pageIndex, rect);
+  }
+  if (!packed) {
+    m_stats.failedInserts++;
+    return nullptr;
+  }
+
+  m_pages[pageIndex].texture->SetSubImage(rect.x, rect.y, width, height,
+                                          pixels);
+
+  auto region = std::make_unique<AtlasRegion>();
+  updateRegion(*region, pageIndex, rect);
+  region->live = true;
+  m_regions.push_back(std::move(region));
+
+  size_t area = static_cast<size_t>(width) * height;
+  m_stats.regionCount++;
+  m_stats.usedArea += area;
+  m_stats.occupancy =
+      static_cast<float>(m_stats.usedArea) /
+      (static_cast<float>(m_pageSize) * m_pageSize * m_pages.size());
+  return m_regions.back().get();
+}
+
+void TextureAtlas::remove(const AtlasRegion *region) {
+  for (std::unique_ptr<AtlasRegion> &owned : m_regions) {
+    if (owned.get() != region || !owned->live)
+      continue;
+
+    size_t area = static_cast<size_t>(owned->rect.width) * owned->rect.height;
+    owned->live = false;
+    m_stats.regionCount--;
+    m_stats.usedArea -= area;
+    m_stats.wastedArea += area;
+    m_stats.evictions++;
+    m_stats.occupancy =
+        static_cast<float>(m_stats.usedArea) /
+        (static_cast<float>(m_pageSize) * m_pageSize * m_pages.size());
+    return;
+  }
+}
+
+bool TextureAtlas::repack() {
+  // Tallest first packs a skyline much tighter than insertion order.
+  std::vector<AtlasRegion *> order;
+  order.reserve(m_regions.size());
+  for (std::unique_ptr<AtlasRegion> &region : m_regions) {
+    if (region->live)
+      order.push_back(region.get());
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [](const AtlasRegion *a, const AtlasRegion *b) {
+                     return a->rect.height > b->rect.height;
+                   });
+
+  // Plan the new layout on scratch packers so a layout that does not fit
+  // leaves the pages and every region untouched.
+  std::vector<SkylinePacker> packers;
+  std::vector<size_t> newPages(order.size());
+  std::vector<AtlasRect> newRects(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    int paddedWidth = order[i]->rect.width + m_padding;
+    int paddedHeight = order[i]->rect.height + m_padding;
+
+    size_t pageIndex = packers.size();
+    for (size_t p = 0; p < packers.size(); ++p) {
+      if (packers[p].pack(paddedWidth, paddedHeight, newRects[i])) {
+        pageIndex = p;
+        break;
+      }
+    }
+
+    if (pageIndex == packers.size()) {
+      if (packers.size() >= m_pages.size())
+        return false;
+      packers.emplace_back(m_pageSize, m_pageSize);
+      if (!packers.back().pack(paddedWidth, paddedHeight, newRects[i]))
+        return false;
+    }
+
+    newPages[i] = pageIndex;
+    newRects[i].width = order[i]->rect.width;
+    newRects[i].height = order[i]->rect.height;
+  }
+
+  size_t pageBytes = static_cast<size_t>(m_pageSize) * m_pageSize * 4;
+  std::vector<std::vector<unsigned char>> oldPixels(m_pages.size());
+
+  // Read every page back before any of them is overwritten.
+  RenderDevice &device = RenderDevice::get();
+  device.pixelStorei(GL_PACK_ALIGNMENT, 1);
+  for (size_t i = 0; i < m_pages.size(); ++i) {
+    oldPixels[i].resize(pageBytes);
+    m_pages[i].texture->Bind();
+    device.getTexImage(GL_TEXTURE_2D, GL_RGBA, GL_UNSIGNED_BYTE,
+                       oldPixels[i].data());
+    device.clearTexImage(m_pages[i].texture->getID(), GL_RGBA,
+                         GL_UNSIGNED_BYTE);
+  }
+  device.pixelStorei(GL_PACK_ALIGNMENT, 4);
+
+  std::vector<unsigned char> block;
+  for (size_t i = 0; i < order.size(); ++i) {
+    AtlasRegion *region = order[i];
+    const AtlasRect &old = region->rect;
+    const AtlasRect &rect = newRects[i];
+
+    block.resize(static_cast<size_t>(old.width) * old.height * 4);
+    for (int row = 0; row < old.height; ++row) {
+      const unsigned char *src =
+          oldPixels[region->pageIndex].data() +
+          (static_cast<size_t>(old.y + row) * m_pageSize + old.x) * 4;
+      std::copy(src, src + old.width * 4,
+                block.data() + static_cast<size_t>(row) * old.width * 4);
+    }
+    m_pages[newPages[i]].texture->SetSubImage(rect.x, rect.y, rect.width,
+                                              rect.height, block.data());
+
+    updateRegion(*region, newPages[i], rect);
+  }
+
+  m_regions.erase(std::remove_if(m_regions.begin(), m_regions.end(),
+                                 [](const std::unique_ptr<AtlasRegion> &r) {
+                                   return !r->live;
+                                 }),
+                  m_regions.end());
+
+  // Only pages no live region was planned onto are freed.
+  for (size_t i = 0; i < packers.size(); ++i) {
+    m_pages[i].packer = packers[i];
+  }
+  while (m_pages.size() > packers.size()) {
+    m_pages.back().texture->Delete();
+    m_pages.pop_back();
+  }
+
+  m_stats.pageCount = m_pages.size();
+  m_stats.wastedArea = 0;
+  m_stats.repacks++;
+  m_stats.occupancy =
+      m_pages.empty()
+          ? 0.0f
+          : static_cast<float>(m_stats.usedArea) /
+                (static_cast<float>(m_pageSize) * m_pageSize * m_pages.size());
+  return true;
+}
+
+const AtlasStats &TextureAtlas::getStats() const { return m_stats; }
+
+size_t TextureAtlas::getPageCount() const { return m_pages.size(); }
+
+const Texture &TextureAtlas::getPage(size_t index) const {
+  return *m_pages[index].texture;
+}
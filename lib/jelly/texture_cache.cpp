@@ -0,0 +1,190 @@
+#include <filesystem>
+#include <utility>
+
+#include <jelly/texture_cache.h>
+#include <jelly/texture_loader.h>
+
+namespace {
+
+size_t bytesPerPixel(GLenum format) {
+  switch (format) {
+  case GL_RED:
+    return 1;
+  case GL_RG:
+    return 2;
+  case GL_RGB:
+    return 3;
+  default:
+    return 4;
+  }
+}
+
+std::string makeKey(const char *path, GLenum texType, GLenum format,
+                    GLenum pixelType) {
+  std::error_code error;
+  std::filesystem::path canonical =
+      std::filesystem::weakly_canonical(path, error);
+  std::string key = error ? std::string(path) : canonical.string();
+  key += "|" + std::to_string(texType) + "|" + std::to_string(format) + "|" +
+         std::to_string(pixelType);
+  return key;
+}
+
+} // namespace
+
+TextureHandle::TextureHandle() : m_entry(nullptr) {}
+
+TextureHandle::TextureHandle(TextureEntry *entry) : m_entry(entry) {
+  if (m_entry != nullptr)
+    m_entry->refCount++;
+}
+
+TextureHandle::TextureHandle(const TextureHandle &other)
+    : TextureHandle(other.m_entry) {}
+
+TextureHandle::TextureHandle(TextureHandle &&other) noexcept
+    : m_entry(std::exchange(other.m_entry, nullptr)) {}
+
+TextureHandle &TextureHandle::operator=(TextureHandle other) noexcept {
+  std::swap(m_entry, other.m_entry);
+  return *this;
+}
+
+TextureHandle::~TextureHandle() { release(); }
+
+void TextureHandle::release() {
+  if (m_entry == nullptr || --m_entry->refCount > 0)
+    return;
+
+  if (m_entry->cache != nullptr) {
+    m_entry->cache->release(m_entry);
+  } else {
+    // Uncached textures are freed here; a cleared cache already freed its
+    // textures and marked them failed.
+    if (m_entry->state == TextureState::Ready)
+      m_entry->texture.Delete();
+    delete m_entry;
+  }
+  m_entry = nullptr;
+}
+
+const Texture &TextureHandle::get() const { return m_entry->texture; }
+
+const Texture &TextureHandle::operator*() const { return m_entry->texture; }
+
+const Texture *TextureHandle::operator->() const { return &m_entry->texture; }
+
+TextureHandle::operator bool() const { return m_entry != nullptr; }
+
+bool TextureHandle::isReady() const {
+  return m_entry != nullptr && m_entry->state == TextureState::Ready;
+}
+
+TextureState TextureHandle::getState() const {
+  return m_entry != nullptr ? m_entry->state : TextureState::Failed;
+}
+
+size_t TextureHandle::getRefCount() const {
+  return m_entry != nullptr ? m_entry->refCount : 0;
+}
+
+TextureCache::TextureCache() : m_stats() {}
+
+TextureCache::~TextureCache() { clear(); }
+
+TextureHandle TextureCache::load(const char *path, GLenum texType,
+                                 GLenum format, GLenum pixelType) {
+  std::string key = makeKey(path, texType, format, pixelType);
+
+  auto it = m_entries.find(key);
+  if (it != m_entries.end()) {
+    m_stats.hits++;
+    return TextureHandle(it->second);
+  }
+
+  m_stats.misses++;
+  TextureEntry *entry =
+      new TextureEntry{Texture(path, texType, GL_TEXTURE0, format, pixelType),
+                       key, 0, 0, this, TextureState::Failed};
+
+  // Failed entries stay cached so the file is not retried on every load, but
+  // hold no texture and count no memory.
+  if (entry->texture.getID() != 0) {
+    // Mipmaps add a third on top of the base level.
+    size_t texels = static_cast<size_t>(entry->texture.getWidth()) *
+                    entry->texture.getHeight();
+    entry->bytes = texels * bytesPerPixel(format) * 4 / 3;
+    entry->state = TextureState::Ready;
+  }
+
+  m_entries.emplace(key, entry);
+  m_stats.textureCount++;
+  m_stats.memoryBytes += entry->bytes;
+  return TextureHandle(entry);
+}
+
+TextureHandle TextureCache::loadAsync(const char *path,
+                                      TextureLoader &loader) {
+  std::string key = makeKey(path, GL_TEXTURE_2D, GL_RGBA, GL_UNSIGNED_BYTE);
+
+  auto it = m_entries.find(key);
+  if (it != m_entries.end()) {
+    m_stats.hits++;
+    return TextureHandle(it->second);
+  }
+
+  m_stats.misses++;
+  TextureEntry *entry = new TextureEntry{
+      loader.getPlaceholder(), key, 0, 0, this, TextureState::Loading};
+  m_entries.emplace(key, entry);
+  m_stats.textureCount++;
+
+  TextureHandle handle(entry);
+  loader.enqueue(handle, path);
+  return handle;
+}
+
+TextureHandle TextureCache::loadUncached(const char *path, GLenum texType,
+                                         GLenum format, GLenum pixelType) {
+  TextureEntry *entry =
+      new TextureEntry{Texture(path, texType, GL_TEXTURE0, format, pixelType),
+                       path, 0, 0, nullptr, TextureState::Failed};
+  if (entry->texture.getID() != 0)
+    entry->state = TextureState::Ready;
+  return TextureHandle(entry);
+}
+
+void TextureCache::finishLoad(TextureEntry *entry, const Texture &texture,
+                              size_t bytes) {
+  entry->texture = texture;
+  entry->bytes = bytes;
+  entry->state = TextureState::Ready;
+  m_stats.memoryBytes += bytes;
+}
+
+void TextureCache::release(TextureEntry *entry) {
+  m_entries.erase(entry->key);
+  m_stats.evictions++;
+  m_stats.textureCount--;
+  m_stats.memoryBytes -= entry->bytes;
+
+  // Loading and failed entries point at the shared placeholder.
+  if (entry->state == TextureState::Ready)
+    entry->texture.Delete();
+  delete entry;
+}
+
+void TextureCache::clear() {
+  for (auto &[key, entry] : m_entries) {
+    if (entry->state == TextureState::Ready)
+      entry->texture.Delete();
+    entry->cache = nullptr;
+    entry->state = TextureState::Failed;
+  }
+
+  m_entries.clear();
+  m_stats.textureCount = 0;
+  m_stats.memoryBytes = 0;
+}
+
+const TextureCacheStats &TextureCache::getStats() const { return m_stats; }
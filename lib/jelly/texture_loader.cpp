@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include <jelly/gl_state.h>
+#include <jelly/image.h>
+#include <jelly/profiler.h>
+#include <jelly/render_device.h>
+#include <jelly/texture_loader.h>
+#include <jelly/utils.h>
+
+TextureLoader::TextureLoader()
+    : m_decoding(0), m_stopping(false), m_pbo(0), m_uploadBudget(0),
+      m_stats() {}
+
+TextureLoader::~TextureLoader() {
+  if (!m_workers.empty()) {
+    std::cerr << "Error: TextureLoader destroyed without shutdown()"
+              << std::endl;
+  }
+}
+
+void TextureLoader::init(size_t threadCount, size_t uploadBudget) {
+  if (threadCount == 0) {
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+  }
+
+  m_uploadBudget = uploadBudget;
+  m_stopping = false;
+
+  m_pbo = RenderDevice::get().createBuffer();
+  m_staging.Init(GL_PIXEL_UNPACK_BUFFER, m_pbo, uploadBudget,
+                 STREAM_REGION_COUNT);
+  GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  const unsigned char grey[4] = {128, 128, 128, 255};
+  m_placeholder = Texture(1, 1);
+  m_placeholder.SetSubImage(0, 0, 1, 1, grey);
+
+  for (size_t i = 0; i < threadCount; ++i) {
+    m_workers.emplace_back(&TextureLoader::workerLoop, this);
+  }
+}
+
+void TextureLoader::shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_wakeup.notify_all();
+
+  for (std::thread &worker : m_workers) {
+    worker.join();
+  }
+  m_workers.clear();
+
+  // Drop unfinished loads; their entries keep the placeholder.
+  auto drop = [](std::deque<std::unique_ptr<LoadJob>> &jobs) {
+    for (std::unique_ptr<LoadJob> &job : jobs) {
+      if (job->pixels != nullptr)
+        free_image(job->pixels);
+      if (job->texture.getID() != 0)
+        job->texture.Delete();
+    }
+    jobs.clear();
+  };
+  drop(m_pending);
+  drop(m_decoded);
+  drop(m_uploading);
+
+  if (m_pbo != 0) {
+    m_staging.Delete();
+    GLState::forgetBuffer(m_pbo);
+    RenderDevice::get().deleteBuffer(m_pbo);
+    m_pbo = 0;
+    m_placeholder.Delete();
+  }
+}
+
+void TextureLoader::workerLoop() {
+  JELLY_PROFILE_THREAD("TextureLoader worker");
+  while (true) {
+    std::unique_ptr<LoadJob> job;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wakeup.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+      if (m_stopping)
+        return;
+      job = std::move(m_pending.front());
+      m_pending.pop_front();
+      // Counted until it reaches m_decoded, so the loader is not idle while
+      // the job is only held by this thread.
+      m_decoding++;
+    }
+
+    {
+      JELLY_PROFILE_ZONE("TextureLoader::decode");
+      int channels;
+      job->pixels = load_image(job->path.c_str(), job->width, job->height,
+                               channels, 4);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_decoded.push_back(std::move(job));
+    m_decoding--;
+  }
+}
+
+void TextureLoader::enqueue(const TextureHandle &handle, const char *path) {
+  auto job = std::make_unique<LoadJob>(
+      LoadJob{handle, path, nullptr, 0, 0, 0, Texture()});
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.push_back(std::move(job));
+  }
+  m_wakeup.notify_one();
+}
+
+void TextureLoader::finish(LoadJob &job) {
+  TextureEntry *entry = job.handle.m_entry;
+  size_t bytes = static_cast<size_t>(job.width) * job.height * 4;
+  // Mipmaps add a third on top of the base level.
+  bytes = bytes * 4 / 3;
+
+  if (entry->cache != nullptr) {
+    entry->cache->finishLoad(entry, job.texture, bytes);
+  } else {
+    job.texture.Delete();
+  }
+
+  free_image(job.pixels);
+  job.pixels = nullptr;
+  m_stats.completed++;
+}
+
+void TextureLoader::update() {
+  JELLY_PROFILE_ZONE("TextureLoader::update");
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (std::unique_ptr<LoadJob> &job : m_decoded) {
+      m_uploading.push_back(std::move(job));
+    }
+    m_decoded.clear();
+  }
+
+  while (!m_uploading.empty()) {
+    LoadJob &job = *m_uploading.front();
+
+    GLsizeiptr rowBytes = static_cast<GLsizeiptr>(job.width) * 4;
+    if (job.pixels == nullptr ||
+        rowBytes > static_cast<GLsizeiptr>(m_uploadBudget)) {
+      std::cerr << "Error: Failed to load texture: " << job.path << std::endl;
+      if (job.pixels != nullptr)
+        free_image(job.pixels);
+      job.handle.m_entry->state = TextureState::Failed;
+      m_stats.failed++;
+      m_uploading.pop_front();
+      continue;
+    }
+
+    // Upload as many whole rows as the rest of this frame's budget allows.
+    GLsizeiptr rowsLeft = job.height - job.rowsUploaded;
+    GLsizeiptr rowsFit = m_staging.getAvailable() / rowBytes;
+    GLsizeiptr rows = std::min(rowsLeft, rowsFit);
+    if (rows == 0)
+      break;
+
+    if (job.texture.getID() == 0) {
+      job.texture = Texture(job.width, job.height);
+    }
+
+    GLsizeiptr size = rows * rowBytes;
+    void *staging = m_staging.Reserve(size);
+    std::memcpy(staging, job.pixels + job.rowsUploaded * rowBytes, size);
+
+    // With a pixel unpack buffer bound, the data pointer is a buffer offset.
+    // Committing first uploads the rows when the buffer is not mapped.
+    const void *offset = reinterpret_cast<const void *>(
+        static_cast<uintptr_t>(m_staging.getOffset()));
+    m_staging.Commit(size);
+    GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+    job.texture.SetSubImage(0, job.rowsUploaded, job.width,
+                            static_cast<int>(rows), offset);
+    GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    m_stats.bytesUploaded += size;
+    job.rowsUploaded += static_cast<int>(rows);
+
+    if (job.rowsUploaded == job.height) {
+      job.texture.GenerateMipmaps();
+      finish(job);
+      m_uploading.pop_front();
+    }
+  }
+
+  // The next frame writes to a fresh region while the GPU reads this one.
+  m_staging.NextRegion();
+}
+
+bool TextureLoader::isIdle() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pending.empty() && m_decoding == 0 && m_decoded.empty() &&
+         m_uploading.empty();
+}
+
+const Texture &TextureLoader::getPlaceholder() const { return m_placeholder; }
+
+TextureLoaderStats TextureLoader::getStats() {
+  TextureLoaderStats stats = m_stats;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  stats.queued = m_pending.size() + m_decoding;
+  stats.uploading = m_decoded.size() + m_uploading.size();
+  return stats;
+}
@@ -1,28 +1,48 @@
+#include <jelly/gl_state.h>
+#include <jelly/render_device.h>
 #include <jelly/vao.h>
-#include <jelly/utils.h>
 
 VAO::VAO() : m_id(0) {}
 
-void VAO::Init() { GL_CHECK(glGenVertexArrays(1, &m_id)); }
+void VAO::Init() { m_id = RenderDevice::get().createVertexArray(); }
 
-void VAO::Bind() const { GL_CHECK(glBindVertexArray(m_id)); }
+void VAO::Bind() const { GLState::bindVertexArray(m_id); }
 
-void VAO::Unbind() const { GL_CHECK(glBindVertexArray(0)); }
+void VAO::Unbind() const { GLState::bindVertexArray(0); }
 
 void VAO::Delete() {
   if (m_id != 0) {
     Unbind();
-    GL_CHECK(glDeleteVertexArrays(1, &m_id));
+    GLState::forgetVertexArray(m_id);
+    RenderDevice::get().deleteVertexArray(m_id);
     m_id = 0; // Reset to prevent accidental re-deletion
   }
 }
 
-void VAO::LinkAttrib(VBO vbo, GLuint layout, GLuint numComponents, GLenum type,
-                     GLsizeiptr stride, GLvoid *offset) {
+void VAO::LinkAttrib(const VBO &vbo, GLuint layout, GLuint numComponents,
+                     GLenum type, GLsizeiptr stride, GLvoid *offset,
+                     GLuint divisor, GLboolean normalized) {
+  RenderDevice &device = RenderDevice::get();
   vbo.Bind();
-  GL_CHECK(glVertexAttribPointer(layout, numComponents, type, GL_FALSE, stride,
-                                 offset));
-  GL_CHECK(glEnableVertexAttribArray(layout));
+  device.vertexAttribPointer(layout, numComponents, type, normalized,
+                             static_cast<GLsizei>(stride), offset);
+  device.enableVertexAttribArray(layout);
+  if (divisor != 0) {
+    device.vertexAttribDivisor(layout, divisor);
+  }
+}
+
+void VAO::LinkAttribI(const VBO &vbo, GLuint layout, GLuint numComponents,
+                      GLenum type, GLsizeiptr stride, GLvoid *offset,
+                      GLuint divisor) {
+  RenderDevice &device = RenderDevice::get();
+  vbo.Bind();
+  device.vertexAttribIPointer(layout, numComponents, type,
+                              static_cast<GLsizei>(stride), offset);
+  device.enableVertexAttribArray(layout);
+  if (divisor != 0) {
+    device.vertexAttribDivisor(layout, divisor);
+  }
 }
 
 const GLuint VAO::getID() const { return m_id; }
\ No newline at end of file
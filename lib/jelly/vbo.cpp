@@ -1,27 +1,46 @@
+#include <jelly/gl_state.h>
+#include <jelly/render_device.h>
 #include <jelly/vbo.h>
-#include <jelly/utils.h>
 
 VBO::VBO() : m_id(0) {}
 
 void VBO::Init(const void *vertices, GLsizeiptr size) {
-  GL_CHECK(glGenBuffers(1, &m_id));
-  GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, m_id));
-  GL_CHECK(glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_DYNAMIC_DRAW));
+  m_id = RenderDevice::get().createBuffer();
+  Bind();
+  RenderDevice::get().bufferData(GL_ARRAY_BUFFER, size, vertices,
+                                 GL_DYNAMIC_DRAW);
 }
 
-void VBO::Update(const void *vertices, GLsizeiptr size) {
+void VBO::Update(const void *vertices, GLsizeiptr size, GLintptr offset) {
   Bind();
-  GL_CHECK(glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices));
+  RenderDevice::get().bufferSubData(GL_ARRAY_BUFFER, offset, size, vertices);
+}
+
+bool VBO::InitStreaming(GLsizeiptr regionSize, GLuint regionCount) {
+  m_id = RenderDevice::get().createBuffer();
+  return m_stream.Init(GL_ARRAY_BUFFER, m_id, regionSize, regionCount);
 }
 
-void VBO::Bind() const { GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, m_id)); }
+void *VBO::Reserve(GLsizeiptr size) { return m_stream.Reserve(size); }
+
+void VBO::Commit(GLsizeiptr size) { m_stream.Commit(size); }
+
+void VBO::NextRegion() { m_stream.NextRegion(); }
+
+GLsizeiptr VBO::getAvailable() const { return m_stream.getAvailable(); }
+
+GLintptr VBO::getStreamOffset() const { return m_stream.getOffset(); }
+
+void VBO::Bind() const { GLState::bindBuffer(GL_ARRAY_BUFFER, m_id); }
 
-void VBO::Unbind() const { GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0)); }
+void VBO::Unbind() const { GLState::bindBuffer(GL_ARRAY_BUFFER, 0); }
 
 void VBO::Delete() {
   if (m_id != 0) {
+    m_stream.Delete();
     Unbind();
-    GL_CHECK(glDeleteBuffers(1, &m_id));
+    GLState::forgetBuffer(m_id);
+    RenderDevice::get().deleteBuffer(m_id);
     m_id = 0; // Reset to prevent accidental re-deletion
   }
 }
@@ -0,0 +1,49 @@
+#include <cstddef>
+
+#include <jelly/vertex_format.h>
+
+void VertexFormat<QuadVertex>::link(VAO &vao, const VBO &vbo) {
+  vao.LinkAttrib(vbo, 0, 2, GL_FLOAT, sizeof(QuadVertex),
+                 (void *)offsetof(QuadVertex, position));
+  vao.LinkAttrib(vbo, 1, 2, GL_FLOAT, sizeof(QuadVertex),
+                 (void *)offsetof(QuadVertex, uv));
+  vao.LinkAttrib(vbo, 2, 4, GL_FLOAT, sizeof(QuadVertex),
+                 (void *)offsetof(QuadVertex, color));
+  vao.LinkAttrib(vbo, 3, 1, GL_FLOAT, sizeof(QuadVertex),
+                 (void *)offsetof(QuadVertex, textureIndex));
+}
+
+void VertexFormat<PackedQuadVertex>::link(VAO &vao, const VBO &vbo) {
+  vao.LinkAttrib(vbo, 0, 2, GL_FLOAT, sizeof(PackedQuadVertex),
+                 (void *)offsetof(PackedQuadVertex, position));
+  vao.LinkAttrib(vbo, 1, 2, GL_UNSIGNED_SHORT, sizeof(PackedQuadVertex),
+                 (void *)offsetof(PackedQuadVertex, uv), 0, GL_TRUE);
+  vao.LinkAttrib(vbo, 2, 4, GL_UNSIGNED_BYTE, sizeof(PackedQuadVertex),
+                 (void *)offsetof(PackedQuadVertex, color), 0, GL_TRUE);
+  vao.LinkAttribI(vbo, 3, 1, GL_INT, sizeof(PackedQuadVertex),
+                  (void *)offsetof(PackedQuadVertex, textureIndex));
+}
+
+// Circle attributes advance once per instance; the quad corners come from
+// gl_VertexID.
+void VertexFormat<CircleInstance>::link(VAO &vao, const VBO &vbo) {
+  vao.LinkAttrib(vbo, 0, 2, GL_FLOAT, sizeof(CircleInstance),
+                 (void *)offsetof(CircleInstance, center), 1);
+  vao.LinkAttrib(vbo, 1, 1, GL_FLOAT, sizeof(CircleInstance),
+                 (void *)offsetof(CircleInstance, radius), 1);
+  vao.LinkAttrib(vbo, 2, 1, GL_FLOAT, sizeof(CircleInstance),
+                 (void *)offsetof(CircleInstance, strokeWidth), 1);
+  vao.LinkAttrib(vbo, 3, 4, GL_FLOAT, sizeof(CircleInstance),
+                 (void *)offsetof(CircleInstance, color), 1);
+}
+
+void VertexFormat<PackedCircleInstance>::link(VAO &vao, const VBO &vbo) {
+  vao.LinkAttrib(vbo, 0, 2, GL_FLOAT, sizeof(PackedCircleInstance),
+                 (void *)offsetof(PackedCircleInstance, center), 1);
+  vao.LinkAttrib(vbo, 1, 1, GL_FLOAT, sizeof(PackedCircleInstance),
+                 (void *)offsetof(PackedCircleInstance, radius), 1);
+  vao.LinkAttrib(vbo, 2, 1, GL_FLOAT, sizeof(PackedCircleInstance),
+                 (void *)offsetof(PackedCircleInstance, strokeWidth), 1);
+  vao.LinkAttrib(vbo, 3, 4, GL_UNSIGNED_BYTE, sizeof(PackedCircleInstance),
+                 (void *)offsetof(PackedCircleInstance, color), 1, GL_TRUE);
+}
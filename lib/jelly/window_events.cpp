@@ -0,0 +1,141 @@
+#include <jelly/window_events.h>
+
+namespace {
+
+const size_t WINDOW_EVENT_TYPE_COUNT = 4;
+
+WindowState readState(GLFWwindow *window) {
+  WindowState state;
+  glfwGetWindowSize(window, &state.width, &state.height);
+  glfwGetFramebufferSize(window, &state.framebufferWidth,
+                         &state.framebufferHeight);
+  glfwGetWindowContentScale(window, &state.xScale, &state.yScale);
+  state.focused = glfwGetWindowAttrib(window, GLFW_FOCUSED) != 0;
+  return state;
+}
+
+// Applies an event to the state and reports whether it changed anything.
+bool apply(WindowState &state, const WindowEvent &event) {
+  switch (event.type) {
+  case WindowEventType::Resize:
+    if (state.width == event.width && state.height == event.height)
+      return false;
+    state.width = event.width;
+    state.height = event.height;
+    return true;
+  case WindowEventType::FramebufferResize:
+    if (state.framebufferWidth == event.width &&
+        state.framebufferHeight == event.height)
+      return false;
+    state.framebufferWidth = event.width;
+    state.framebufferHeight = event.height;
+    return true;
+  case WindowEventType::ContentScale:
+    if (state.xScale == event.xScale && state.yScale == event.yScale)
+      return false;
+    state.xScale = event.xScale;
+    state.yScale = event.yScale;
+    return true;
+  case WindowEventType::Focus:
+    if (state.focused == event.focused)
+      return false;
+    state.focused = event.focused;
+    return true;
+  }
+  return false;
+}
+
+WindowEvents *eventsOf(GLFWwindow *window) {
+  return static_cast<WindowEvents *>(glfwGetWindowUserPointer(window));
+}
+
+} // namespace
+
+WindowEvents::WindowEvents() : m_window(nullptr), m_overflowed(false) {
+  m_events.reserve(WINDOW_EVENT_TYPE_COUNT);
+}
+
+void WindowEvents::attach(GLFWwindow *window) {
+  m_window = window;
+  m_state = readState(window);
+
+  glfwSetWindowUserPointer(window, this);
+  glfwSetWindowSizeCallback(window, onWindowSize);
+  glfwSetFramebufferSizeCallback(window, onFramebufferSize);
+  glfwSetWindowContentScaleCallback(window, onContentScale);
+  glfwSetWindowFocusCallback(window, onFocus);
+}
+
+void WindowEvents::setState(const WindowState &state) { m_state = state; }
+
+bool WindowEvents::push(const WindowEvent &event) {
+  if (!m_queue.push(event)) {
+    m_overflowed.store(true, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+const std::vector<WindowEvent> &WindowEvents::poll() {
+  // Only the latest event of each type matters; earlier ones were
+  // superseded before anyone could see them.
+  WindowEvent latest[WINDOW_EVENT_TYPE_COUNT];
+  bool seen[WINDOW_EVENT_TYPE_COUNT] = {};
+
+  WindowEvent event;
+  while (m_queue.pop(event)) {
+    size_t index = static_cast<size_t>(event.type);
+    latest[index] = event;
+    seen[index] = true;
+  }
+
+  if (m_overflowed.exchange(false, std::memory_order_relaxed) &&
+      m_window != nullptr) {
+    // Dropped events may have been the latest ones, so ask GLFW instead.
+    WindowState state = readState(m_window);
+    latest[0] = {WindowEventType::Resize, state.width, state.height};
+    latest[1] = {WindowEventType::FramebufferResize, state.framebufferWidth,
+                 state.framebufferHeight};
+    latest[2] = {WindowEventType::ContentScale};
+    latest[2].xScale = state.xScale;
+    latest[2].yScale = state.yScale;
+    latest[3] = {WindowEventType::Focus};
+    latest[3].focused = state.focused;
+    for (bool &type : seen) {
+      type = true;
+    }
+  }
+
+  m_events.clear();
+  for (size_t i = 0; i < WINDOW_EVENT_TYPE_COUNT; ++i) {
+    if (seen[i] && apply(m_state, latest[i])) {
+      m_events.push_back(latest[i]);
+    }
+  }
+  return m_events;
+}
+
+const WindowState &WindowEvents::getState() const { return m_state; }
+
+void WindowEvents::onWindowSize(GLFWwindow *window, int width, int height) {
+  eventsOf(window)->push({WindowEventType::Resize, width, height});
+}
+
+void WindowEvents::onFramebufferSize(GLFWwindow *window, int width,
+                                     int height) {
+  eventsOf(window)->push({WindowEventType::FramebufferResize, width, height});
+}
+
+void WindowEvents::onContentScale(GLFWwindow *window, float xScale,
+                                  float yScale) {
+  WindowEvent event{WindowEventType::ContentScale};
+  event.xScale = xScale;
+  event.yScale = yScale;
+  eventsOf(window)->push(event);
+}
+
+void WindowEvents::onFocus(GLFWwindow *window, int focused) {
+  WindowEvent event{WindowEventType::Focus};
+  event.focused = focused == GLFW_TRUE;
+  eventsOf(window)->push(event);
+}
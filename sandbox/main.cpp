@@ -10,6 +10,7 @@
 #include <jelly/sprite.h>
 #include <jelly/rectangle.h>
 #include <jelly/circle.h>
+#include <jelly/static_batch.h>
 #include <jelly/vec.h>
 
 int main() {
@@ -22,6 +23,12 @@ int main() {
   Sprite doomguy("textures/doomguy.png");
   doomguy.setPosition(Vec3<float>(200, 100, 1));
 
+  // Streams in over a few frames; the loader's placeholder is drawn until then.
+  Sprite psyduck(ctx.getTextureCache().loadAsync("textures/psyduck.png",
+                                                 ctx.getTextureLoader()),
+                 Vec4<float>(1.0f, 1.0f, 1.0f, 1.0f), 64, 64);
+  psyduck.setPosition(Vec3<float>(300, 100, 1));
+
   Circle circle(Vec2<float>(300, 300), 100.0f, false,
                 Vec4<float>(0.0f, 1.0f, 0.0f, 1.0f));
 
@@ -45,30 +52,72 @@ int main() {
                        Vec2<float>(wWidth - wallThickness, wallThickness),
                        Vec4<float>(0.0f, 1.0f, 1.0f, 1.0f), false);
 
-  while (!glfwWindowShouldClose(ctx.getWindow())) {
+  // The walls never change, so they are recorded once and redrawn from GPU
+  // memory every frame.
+  StaticBatch walls;
+  walls.add(leftWall);
+  walls.add(rightWall);
+  walls.add(topWall);
+  walls.add(bottomWall);
+
+  // Sort queued draws by layer and state so the interleaved order below does
+  // not break batches.
+  ctx.getRenderer().setSortMode(RenderSortMode::Batch);
+
+  // The martian paces between the walls at a fixed simulation rate and is
+  // drawn between its last two positions, so it moves smoothly at any frame
+  // rate.
+  float martianSpeed = 120.0f;
+  float martianX = 100.0f;
+  float previousMartianX = martianX;
+
+  // Doomguy walks with the arrow keys or WASD; Escape quits.
+  float doomguySpeed = 200.0f;
+
+  auto update = [&](double step) {
+    previousMartianX = martianX;
+    martianX += martianSpeed * static_cast<float>(step);
+    if (martianX < wallThickness || martianX > wWidth - wallThickness - 64) {
+      martianSpeed = -martianSpeed;
+    }
+
+    const InputSnapshot &input = ctx.getInput().getSnapshot();
+    if (input.isKeyDown(GLFW_KEY_ESCAPE)) {
+      ctx.stop();
+    }
+    float dx = 0.0f;
+    float dy = 0.0f;
+    if (input.isKeyDown(GLFW_KEY_LEFT) || input.isKeyDown(GLFW_KEY_A))
+      dx -= 1.0f;
+    if (input.isKeyDown(GLFW_KEY_RIGHT) || input.isKeyDown(GLFW_KEY_D))
+      dx += 1.0f;
+    if (input.isKeyDown(GLFW_KEY_UP) || input.isKeyDown(GLFW_KEY_W))
+      dy -= 1.0f;
+    if (input.isKeyDown(GLFW_KEY_DOWN) || input.isKeyDown(GLFW_KEY_S))
+      dy += 1.0f;
+    float distance = doomguySpeed * static_cast<float>(step);
+    const Vec3<float> &position = doomguy.getPosition();
+    doomguy.setPosition(Vec3<float>(position.x + dx * distance,
+                                    position.y + dy * distance, position.z));
+  };
+
+  auto render = [&](double alpha) {
     auto &renderer = ctx.getRenderer();
 
-    renderer.begin();
+    float x = previousMartianX +
+              (martianX - previousMartianX) * static_cast<float>(alpha);
+    martian.setPosition(Vec3<float>(x, 100, 1));
 
+    renderer.drawStaticBatch(walls);
     renderer.drawCircle(circle);
-    renderer.drawRect(leftWall);
-    renderer.drawRect(rightWall);
     renderer.drawSprite(doomguy);
-    renderer.drawRect(topWall);
-    renderer.drawRect(bottomWall);
     renderer.drawSprite(martian);
+    renderer.drawSprite(psyduck);
+  };
 
-    renderer.end();
-
-    if (ctx.isDebugOverlayEnabled()) {
-      ctx.getDebugOverlay().beginFrame();
-      ctx.getDebugOverlay().render();
-    }
-
-    glfwSwapBuffers(ctx.getWindow());
-    glfwPollEvents();
-  }
+  ctx.run(update, render);
 
+  walls.Delete();
   GameContext::shutdown();
   return 0;
 }
\ No newline at end of file
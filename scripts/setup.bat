@@ -154,6 +154,15 @@ if not exist deps\include\stb_image.h (
     exit /b 1
 )
 
+:: Download stb_image_write.h
+echo Downloading stb_image_write.h...
+curl -L https://raw.githubusercontent.com/nothings/stb/master/stb_image_write.h -o deps\include\stb_image_write.h
+if not exist deps\include\stb_image_write.h (
+    echo Error: Failed to download stb_image_write.h!
+    pause
+    exit /b 1
+)
+
 :: Cleanup
 echo Cleaning up build files...
 rmdir /S /Q deps\glad >> %DEBUG_LOG% 2>&1
@@ -0,0 +1,74 @@
+#ifndef GL_TEST_CONTEXT_H
+#define GL_TEST_CONTEXT_H
+
+#include <iostream>
+
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+
+#include "jelly/headless_context.h"
+
+// Exit code CTest reports as skipped, for machines without an OpenGL 4.5
+// context (for example CI runners without EGL or a display).
+#define SKIP_TEST 77
+
+// An OpenGL 4.5 context that is current while the object lives. Headless
+// EGL rendering is preferred; a hidden window is the fallback.
+class GLTestContext {
+  HeadlessContext m_headless;
+  GLFWwindow *m_window = nullptr;
+  bool m_glfwInitialized = false;
+
+public:
+  GLTestContext() = default;
+  GLTestContext(const GLTestContext &) = delete;
+  GLTestContext &operator=(const GLTestContext &) = delete;
+
+  ~GLTestContext() {
+    m_headless.shutdown();
+    if (m_window != nullptr) {
+      glfwDestroyWindow(m_window);
+    }
+    if (m_glfwInitialized) {
+      glfwTerminate();
+    }
+  }
+
+  // Returns false, after saying why, when no context can be created.
+  bool init(int width, int height) {
+    if (m_headless.init(width, height)) {
+      return true;
+    }
+
+    if (!glfwInit()) {
+      std::cout << "No display available, skipping.\n";
+      return false;
+    }
+    m_glfwInitialized = true;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    m_window = glfwCreateWindow(width, height, "test", nullptr, nullptr);
+    if (m_window == nullptr) {
+      std::cout << "No OpenGL 4.5 context available, skipping.\n";
+      return false;
+    }
+    glfwMakeContextCurrent(m_window);
+    if (gladLoadGL((GLADloadfunc)glfwGetProcAddress) == 0) {
+      std::cout << "Failed to load OpenGL, skipping.\n";
+      return false;
+    }
+    glViewport(0, 0, width, height);
+    return true;
+  }
+
+  // Null when rendering through a window.
+  HeadlessContext *getHeadless() {
+    return m_headless.isInitialized() ? &m_headless : nullptr;
+  }
+};
+
+#endif // GL_TEST_CONTEXT_H
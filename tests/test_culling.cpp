@@ -0,0 +1,82 @@
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "jelly/culling.h"
+
+const SimdLevel LEVELS[] = {SimdLevel::Scalar, SimdLevel::SSE,
+                            SimdLevel::AVX};
+
+std::vector<uint32_t> cullReference(const CullBoundsSoA &bounds,
+                                    const CullRect &view) {
+  std::vector<uint32_t> visible;
+  for (size_t i = 0; i < bounds.size(); ++i) {
+    CullRect rect = {bounds.minX[i], bounds.minY[i], bounds.maxX[i],
+                     bounds.maxY[i]};
+    if (rect.overlaps(view)) {
+      visible.push_back(static_cast<uint32_t>(i));
+    }
+  }
+  return visible;
+}
+
+std::vector<uint32_t> cullWith(const CullBoundsSoA &bounds,
+                               const CullRect &view, SimdLevel level) {
+  std::vector<uint32_t> visible(bounds.size());
+  visible.resize(cullBounds(bounds, view, visible.data(), level));
+  return visible;
+}
+
+void testEdges() {
+  CullRect view = {0.0f, 0.0f, 100.0f, 50.0f};
+
+  CullBoundsSoA bounds;
+  bounds.push({10.0f, 10.0f, 20.0f, 20.0f});     // 0: inside
+  bounds.push({-20.0f, -20.0f, -1.0f, 10.0f});   // 1: left
+  bounds.push({-20.0f, -20.0f, 0.0f, 0.0f});     // 2: touches a corner
+  bounds.push({100.0f, 50.0f, 120.0f, 60.0f});   // 3: touches a corner
+  bounds.push({101.0f, 10.0f, 120.0f, 20.0f});   // 4: right
+  bounds.push({10.0f, 51.0f, 20.0f, 60.0f});     // 5: below
+  bounds.push({10.0f, -30.0f, 20.0f, -0.5f});    // 6: above
+  bounds.push({-50.0f, -50.0f, 200.0f, 200.0f}); // 7: covers the view
+  bounds.push({90.0f, 40.0f, 110.0f, 60.0f});    // 8: straddles a corner
+
+  std::vector<uint32_t> expected = {0, 2, 3, 7, 8};
+  for (SimdLevel level : LEVELS) {
+    assert(cullWith(bounds, view, level) == expected);
+  }
+  std::cout << "Edge culling test passed.\n";
+}
+
+void testKernelsMatchReference() {
+  std::mt19937 rng(9);
+  std::uniform_real_distribution<float> position(-2000.0f, 2000.0f);
+  std::uniform_real_distribution<float> extent(0.0f, 300.0f);
+  CullRect view = {0.0f, 0.0f, 1280.0f, 720.0f};
+
+  // Sizes that are not multiples of the vector width exercise the tails.
+  for (size_t count : {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 1000, 4099}) {
+    CullBoundsSoA bounds;
+    for (size_t i = 0; i < count; ++i) {
+      float x = position(rng);
+      float y = position(rng);
+      bounds.push({x, y, x + extent(rng), y + extent(rng)});
+    }
+
+    std::vector<uint32_t> expected = cullReference(bounds, view);
+    for (SimdLevel level : LEVELS) {
+      assert(cullWith(bounds, view, level) == expected);
+    }
+  }
+  std::cout << "Kernel consistency test passed (best level "
+            << static_cast<int>(bestSimdLevel()) << ").\n";
+}
+
+int main() {
+  testEdges();
+  testKernelsMatchReference();
+
+  std::cout << "All culling tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "jelly/frame_limiter.h"
+#include "jelly/game_context.h"
+#include "jelly/null_render_device.h"
+
+// A GPU that finishes a frame only when the CPU blocks on its fence, so the
+// test decides when frames complete.
+class SlowGpuDevice : public NullRenderDevice {
+  std::set<GLsync> m_signaled;
+
+public:
+  size_t blockingWaits = 0;
+
+  GLenum clientWaitSync(GLsync sync, GLbitfield flags,
+                        GLuint64 timeout) override {
+    if (m_signaled.count(sync) > 0)
+      return GL_ALREADY_SIGNALED;
+    if (timeout == 0)
+      return GL_TIMEOUT_EXPIRED;
+    ++blockingWaits;
+    m_signaled.insert(sync);
+    return GL_CONDITION_SATISFIED;
+  }
+};
+
+void runFrame(FrameLimiter &limiter) {
+  limiter.waitForSlot();
+  limiter.markInput();
+  limiter.markSubmit();
+  limiter.endFrame();
+}
+
+void testLimitsFramesInFlight() {
+  SlowGpuDevice device;
+  RenderDevice::set(&device);
+
+  std::vector<uint64_t> completed;
+  FrameLimiter limiter(2);
+  limiter.setLatencyCallback([&](const FrameLatency &latency) {
+    assert(latency.inputToSubmit >= 0.0);
+    assert(latency.submitToComplete >= 0.0);
+    completed.push_back(latency.frame);
+  });
+
+  // Two frames queue up without waiting; every frame after that waits for
+  // the oldest one.
+  runFrame(limiter);
+  runFrame(limiter);
+  assert(device.blockingWaits == 0);
+  assert(limiter.getFramesInFlight() == 2);
+  assert(limiter.getLatest() == nullptr);
+
+  for (int i = 0; i < 5; ++i) {
+    runFrame(limiter);
+    assert(limiter.getFramesInFlight() <= 2);
+  }
+  assert(device.blockingWaits == 5);
+  assert((completed == std::vector<uint64_t>{0, 1, 2, 3, 4}));
+  assert(limiter.getLatest()->frame == 4);
+
+  limiter.reset();
+  assert(limiter.getFramesInFlight() == 0);
+  RenderDevice::set(nullptr);
+  std::cout << "Frames in flight test passed.\n";
+}
+
+void testUnlimitedDoesNotFence() {
+  NullRenderDevice device;
+  RenderDevice::set(&device);
+
+  FrameLimiter limiter(0);
+  for (int i = 0; i < 10; ++i) {
+    runFrame(limiter);
+  }
+  assert(limiter.getFramesInFlight() == 0);
+  assert(limiter.getLatest() == nullptr);
+
+  RenderDevice::set(nullptr);
+  std::cout << "Unlimited test passed.\n";
+}
+
+void testHeadlessLatency() {
+  if (!GameContext::initHeadless(64, 64)) {
+    std::cout << "No headless context, skipping the latency test.\n";
+    return;
+  }
+  GameContext &ctx = GameContext::getInstance();
+
+  std::vector<FrameLatency> latencies;
+  ctx.getFrameLimiter().setLatencyCallback(
+      [&](const FrameLatency &latency) { latencies.push_back(latency); });
+
+  GameLoopConfig config;
+  config.framesInFlight = 1;
+  int frames = 0;
+  ctx.run([](double) {},
+          [&](double) {
+            // With one frame allowed, the previous frame has finished
+            // before this one polls input.
+            assert(ctx.getFrameLimiter().getFramesInFlight() == 0);
+            Rectangle rect(Vec2<float>(0, 0), Vec2<float>(32, 32),
+                           Vec4<float>(1.0f, 0.0f, 0.0f, 1.0f), true);
+            ctx.getRenderer().drawRect(rect);
+            if (++frames == 20) {
+              ctx.stop();
+            }
+          },
+          config);
+
+  // The last frame is still in flight when the loop stops.
+  assert(latencies.size() == 19);
+  for (size_t i = 0; i < latencies.size(); ++i) {
+    const FrameLatency &latency = latencies[i];
+    assert(latency.frame == i);
+    assert(latency.inputToSubmit >= 0.0 && latency.submitToComplete >= 0.0);
+    assert(latency.inputToComplete >= latency.inputToSubmit);
+  }
+  std::cout << "Headless latency of the last frame: "
+            << latencies.back().inputToComplete << " ms\n";
+
+  ctx.getFrameLimiter().setLatencyCallback(nullptr);
+  GameContext::shutdown();
+  std::cout << "Headless latency test passed.\n";
+}
+
+int main() {
+  testLimitsFramesInFlight();
+  testUnlimitedDoesNotFence();
+  testHeadlessLatency();
+  std::cout << "All frame limiter tests passed!" << std::endl;
+  return 0;
+}
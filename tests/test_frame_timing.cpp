@@ -0,0 +1,102 @@
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "jelly/frame_timing.h"
+#include "jelly/game_context.h"
+
+bool near(double a, double b) { return std::abs(a - b) < 1e-9; }
+
+void testFixedTimestepSteps() {
+  FixedTimestep timestep(0.01);
+  assert(timestep.advance(0.005) == 0);
+  assert(near(timestep.getAlpha(), 0.5));
+  assert(timestep.advance(0.0075) == 1);
+  assert(near(timestep.getAlpha(), 0.25));
+  assert(timestep.advance(0.03) == 3);
+  assert(near(timestep.getAlpha(), 0.25));
+
+  // Negative frame times, from a clock adjustment, add nothing.
+  assert(timestep.advance(-1.0) == 0);
+  assert(near(timestep.getAlpha(), 0.25));
+
+  timestep.reset();
+  assert(timestep.getAlpha() == 0.0);
+  std::cout << "Fixed timestep step test passed.\n";
+}
+
+void testFixedTimestepClamps() {
+  FixedTimestep timestep(0.01, 4);
+  // A one second stall runs at most four steps and keeps only the fraction.
+  assert(timestep.advance(1.0025) == 4);
+  assert(near(timestep.getAlpha(), 0.25));
+  assert(timestep.advance(0.0) == 0);
+  std::cout << "Fixed timestep clamp test passed.\n";
+}
+
+void testFramePacerHoldsRate() {
+  using Clock = std::chrono::steady_clock;
+
+  FramePacer off;
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < 100; ++i) {
+    off.wait();
+  }
+  assert(Clock::now() - start < std::chrono::milliseconds(10));
+
+  // Twenty 5 ms frames, with the schedule starting at the first wait().
+  FramePacer pacer(0.005);
+  pacer.wait();
+  start = Clock::now();
+  for (int i = 0; i < 20; ++i) {
+    pacer.wait();
+  }
+  double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  assert(elapsed >= 0.099);
+  // Loose, since a loaded machine may oversleep; a late frame must not make
+  // the pacer wait longer for the ones after it.
+  assert(elapsed < 0.5);
+  std::cout << "Frame pacer test passed.\n";
+}
+
+void testRunStops() {
+  if (!GameContext::initHeadless(64, 64)) {
+    std::cout << "No headless context, skipping the game loop test.\n";
+    return;
+  }
+  GameContext &ctx = GameContext::getInstance();
+
+  GameLoopConfig config;
+  config.updateRate = 1000.0;
+  config.targetFrameRate = 200.0;
+
+  size_t updates = 0;
+  int frames = 0;
+  ctx.run([&](double step) {
+        assert(near(step, 0.001));
+        ++updates;
+      },
+      [&](double alpha) {
+        assert(alpha >= 0.0 && alpha <= 1.0);
+        if (++frames == 10) {
+          ctx.stop();
+        }
+      },
+      config);
+
+  assert(frames == 10);
+  // Ten 5 ms frames are about 50 steps; the first frame runs none.
+  assert(updates > 0 && updates <= 10 * config.maxUpdatesPerFrame);
+  GameContext::shutdown();
+  std::cout << "Game loop test passed.\n";
+}
+
+int main() {
+  testFixedTimestepSteps();
+  testFixedTimestepClamps();
+  testFramePacerHoldsRate();
+  testRunStops();
+  std::cout << "All frame timing tests passed!" << std::endl;
+  return 0;
+}
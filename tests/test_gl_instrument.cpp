@@ -0,0 +1,112 @@
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "gl_test_context.h"
+#include "jelly/gl_instrument.h"
+#include "jelly/render_device.h"
+
+void drawFrame(int clears) {
+  for (int i = 0; i < clears; ++i) {
+    GL_CHECK(glClear(GL_COLOR_BUFFER_BIT));
+  }
+  GLInstrument::nextFrame();
+}
+
+void testFrameHistory() {
+  for (size_t frame = 0; frame < GL_FRAME_HISTORY + 5; ++frame) {
+    drawFrame(static_cast<int>(frame % 4));
+  }
+
+#if JELLY_GL_LEVEL == JELLY_GL_OFF
+  // Nothing is recorded, and GL_CHECK is the bare call.
+  assert(GLInstrument::getFrameCount() == 0);
+  assert(GLInstrument::getCallSites().empty());
+#else
+  assert(GLInstrument::getFrameCount() == GL_FRAME_HISTORY);
+  for (size_t ago = 0; ago < GL_FRAME_HISTORY; ++ago) {
+    const GLFrameStats &stats = GLInstrument::getFrame(ago);
+    assert(stats.frame == GL_FRAME_HISTORY + 4 - ago);
+    assert(stats.calls == stats.frame % 4);
+    assert(stats.errors == 0);
+  }
+  assert(GLInstrument::getCallSites().size() == 1);
+
+  std::ostringstream report;
+  GLInstrument::report(report);
+  assert(report.str().find("glClear(GL_COLOR_BUFFER_BIT)") !=
+         std::string::npos);
+#endif
+  std::cout << "Frame history test passed (level " << JELLY_GL_LEVEL
+            << ").\n";
+}
+
+void testDeviceCallsAreAttributedToCallers() {
+  size_t before = GLInstrument::getCallSites().size();
+  RenderDevice &device = RenderDevice::get();
+  [[maybe_unused]] int firstLine = __LINE__ + 1;
+  device.enable(GL_BLEND);
+  device.disable(GL_BLEND);
+  GLInstrument::nextFrame();
+
+#if JELLY_GL_LEVEL != JELLY_GL_OFF
+  // One site per calling line, both in this file.
+  const std::vector<GLCallSite *> &sites = GLInstrument::getCallSites();
+  assert(sites.size() == before + 2);
+  for (size_t i = 0; i < 2; ++i) {
+    const GLCallSite *site = sites[before + i];
+    assert(std::string(site->file).find("test_gl_instrument") !=
+           std::string::npos);
+    assert(site->line == firstLine + static_cast<int>(i));
+    assert(site->totalCalls == 1);
+  }
+#else
+  assert(GLInstrument::getCallSites().size() == before);
+#endif
+  std::cout << "Device call attribution test passed.\n";
+}
+
+void testErrorsAreCounted() {
+#if JELLY_GL_LEVEL >= JELLY_GL_CHECK
+  GL_CHECK(glEnable(GL_INVALID_ENUM));
+  GLInstrument::nextFrame();
+  assert(GLInstrument::getFrame(0).errors == 1);
+#endif
+  std::cout << "Error count test passed.\n";
+}
+
+void testDebugMessagesAreDeduplicated() {
+#if JELLY_GL_LEVEL >= JELLY_GL_CHECK
+  GLInstrument::enableDebugOutput(GL_DEBUG_SEVERITY_LOW);
+  glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  size_t suppressed = GLInstrument::getSuppressedMessageCount();
+
+  const char *message = "jelly test message";
+  for (int i = 0; i < 3; ++i) {
+    glDebugMessageInsert(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_OTHER, 1,
+                         GL_DEBUG_SEVERITY_HIGH, -1, message);
+  }
+  // Below the minimum severity: dropped without being counted.
+  glDebugMessageInsert(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_OTHER, 2,
+                       GL_DEBUG_SEVERITY_NOTIFICATION, -1, message);
+
+  assert(GLInstrument::getSuppressedMessageCount() == suppressed + 2);
+#endif
+  std::cout << "Debug message test passed.\n";
+}
+
+int main() {
+  GLTestContext context;
+  if (!context.init(64, 64)) {
+    return SKIP_TEST;
+  }
+
+  testFrameHistory();
+  testDeviceCallsAreAttributedToCallers();
+  testErrorsAreCounted();
+  testDebugMessagesAreDeduplicated();
+
+  std::cout << "All GL instrumentation tests passed!" << std::endl;
+  return 0;
+}
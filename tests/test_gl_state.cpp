@@ -0,0 +1,114 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+
+#include "gl_test_context.h"
+#include "jelly/gl_state.h"
+#include "jelly/shader.h"
+#include "jelly/texture.h"
+#include "jelly/vao.h"
+
+GLint currentBinding(GLenum binding) {
+  GLint value = 0;
+  glGetIntegerv(binding, &value);
+  return value;
+}
+
+void testSkipsRedundantBinds() {
+  VAO vao;
+  vao.Init();
+  Texture first(4, 4);
+  Texture second(4, 4);
+
+  GLState::invalidate();
+  GLState::beginFrame();
+
+  vao.Bind();
+  vao.Bind();
+  first.Bind(3);
+  first.Bind(3);
+  second.Bind(4);
+  first.Bind(3);
+
+  // One vertex array bind, two texture binds and two unit switches; binding
+  // the first texture again needs no unit switch either.
+  const GLStateStats &stats = GLState::getFrameStats();
+  assert(stats.issued == 5);
+  assert(stats.skipped == 3);
+
+  // The cache agrees with what OpenGL reports.
+  assert(currentBinding(GL_VERTEX_ARRAY_BINDING) == GLint(vao.getID()));
+  glActiveTexture(GL_TEXTURE3);
+  assert(currentBinding(GL_TEXTURE_BINDING_2D) == GLint(first.getID()));
+  glActiveTexture(GL_TEXTURE4);
+  assert(currentBinding(GL_TEXTURE_BINDING_2D) == GLint(second.getID()));
+  GLState::invalidate();
+
+  GLState::beginFrame();
+  assert(GLState::getFrameStats().issued == 0);
+  assert(GLState::getFrameStats().skipped == 0);
+
+  vao.Delete();
+  first.Delete();
+  second.Delete();
+  std::cout << "Redundant bind test passed.\n";
+}
+
+void testDeletedObjectsAreForgotten() {
+  Texture texture(4, 4);
+  texture.Bind(0);
+  texture.Delete();
+
+  // OpenGL may hand out the deleted name again; binding it must not be
+  // skipped.
+  GLuint reused = 0;
+  glGenTextures(1, &reused);
+  GLState::beginFrame();
+  GLState::bindTexture(0, GL_TEXTURE_2D, reused);
+  assert(GLState::getFrameStats().issued == 1);
+  glActiveTexture(GL_TEXTURE0);
+  assert(currentBinding(GL_TEXTURE_BINDING_2D) == GLint(reused));
+
+  GLState::forgetTexture(reused);
+  glDeleteTextures(1, &reused);
+  GLState::invalidate();
+  std::cout << "Deleted object test passed.\n";
+}
+
+void testUniformTable() {
+  Shader shader;
+  shader.Compile(quad_vertex_shader, quad_fragment_shader);
+
+  GLint projection = shader.getUniformLocation("projection");
+  assert(projection != -1);
+  assert(projection == glGetUniformLocation(shader.GetID(), "projection"));
+  assert(shader.getUniformLocation("textures") ==
+         glGetUniformLocation(shader.GetID(), "textures[0]"));
+  assert(shader.getUniformLocation("missing") == -1);
+
+  // The sampler array is pointed at units 0 to 31 at link time.
+  for (GLint i = 0; i < 32; ++i) {
+    std::string name = "textures[" + std::to_string(i) + "]";
+    GLint unit = -1;
+    glGetUniformiv(shader.GetID(),
+                   glGetUniformLocation(shader.GetID(), name.c_str()), &unit);
+    assert(unit == i);
+  }
+
+  shader.Delete();
+  std::cout << "Uniform table test passed.\n";
+}
+
+int main() {
+  GLTestContext context;
+  if (!context.init(64, 64)) {
+    return SKIP_TEST;
+  }
+
+  testSkipsRedundantBinds();
+  testDeletedObjectsAreForgotten();
+  testUniformTable();
+
+  std::cout << "All GL state tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,150 @@
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gl_test_context.h"
+#include "jelly/image.h"
+#include "jelly/renderer_2d.h"
+#include "jelly/static_batch.h"
+
+// Renders small scenes and compares them with the PNGs in tests/golden.
+// Set JELLY_UPDATE_GOLDEN=1 to rewrite the PNGs after an intended change.
+
+const int WIDTH = 128;
+const int HEIGHT = 96;
+
+// Drivers may round edges and antialiasing differently, so a few pixels may
+// differ by more than the channel tolerance.
+const int CHANNEL_TOLERANCE = 8;
+const double MAX_MISMATCHED_FRACTION = 0.01;
+
+const Vec4<float> RED(1.0f, 0.0f, 0.0f, 1.0f);
+const Vec4<float> GREEN(0.0f, 1.0f, 0.0f, 1.0f);
+const Vec4<float> BLUE(0.0f, 0.0f, 1.0f, 1.0f);
+const Vec4<float> WHITE(1.0f, 1.0f, 1.0f, 1.0f);
+const Vec4<float> TRANSLUCENT_YELLOW(1.0f, 1.0f, 0.0f, 0.5f);
+
+std::vector<unsigned char> readFramebuffer() {
+  std::vector<unsigned char> pixels(WIDTH * HEIGHT * 4);
+  glFinish();
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+  return pixels;
+}
+
+// Returns false if the golden image is missing and was not written.
+bool compareWithGolden(const char *name,
+                       const std::vector<unsigned char> &pixels) {
+  std::string path = std::string(JELLY_TEST_DIR) + "/golden/" + name + ".png";
+
+  if (std::getenv("JELLY_UPDATE_GOLDEN") != nullptr) {
+    if (!write_png(path.c_str(), WIDTH, HEIGHT, pixels.data())) {
+      std::cerr << "Error: Failed to write " << path << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    std::cout << "Wrote " << path << "\n";
+    return true;
+  }
+
+  int width, height, channels;
+  unsigned char *golden =
+      load_image(path.c_str(), width, height, channels, 4);
+  if (golden == nullptr) {
+    std::cout << "Missing " << path << "\n";
+    return false;
+  }
+  assert(width == WIDTH && height == HEIGHT);
+
+  size_t mismatched = 0;
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    for (size_t c = 0; c < 4; ++c) {
+      if (std::abs(pixels[i + c] - golden[i + c]) > CHANNEL_TOLERANCE) {
+        ++mismatched;
+        break;
+      }
+    }
+  }
+  free_image(golden);
+
+  double fraction = static_cast<double>(mismatched) / (WIDTH * HEIGHT);
+  std::cout << name << ": " << mismatched << " mismatched pixels\n";
+  assert(fraction <= MAX_MISMATCHED_FRACTION);
+  return true;
+}
+
+void drawRectangles(Renderer2D &renderer) {
+  renderer.begin();
+  renderer.drawRect(Rectangle(Vec2<float>(8.0f, 8.0f),
+                              Vec2<float>(40.0f, 24.0f), RED));
+  renderer.drawRect(Rectangle(Vec2<float>(56.0f, 8.0f),
+                              Vec2<float>(32.0f, 32.0f), GREEN, false));
+  renderer.drawRect(Rectangle(Vec2<float>(24.0f, 20.0f),
+                              Vec2<float>(48.0f, 40.0f), TRANSLUCENT_YELLOW));
+  renderer.drawRect(Rectangle(Vec2<float>(96.0f, 48.0f),
+                              Vec2<float>(24.0f, 40.0f), BLUE));
+  renderer.end();
+}
+
+void drawCircles(Renderer2D &renderer) {
+  renderer.begin();
+  renderer.drawCircle(Circle(Vec2<float>(24.0f, 24.0f), 16.0f, true, RED));
+  renderer.drawCircle(Circle(Vec2<float>(64.0f, 48.0f), 24.0f, false, WHITE));
+  renderer.drawCircle(
+      Circle(Vec2<float>(96.0f, 64.0f), 20.0f, true, TRANSLUCENT_YELLOW));
+  renderer.drawCircle(Circle(Vec2<float>(110.0f, 16.0f), 6.0f, true, BLUE));
+  renderer.end();
+}
+
+void drawStaticLayer(Renderer2D &renderer) {
+  StaticBatch batch;
+  for (int i = 0; i < 8; ++i) {
+    batch.add(Rectangle(Vec2<float>(i * 16.0f, 80.0f),
+                        Vec2<float>(16.0f, 16.0f), i % 2 == 0 ? RED : BLUE));
+  }
+  batch.add(Rectangle(Vec2<float>(4.0f, 4.0f), Vec2<float>(120.0f, 70.0f),
+                      WHITE, false));
+
+  renderer.begin();
+  renderer.drawStaticBatch(batch);
+  renderer.drawCircle(Circle(Vec2<float>(64.0f, 40.0f), 12.0f, true, GREEN));
+  renderer.end();
+  glFinish();
+  batch.Delete();
+}
+
+int main() {
+  GLTestContext context;
+  if (!context.init(WIDTH, HEIGHT)) {
+    return SKIP_TEST;
+  }
+
+  struct Scene {
+    const char *name;
+    void (*draw)(Renderer2D &renderer);
+  };
+  const Scene scenes[] = {{"rectangles", drawRectangles},
+                          {"circles", drawCircles},
+                          {"static_batch", drawStaticLayer}};
+
+  bool complete = true;
+  {
+    Renderer2D renderer(WIDTH, HEIGHT, 1.0f);
+    renderer.init();
+
+    for (const Scene &scene : scenes) {
+      scene.draw(renderer);
+      complete &= compareWithGolden(scene.name, readFramebuffer());
+    }
+
+    renderer.shutdown();
+  }
+
+  if (!complete) {
+    std::cout << "Golden images missing, skipping.\n";
+    return SKIP_TEST;
+  }
+  std::cout << "All golden image tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,164 @@
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+#include "jelly/input.h"
+
+// Events are pushed directly, as the GLFW callbacks would, so no window is
+// needed.
+
+void key(Input &input, int code, int action) {
+  input.push({InputEventType::Key, code, action});
+}
+
+void cursor(Input &input, double x, double y) {
+  input.push({InputEventType::CursorPos, 0, 0, x, y});
+}
+
+void testKeyEdges() {
+  Input input;
+  key(input, GLFW_KEY_A, GLFW_PRESS);
+  input.update();
+
+  const InputSnapshot *snapshot = &input.getSnapshot();
+  assert(snapshot->frame == 1);
+  assert(snapshot->isKeyDown(GLFW_KEY_A));
+  assert(!snapshot->wasKeyDown(GLFW_KEY_A));
+  assert(snapshot->isKeyPressed(GLFW_KEY_A));
+  assert(!snapshot->isKeyReleased(GLFW_KEY_A));
+
+  // Held, with repeats, is not pressed again.
+  key(input, GLFW_KEY_A, GLFW_REPEAT);
+  input.update();
+  snapshot = &input.getSnapshot();
+  assert(snapshot->isKeyDown(GLFW_KEY_A));
+  assert(snapshot->wasKeyDown(GLFW_KEY_A));
+  assert(!snapshot->isKeyPressed(GLFW_KEY_A));
+
+  // A tap within one frame is both pressed and released.
+  key(input, GLFW_KEY_A, GLFW_RELEASE);
+  key(input, GLFW_KEY_SPACE, GLFW_PRESS);
+  key(input, GLFW_KEY_SPACE, GLFW_RELEASE);
+  input.update();
+  snapshot = &input.getSnapshot();
+  assert(!snapshot->isKeyDown(GLFW_KEY_A));
+  assert(snapshot->isKeyReleased(GLFW_KEY_A));
+  assert(!snapshot->isKeyDown(GLFW_KEY_SPACE));
+  assert(snapshot->isKeyPressed(GLFW_KEY_SPACE));
+  assert(snapshot->isKeyReleased(GLFW_KEY_SPACE));
+
+  // Codes outside the key range are ignored rather than out of bounds.
+  key(input, GLFW_KEY_UNKNOWN, GLFW_PRESS);
+  input.update();
+  assert(!input.getSnapshot().isKeyDown(GLFW_KEY_UNKNOWN));
+  assert(!input.getSnapshot().isKeyDown(GLFW_KEY_LAST + 1));
+  std::cout << "Key edge test passed.\n";
+}
+
+void testMouse() {
+  Input input;
+  cursor(input, 10.0, 20.0);
+  cursor(input, 15.0, 18.0);
+  input.push({InputEventType::MouseButton, GLFW_MOUSE_BUTTON_LEFT,
+              GLFW_PRESS});
+  input.push({InputEventType::Scroll, 0, 0, 0.0, 1.0});
+  input.push({InputEventType::Scroll, 0, 0, 0.0, 2.0});
+  input.update();
+
+  const InputSnapshot &first = input.getSnapshot();
+  assert(first.mouseX == 15.0 && first.mouseY == 18.0);
+  assert(first.mouseDeltaX == 15.0 && first.mouseDeltaY == 18.0);
+  assert(first.scrollY == 3.0);
+  assert(first.isMouseButtonDown(GLFW_MOUSE_BUTTON_LEFT));
+  assert(first.isMouseButtonPressed(GLFW_MOUSE_BUTTON_LEFT));
+
+  // Motion and scrolling are per frame; the position and buttons carry.
+  input.update();
+  const InputSnapshot &second = input.getSnapshot();
+  assert(second.mouseX == 15.0 && second.mouseDeltaX == 0.0);
+  assert(second.scrollY == 0.0);
+  assert(second.isMouseButtonDown(GLFW_MOUSE_BUTTON_LEFT));
+  assert(!second.isMouseButtonPressed(GLFW_MOUSE_BUTTON_LEFT));
+  std::cout << "Mouse test passed.\n";
+}
+
+void testReleaseAll() {
+  Input input;
+  key(input, GLFW_KEY_W, GLFW_PRESS);
+  input.push({InputEventType::MouseButton, GLFW_MOUSE_BUTTON_LEFT,
+              GLFW_PRESS});
+  input.update();
+
+  input.releaseAll();
+  input.update();
+  const InputSnapshot &snapshot = input.getSnapshot();
+  assert(!snapshot.isKeyDown(GLFW_KEY_W));
+  assert(snapshot.isKeyReleased(GLFW_KEY_W));
+  assert(!snapshot.isMouseButtonDown(GLFW_MOUSE_BUTTON_LEFT));
+  assert(snapshot.isMouseButtonReleased(GLFW_MOUSE_BUTTON_LEFT));
+  std::cout << "Release all test passed.\n";
+}
+
+void testOverflowKeepsLatest() {
+  Input input;
+  for (size_t i = 0; i < INPUT_EVENT_QUEUE_CAPACITY; ++i) {
+    bool pushed = input.push({InputEventType::CursorPos, 0, 0, 1.0, 1.0});
+    assert(pushed);
+  }
+  bool overflowed = !input.push({InputEventType::CursorPos, 0, 0, 2.0, 2.0});
+  assert(overflowed);
+
+  // Without a window to query, the events that fit are applied.
+  input.update();
+  assert(input.getSnapshot().mouseX == 1.0);
+  std::cout << "Overflow test passed.\n";
+}
+
+void testReadersSeeWholeSnapshots() {
+  Input input;
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> checked{0};
+
+  // Each frame holds A, then D, then A, ...; a reader must never see a
+  // snapshot with both or neither.
+  std::thread reader([&] {
+    while (!done.load()) {
+      const InputSnapshot &snapshot = input.getSnapshot();
+      uint64_t frame = snapshot.frame;
+      if (frame > 0) {
+        assert(snapshot.isKeyDown(GLFW_KEY_A) !=
+               snapshot.isKeyDown(GLFW_KEY_D));
+        assert(snapshot.isKeyDown(GLFW_KEY_A) == (frame % 2 == 1));
+      }
+      checked.store(frame);
+      std::this_thread::yield();
+    }
+  });
+
+  for (uint64_t frame = 1; frame <= 1000; ++frame) {
+    // Snapshots are only promised for two updates after their own, so
+    // wait for a reader that fell further behind.
+    while (frame > 2 && checked.load() < frame - 2) {
+      std::this_thread::yield();
+    }
+    bool a = frame % 2 == 1;
+    key(input, GLFW_KEY_A, a ? GLFW_PRESS : GLFW_RELEASE);
+    key(input, GLFW_KEY_D, a ? GLFW_RELEASE : GLFW_PRESS);
+    input.update();
+  }
+  done.store(true);
+  reader.join();
+  std::cout << "Reader test passed.\n";
+}
+
+int main() {
+  testKeyEdges();
+  testMouse();
+  testReleaseAll();
+  testOverflowKeepsLatest();
+  testReadersSeeWholeSnapshots();
+  std::cout << "All input tests passed!" << std::endl;
+  return 0;
+}
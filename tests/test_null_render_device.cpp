@@ -0,0 +1,396 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "jelly/null_render_device.h"
+#include "jelly/render_queue.h"
+#include "jelly/renderer_2d.h"
+#include "jelly/static_batch.h"
+#include "jelly/texture_atlas.h"
+
+// Runs Renderer2D on the null device, so no OpenGL context is needed and
+// the recorded calls are the same on every machine.
+
+const Vec4<float> RED(1.0f, 0.0f, 0.0f, 1.0f);
+
+size_t countCommands(const NullRenderDevice &device, DeviceCommandType type) {
+  size_t count = 0;
+  for (const DeviceCommand &command : device.getLog()) {
+    if (command.type == type) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+std::vector<DeviceCommand> draws(const NullRenderDevice &device) {
+  std::vector<DeviceCommand> result;
+  for (const DeviceCommand &command : device.getLog()) {
+    if (command.type == DeviceCommandType::Draw) {
+      result.push_back(command);
+    }
+  }
+  return result;
+}
+
+std::vector<Rectangle> makeRects(size_t count, bool alternateOutlines) {
+  std::vector<Rectangle> rectangles;
+  for (size_t i = 0; i < count; ++i) {
+    float x = static_cast<float>((i * 37) % 600);
+    float y = static_cast<float>((i * 53) % 400);
+    bool filled = !alternateOutlines || i % 2 == 0;
+    rectangles.emplace_back(Vec2<float>(x, y), Vec2<float>(8.0f, 8.0f), RED,
+                            filled);
+  }
+  return rectangles;
+}
+
+void testRectsBatchIntoOneDraw(Renderer2D &renderer, NullRenderDevice &device) {
+  std::vector<Rectangle> rectangles = makeRects(100, false);
+
+  device.reset();
+  renderer.begin();
+  renderer.drawRects(rectangles);
+  renderer.end();
+
+  std::vector<DeviceCommand> drawn = draws(device);
+  assert(drawn.size() == 1);
+  assert(drawn[0].target == GL_TRIANGLES);
+  assert(drawn[0].count == 100 * 6);
+  assert(device.getStats().bytesUploaded == 100 * 4 * sizeof(BatchQuadVertex));
+  std::cout << "Rectangle batching test passed.\n";
+}
+
+void testSortingMergesBatches(Renderer2D &renderer, NullRenderDevice &device) {
+  std::vector<Rectangle> rectangles = makeRects(10, true);
+
+  // In submission order every switch between filled and outlined
+  // rectangles ends the batch.
+  device.reset();
+  renderer.setSortMode(RenderSortMode::Immediate);
+  renderer.begin();
+  for (const Rectangle &rectangle : rectangles) {
+    renderer.drawRect(rectangle);
+  }
+  renderer.end();
+  assert(device.getStats().drawCalls == 10);
+
+  device.reset();
+  renderer.setSortMode(RenderSortMode::Batch);
+  renderer.begin();
+  for (const Rectangle &rectangle : rectangles) {
+    renderer.drawRect(rectangle);
+  }
+  renderer.end();
+  assert(device.getStats().drawCalls == 2);
+  assert(device.getStats().elementsDrawn == 5 * 6 + 5 * 5);
+
+  renderer.setSortMode(RenderSortMode::Immediate);
+  std::cout << "Sort batching test passed.\n";
+}
+
+void testRedundantStateIsSkipped(Renderer2D &renderer,
+                                 NullRenderDevice &device) {
+  std::vector<Rectangle> rectangles = makeRects(10, true);
+
+  device.reset();
+  renderer.begin();
+  for (const Rectangle &rectangle : rectangles) {
+    renderer.drawRect(rectangle);
+  }
+  renderer.end();
+
+  // Ten batches use the same program; making it current once is enough.
+  assert(device.getStats().drawCalls == 10);
+  assert(countCommands(device, DeviceCommandType::UseProgram) <= 1);
+  std::cout << "Redundant state test passed.\n";
+}
+
+void testStatsCountFlushReasons(Renderer2D &renderer,
+                                NullRenderDevice &device) {
+  std::vector<Rectangle> rectangles = makeRects(10, true);
+
+  renderer.setDebugMode(true);
+  device.reset();
+  renderer.begin();
+  for (const Rectangle &rectangle : rectangles) {
+    renderer.drawRect(rectangle);
+  }
+  renderer.end();
+
+  // Every switch between filled and outlined rectangles flushes, and end()
+  // draws the last batch.
+  const RenderStats &stats = renderer.getStats();
+  assert(stats.drawCalls == device.getStats().drawCalls);
+  assert(stats.drawCalls == 10);
+  assert(stats.getFlushes(FlushReason::FillMode) == 9);
+  assert(stats.getFlushes(FlushReason::EndOfFrame) == 1);
+  assert(stats.vertices == 10 * 4);
+  assert(stats.indices == 5 * 6 + 5 * 5);
+  assert(stats.bytesUploaded == device.getStats().bytesUploaded);
+
+  const std::vector<FlushRecord> &log = renderer.getFlushLog();
+  assert(log.size() == 10);
+  assert(log.back().reason == FlushReason::EndOfFrame);
+  assert(log.front().items == 1);
+
+  // The counters restart with the frame, and the log is only kept in debug
+  // mode.
+  renderer.setDebugMode(false);
+  renderer.begin();
+  renderer.end();
+  assert(renderer.getStats().drawCalls == 0);
+  assert(renderer.getFlushLog().empty());
+  std::cout << "Render stats test passed.\n";
+}
+
+void testCirclesDrawInstanced(Renderer2D &renderer,
+                              NullRenderDevice &device) {
+  std::vector<Circle> circles;
+  for (int i = 0; i < 50; ++i) {
+    circles.emplace_back(Vec2<float>(i * 10.0f, 100.0f), 4.0f, i % 2 == 0,
+                         RED);
+  }
+
+  device.reset();
+  renderer.begin();
+  renderer.drawCircles(circles);
+  renderer.end();
+
+  std::vector<DeviceCommand> drawn = draws(device);
+  assert(drawn.size() == 1);
+  assert(drawn[0].target == GL_TRIANGLE_STRIP);
+  assert(drawn[0].count == 4 && drawn[0].instances == 50);
+  assert(device.getStats().bytesUploaded == 50 * sizeof(BatchCircleInstance));
+  std::cout << "Circle instancing test passed.\n";
+}
+
+void testStaticBatchUploadsOnce(Renderer2D &renderer,
+                                NullRenderDevice &device) {
+  StaticBatch batch;
+  for (const Rectangle &rectangle : makeRects(20, false)) {
+    batch.add(rectangle);
+  }
+
+  device.reset();
+  renderer.begin();
+  renderer.drawStaticBatch(batch);
+  renderer.end();
+  assert(device.getStats().drawCalls == 1);
+  assert(device.getStats().bytesUploaded > 0);
+
+  device.reset();
+  renderer.begin();
+  renderer.drawStaticBatch(batch);
+  renderer.end();
+  assert(device.getStats().drawCalls == 1);
+  assert(device.getStats().bytesUploaded == 0);
+
+  batch.Delete();
+  std::cout << "Static batch upload test passed.\n";
+}
+
+void testLogIsDeterministic(Renderer2D &renderer, NullRenderDevice &device) {
+  std::vector<Rectangle> rectangles = makeRects(500, true);
+  std::vector<std::vector<DeviceCommand>> logs;
+
+  for (int run = 0; run < 2; ++run) {
+    device.reset();
+    renderer.begin();
+    renderer.drawRects(rectangles);
+    renderer.end();
+    logs.push_back(device.getLog());
+  }
+
+  assert(logs[0].size() == logs[1].size());
+  for (size_t i = 0; i < logs[0].size(); ++i) {
+    assert(logs[0][i].type == logs[1][i].type);
+    assert(logs[0][i].target == logs[1][i].target);
+    assert(logs[0][i].bytes == logs[1][i].bytes);
+    assert(logs[0][i].count == logs[1][i].count);
+    assert(logs[0][i].instances == logs[1][i].instances);
+  }
+
+  // Without the log only the totals are kept.
+  device.reset();
+  device.setLogging(false);
+  renderer.begin();
+  renderer.drawRects(rectangles);
+  renderer.end();
+  assert(device.getLog().empty());
+  assert(device.getStats().drawCalls > 0);
+  device.setLogging(true);
+  std::cout << "Determinism test passed.\n";
+}
+
+void testRadixSortIsStable() {
+  const float layers[] = {1.5f, -2.0f, 0.0f, -0.25f};
+  const uint32_t textures[] = {1, 300, 70000};
+  RenderQueue queue;
+  std::vector<RenderCommand> expected;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    // Few distinct keys, differing in several bytes, so ties are common.
+    uint64_t key = makeSortKey(layers[(i * 7) % 4], i % 3, 0,
+                               textures[(i / 3) % 3]);
+    queue.push(key, RenderCommandType::Rectangle, i);
+    expected.push_back({key, i, RenderCommandType::Rectangle});
+  }
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const RenderCommand &a, const RenderCommand &b) {
+                     return a.key < b.key;
+                   });
+
+  queue.sort();
+  const std::vector<RenderCommand> &sorted = queue.getCommands();
+  assert(sorted.size() == expected.size());
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    assert(sorted[i].key == expected[i].key);
+    assert(sorted[i].index == expected[i].index);
+  }
+
+  // Layers come out in float order, negative ones first.
+  assert(sortKeyLayer(sorted.front().key) == layerSortBits(-2.0f));
+  assert(sortKeyLayer(sorted.back().key) == layerSortBits(1.5f));
+  assert(layerSortBits(-2.0f) < layerSortBits(-0.25f));
+  assert(layerSortBits(-0.25f) < layerSortBits(0.0f));
+  assert(layerSortBits(0.0f) < layerSortBits(1.5f));
+
+  queue.clear();
+  assert(queue.empty());
+  std::cout << "Radix sort stability test passed.\n";
+}
+
+void testStableModeKeepsPainterOrder(Renderer2D &renderer,
+                                     NullRenderDevice &device) {
+  Rectangle rect(Vec2<float>(0.0f, 0.0f), Vec2<float>(8.0f, 8.0f), RED);
+  Circle circle(Vec2<float>(4.0f, 4.0f), 4.0f, true, RED);
+  auto drawScene = [&] {
+    renderer.begin();
+    renderer.drawRect(rect);
+    renderer.drawRect(rect);
+    renderer.drawCircle(circle);
+    renderer.drawCircle(circle);
+    renderer.drawRect(rect);
+    renderer.drawCircle(circle);
+    renderer.end();
+  };
+
+  // Each circle is drawn after the quads submitted before it and under the
+  // quads submitted after it.
+  renderer.setDebugMode(true);
+  renderer.setSortMode(RenderSortMode::Stable);
+  device.reset();
+  drawScene();
+
+  const char *batches[] = {"quads", "circles", "quads", "circles"};
+  const size_t items[] = {2, 2, 1, 1};
+  const std::vector<FlushRecord> &log = renderer.getFlushLog();
+  assert(log.size() == 4);
+  for (size_t i = 0; i < log.size(); ++i) {
+    assert(std::strcmp(log[i].batch, batches[i]) == 0);
+    assert(log[i].items == items[i]);
+  }
+  assert(renderer.getStats().getFlushes(FlushReason::PipelineSwitch) == 3);
+
+  std::vector<DeviceCommand> drawn = draws(device);
+  assert(drawn.size() == 4);
+  assert(drawn[0].target == GL_TRIANGLES);
+  assert(drawn[1].target == GL_TRIANGLE_STRIP);
+  assert(drawn[2].target == GL_TRIANGLES);
+  assert(drawn[3].target == GL_TRIANGLE_STRIP);
+
+  // Batch mode trades that order for one draw per pipeline.
+  renderer.setSortMode(RenderSortMode::Batch);
+  device.reset();
+  drawScene();
+  assert(device.getStats().drawCalls == 2);
+
+  renderer.setSortMode(RenderSortMode::Immediate);
+  renderer.setDebugMode(false);
+  std::cout << "Stable sort order test passed.\n";
+}
+
+// A driver that cannot map buffer storage persistently.
+class UnmappableDevice : public NullRenderDevice {
+public:
+  void *mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length,
+                       GLbitfield access) override {
+    return nullptr;
+  }
+};
+
+void testUnmappedBuffersUpload() {
+  UnmappableDevice device;
+  RenderDevice::set(&device);
+  {
+    Renderer2D renderer(640, 480, 1.0f);
+    renderer.init();
+    std::vector<Rectangle> rectangles = makeRects(100, false);
+
+    // Batches are staged and uploaded instead of written through a mapping.
+    device.reset();
+    renderer.begin();
+    renderer.drawRects(rectangles);
+    renderer.end();
+    assert(device.getStats().drawCalls == 1);
+    assert(device.getStats().bytesUploaded ==
+           100 * 4 * sizeof(BatchQuadVertex));
+    renderer.shutdown();
+  }
+  RenderDevice::set(nullptr);
+  std::cout << "Unmapped buffer test passed.\n";
+}
+
+void testAtlasRepacksWithoutContext(NullRenderDevice &device) {
+  TextureAtlas atlas(64, 1);
+  std::vector<unsigned char> pixels(30 * 30 * 4, 255);
+
+  // Four padded 32x32 images fill the only page.
+  const AtlasRegion *regions[4];
+  for (const AtlasRegion *&region : regions) {
+    region = atlas.add(pixels.data(), 30, 30);
+    assert(region != nullptr);
+  }
+  assert(atlas.add(pixels.data(), 30, 30) == nullptr);
+
+  // Page read back, clear and re-upload all run on the device.
+  atlas.remove(regions[0]);
+  device.reset();
+  const AtlasRegion *added = atlas.add(pixels.data(), 30, 30);
+  assert(added != nullptr);
+  assert(atlas.getStats().repacks == 1);
+  assert(atlas.getPageCount() == 1);
+  assert(device.getStats().uploads == 4);
+  std::cout << "Atlas repack test passed.\n";
+}
+
+int main() {
+  testRadixSortIsStable();
+
+  NullRenderDevice device;
+  RenderDevice::set(&device);
+
+  {
+    Renderer2D renderer(640, 480, 1.0f);
+    renderer.init();
+
+    testRectsBatchIntoOneDraw(renderer, device);
+    testSortingMergesBatches(renderer, device);
+    testRedundantStateIsSkipped(renderer, device);
+    testStatsCountFlushReasons(renderer, device);
+    testCirclesDrawInstanced(renderer, device);
+    testStaticBatchUploadsOnce(renderer, device);
+    testLogIsDeterministic(renderer, device);
+    testStableModeKeepsPainterOrder(renderer, device);
+
+    renderer.shutdown();
+  }
+  testAtlasRepacksWithoutContext(device);
+
+  RenderDevice::set(nullptr);
+  testUnmappedBuffersUpload();
+  std::cout << "All null render device tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,184 @@
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "jelly/io.h"
+#include "jelly/profiler.h"
+
+const ProfileEvent *findEvent(const char *name) {
+  for (const ProfileEvent &event : Profiler::getEvents()) {
+    if (strcmp(event.name, name) == 0) {
+      return &event;
+    }
+  }
+  return nullptr;
+}
+
+void testNestedZones() {
+  Profiler::clear();
+  {
+    ProfileZone outer("outer");
+    {
+      ProfileZone inner("inner");
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  Profiler::collect();
+
+  const ProfileEvent *outer = findEvent("outer");
+  const ProfileEvent *inner = findEvent("inner");
+  assert(outer != nullptr && inner != nullptr);
+  assert(outer->thread == inner->thread);
+  assert(outer->start <= inner->start && inner->end <= outer->end);
+  assert(inner->end - inner->start >= 1000000);
+  std::cout << "Nested zone test passed.\n";
+}
+
+void testThreadsRecordSeparately() {
+  Profiler::clear();
+  {
+    ProfileZone zone("main");
+  }
+  std::thread worker([] {
+    Profiler::setThreadName("worker");
+    ProfileZone zone("work");
+  });
+  worker.join();
+  Profiler::collect();
+
+  uint32_t mainThread = findEvent("main")->thread;
+  const ProfileEvent *work = findEvent("work");
+  assert(work != nullptr);
+  assert(work->thread != mainThread);
+  std::cout << "Thread test passed.\n";
+}
+
+void testFullRingDrops() {
+  auto ring = std::make_unique<ProfileRing>();
+  for (size_t i = 0; i < PROFILER_RING_CAPACITY; ++i) {
+    bool pushed = ring->push({"zone", i, i + 1, 0});
+    assert(pushed);
+  }
+  bool overflowed = !ring->push({"zone", 0, 1, 0});
+  assert(overflowed);
+  assert(ring->getDroppedCount() == 1);
+
+  std::vector<ProfileEvent> events;
+  ring->drain(events);
+  assert(events.size() == PROFILER_RING_CAPACITY);
+  assert(events.front().start == 0);
+  assert(events.back().start == PROFILER_RING_CAPACITY - 1);
+
+  // Draining frees the slots again.
+  bool pushed = ring->push({"zone", 0, 1, 0});
+  assert(pushed);
+  std::cout << "Ring test passed.\n";
+}
+
+void testExitedThreadRingsAreReused() {
+  Profiler::clear();
+  std::thread([] { ProfileZone zone("warm up"); }).join();
+  Profiler::collect();
+  size_t rings = Profiler::getRingCount();
+
+  // Each thread gets its own index, but the ring of a collected thread is
+  // handed to the next one.
+  std::vector<uint32_t> threads;
+  for (int i = 0; i < 16; ++i) {
+    std::thread([] { ProfileZone zone("short lived"); }).join();
+    Profiler::collect();
+  }
+  assert(Profiler::getRingCount() == rings);
+
+  for (const ProfileEvent &event : Profiler::getEvents()) {
+    if (strcmp(event.name, "short lived") == 0) {
+      threads.push_back(event.thread);
+    }
+  }
+  assert(threads.size() == 16);
+  for (size_t i = 1; i < threads.size(); ++i) {
+    assert(threads[i] > threads[i - 1]);
+  }
+  std::cout << "Ring reuse test passed.\n";
+}
+
+void testCollectedZonesAreBounded() {
+  Profiler::clear();
+  size_t discarded = Profiler::getDiscardedCount();
+
+  // Collecting every ring-full, as a long run does once per frame, keeps
+  // only the most recent zones.
+  const size_t batch = PROFILER_RING_CAPACITY / 2;
+  const size_t batches = PROFILER_EVENT_CAPACITY / batch + 4;
+  uint64_t time = 0;
+  for (size_t i = 0; i < batches; ++i) {
+    for (size_t j = 0; j < batch; ++j, ++time) {
+      Profiler::record("bounded", time, time + 1);
+    }
+    Profiler::collect();
+    assert(Profiler::getEvents().size() <= PROFILER_EVENT_CAPACITY);
+  }
+
+  const size_t recorded = batches * batch;
+  assert(Profiler::getEvents().size() == PROFILER_EVENT_CAPACITY);
+  assert(Profiler::getDiscardedCount() - discarded ==
+         recorded - PROFILER_EVENT_CAPACITY);
+  assert(Profiler::getEvents().front().start ==
+         recorded - PROFILER_EVENT_CAPACITY);
+  assert(Profiler::getEvents().back().start == recorded - 1);
+  Profiler::clear();
+  std::cout << "Event cap test passed.\n";
+}
+
+void testChromeTrace() {
+  Profiler::clear();
+  {
+    ProfileZone zone("trace \"zone\"");
+  }
+
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "jelly_test_trace.json";
+  bool written = Profiler::writeChromeTrace(path.string().c_str());
+  assert(written);
+
+  std::string trace = read_file(path.string().c_str());
+  assert(trace.find("\"traceEvents\"") != std::string::npos);
+  assert(trace.find("\"name\": \"trace \\\"zone\\\"\"") != std::string::npos);
+  assert(trace.find("\"ph\": \"X\"") != std::string::npos);
+  assert(trace.find("\"args\": {\"name\": \"worker\"}") != std::string::npos);
+  std::filesystem::remove(path);
+  std::cout << "Chrome trace test passed.\n";
+}
+
+void testMacroSwitch() {
+  Profiler::clear();
+  {
+    JELLY_PROFILE_ZONE("macro");
+  }
+  Profiler::collect();
+
+#ifdef JELLY_PROFILE
+  assert(findEvent("macro") != nullptr);
+#else
+  // The macro compiles to nothing.
+  assert(findEvent("macro") == nullptr);
+#endif
+  std::cout << "Macro switch test passed.\n";
+}
+
+int main() {
+  testNestedZones();
+  testThreadsRecordSeparately();
+  testFullRingDrops();
+  testExitedThreadRingsAreReused();
+  testCollectedZonesAreBounded();
+  testChromeTrace();
+  testMacroSwitch();
+  std::cout << "All profiler tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "gl_test_context.h"
+#include "jelly/renderer_2d.h"
+
+static std::atomic<bool> g_counting = false;
+static std::atomic<size_t> g_allocations = 0;
+
+void *operator new(std::size_t size) {
+  if (g_counting) {
+    ++g_allocations;
+  }
+  if (void *ptr = std::malloc(size != 0 ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+struct Scene {
+  std::vector<Rectangle> rectangles;
+  std::vector<Circle> circles;
+};
+
+Scene makeScene() {
+  Scene scene;
+  // Every other shape lies off-screen so culling is exercised too.
+  for (int i = 0; i < 2000; ++i) {
+    float x = static_cast<float>((i * 37) % 640) - 160.0f;
+    float y = static_cast<float>((i * 53) % 480) - 120.0f;
+    Vec4<float> color(0.2f, 0.6f, 1.0f, 1.0f);
+    scene.rectangles.emplace_back(Vec2<float>(x, y), Vec2<float>(8.0f, 6.0f),
+                                  color, i % 3 != 0);
+    scene.circles.emplace_back(Vec2<float>(x, y), 5.0f, i % 3 != 0, color);
+  }
+  return scene;
+}
+
+void drawFrame(Renderer2D &renderer, const Scene &scene) {
+  renderer.begin();
+  renderer.drawRects(scene.rectangles);
+  renderer.drawCircles(scene.circles);
+  for (const Rectangle &rectangle : scene.rectangles) {
+    renderer.drawRect(rectangle);
+  }
+  for (const Circle &circle : scene.circles) {
+    renderer.drawCircle(circle);
+  }
+  renderer.end();
+  glFinish();
+}
+
+void testSteadyStateAllocations(Renderer2D &renderer, RenderSortMode mode) {
+  Scene scene = makeScene();
+  renderer.setSortMode(mode);
+
+  // The first frames grow the scratch and queue buffers to their working
+  // size.
+  for (int frame = 0; frame < 3; ++frame) {
+    drawFrame(renderer, scene);
+  }
+
+  g_allocations = 0;
+  g_counting = true;
+  for (int frame = 0; frame < 10; ++frame) {
+    drawFrame(renderer, scene);
+  }
+  g_counting = false;
+
+  std::cout << "Sort mode " << static_cast<int>(mode) << ": " << g_allocations
+            << " allocations in 10 frames\n";
+  assert(g_allocations == 0);
+}
+
+int main() {
+  GLTestContext context;
+  if (!context.init(320, 240)) {
+    return SKIP_TEST;
+  }
+
+  {
+    Renderer2D renderer(320, 240, 1.0f);
+    renderer.init();
+
+    testSteadyStateAllocations(renderer, RenderSortMode::Immediate);
+    testSteadyStateAllocations(renderer, RenderSortMode::Batch);
+    testSteadyStateAllocations(renderer, RenderSortMode::Stable);
+
+    renderer.shutdown();
+  }
+
+  std::cout << "All renderer allocation tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "jelly/sprite_transform.h"
+
+#define EPSILON 1e-3
+
+const SimdLevel LEVELS[] = {SimdLevel::Scalar, SimdLevel::SSE,
+                            SimdLevel::AVX};
+
+bool approxEqual(float a, float b, float epsilon = EPSILON) {
+  return std::fabs(a - b) < epsilon;
+}
+
+std::vector<float> transformWith(const SpriteTransformSoA &transforms,
+                                 SimdLevel level) {
+  std::vector<float> corners(transforms.size() * 8);
+  transformQuads(transforms, corners.data(), level);
+  return corners;
+}
+
+void testUnrotated() {
+  SpriteTransformSoA transforms;
+  transforms.push({10.0f, 20.0f}, {30.0f, 40.0f}, {0.0f, 0.0f}, 0.0f);
+  transforms.push({10.0f, 20.0f}, {30.0f, 40.0f}, {0.5f, 0.5f}, 0.0f);
+
+  // Without rotation the corners are exact.
+  const float expected[] = {10.0f, 20.0f, 40.0f, 20.0f, 40.0f, 60.0f,
+                            10.0f, 60.0f, -5.0f, 0.0f,  25.0f, 0.0f,
+                            25.0f, 40.0f, -5.0f, 40.0f};
+  for (SimdLevel level : LEVELS) {
+    std::vector<float> corners = transformWith(transforms, level);
+    for (size_t i = 0; i < corners.size(); ++i) {
+      assert(corners[i] == expected[i]);
+    }
+  }
+  std::cout << "Unrotated transform test passed.\n";
+}
+
+void testRotatedAboutCenter() {
+  // A quarter turn about the center of a 4x2 sprite at (100, 100).
+  SpriteTransformSoA transforms;
+  transforms.push({100.0f, 100.0f}, {4.0f, 2.0f}, {0.5f, 0.5f},
+                  1.5707963f);
+
+  const float expected[] = {101.0f, 98.0f,  101.0f, 102.0f,
+                            99.0f,  102.0f, 99.0f,  98.0f};
+  for (SimdLevel level : LEVELS) {
+    std::vector<float> corners = transformWith(transforms, level);
+    for (size_t i = 0; i < corners.size(); ++i) {
+      assert(approxEqual(corners[i], expected[i]));
+    }
+  }
+  std::cout << "Rotated transform test passed.\n";
+}
+
+void testKernelsMatchScalar() {
+  std::mt19937 rng(10);
+  std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+  std::uniform_real_distribution<float> size(1.0f, 200.0f);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  std::uniform_real_distribution<float> angle(-6.3f, 6.3f);
+
+  // Sizes that are not multiples of the vector width exercise the tails.
+  for (size_t count : {0, 1, 3, 4, 5, 8, 9, 15, 16, 17, 1001}) {
+    SpriteTransformSoA transforms;
+    for (size_t i = 0; i < count; ++i) {
+      transforms.push({position(rng), position(rng)}, {size(rng), size(rng)},
+                      {unit(rng), unit(rng)}, angle(rng));
+    }
+
+    std::vector<float> expected = transformWith(transforms, SimdLevel::Scalar);
+    for (SimdLevel level : LEVELS) {
+      std::vector<float> corners = transformWith(transforms, level);
+      for (size_t i = 0; i < corners.size(); ++i) {
+        assert(approxEqual(corners[i], expected[i]));
+      }
+    }
+  }
+  std::cout << "Kernel consistency test passed.\n";
+}
+
+int main() {
+  testUnrotated();
+  testRotatedAboutCenter();
+  testKernelsMatchScalar();
+
+  std::cout << "All sprite transform tests passed!" << std::endl;
+  return 0;
+}
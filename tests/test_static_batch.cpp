@@ -0,0 +1,203 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "gl_test_context.h"
+#include "jelly/renderer_2d.h"
+#include "jelly/static_batch.h"
+#include "jelly/texture_atlas.h"
+
+const int WIDTH = 64;
+const int HEIGHT = 64;
+
+const Vec4<float> RED(1.0f, 0.0f, 0.0f, 1.0f);
+const Vec4<float> BLUE(0.0f, 0.0f, 1.0f, 1.0f);
+
+// Reads the pixel at world position (x, y); the world y axis points down.
+uint32_t readPixel(int x, int y) {
+  uint8_t rgba[4];
+  glReadPixels(x, HEIGHT - 1 - y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+  return (uint32_t(rgba[0]) << 16) | (uint32_t(rgba[1]) << 8) | rgba[2];
+}
+
+void drawFrame(Renderer2D &renderer, StaticBatch &batch) {
+  renderer.begin();
+  renderer.drawStaticBatch(batch);
+  renderer.end();
+  glFinish();
+}
+
+void testUploadsOnlyChanges(Renderer2D &renderer) {
+  StaticBatch batch;
+  for (int i = 0; i < 16; ++i) {
+    batch.add(Rectangle(Vec2<float>(i * 4.0f, 0.0f), Vec2<float>(4.0f, 4.0f),
+                        RED));
+  }
+
+  drawFrame(renderer, batch);
+  StaticBatchStats first = batch.getStats();
+  assert(first.bytesUploaded >= 16 * 4 * sizeof(BatchQuadVertex));
+
+  // An unchanged batch uploads nothing.
+  drawFrame(renderer, batch);
+  assert(batch.getStats().uploads == first.uploads);
+  assert(batch.getStats().bytesUploaded == first.bytesUploaded);
+
+  // Moving one item re-uploads that item's vertices and nothing else.
+  batch.update(5, Rectangle(Vec2<float>(20.0f, 40.0f),
+                            Vec2<float>(4.0f, 4.0f), RED));
+  drawFrame(renderer, batch);
+  assert(batch.getStats().uploads == first.uploads + 1);
+  assert(batch.getStats().bytesUploaded ==
+         first.bytesUploaded + 4 * sizeof(BatchQuadVertex));
+
+  batch.Delete();
+  std::cout << "Upload test passed.\n";
+}
+
+void testDrawsRecordedItems(Renderer2D &renderer) {
+  StaticBatch batch;
+  StaticItem red = batch.add(
+      Rectangle(Vec2<float>(8.0f, 8.0f), Vec2<float>(16.0f, 16.0f), RED));
+  batch.add(Rectangle(Vec2<float>(40.0f, 8.0f), Vec2<float>(16.0f, 16.0f),
+                      BLUE, false));
+  assert(batch.size() == 2);
+
+  drawFrame(renderer, batch);
+  assert(readPixel(16, 16) == 0xFF0000);
+  assert(readPixel(48, 16) == 0x000000); // Outline only
+  assert(readPixel(2, 2) == 0x000000);
+
+  // Moving the filled rectangle moves its pixels.
+  batch.update(red, Rectangle(Vec2<float>(8.0f, 40.0f),
+                              Vec2<float>(16.0f, 16.0f), RED));
+  drawFrame(renderer, batch);
+  assert(readPixel(16, 16) == 0x000000);
+  assert(readPixel(16, 48) == 0xFF0000);
+
+  // A removed item stops drawing and its slot is reused.
+  batch.remove(red);
+  assert(batch.size() == 1);
+  drawFrame(renderer, batch);
+  assert(readPixel(16, 48) == 0x000000);
+  StaticItem reused = batch.add(
+      Rectangle(Vec2<float>(0.0f, 0.0f), Vec2<float>(4.0f, 4.0f), RED));
+  assert(reused == red);
+
+  batch.Delete();
+  std::cout << "Draw test passed.\n";
+}
+
+void testGrowsAcrossFrames(Renderer2D &renderer) {
+  StaticBatch batch;
+  for (int frame = 0; frame < 8; ++frame) {
+    for (int i = 0; i < 100; ++i) {
+      batch.add(Rectangle(Vec2<float>(0.0f, 0.0f), Vec2<float>(1.0f, 1.0f),
+                          RED));
+    }
+    batch.add(Rectangle(Vec2<float>(0.0f, 0.0f), Vec2<float>(1.0f, 1.0f),
+                        BLUE, false));
+    drawFrame(renderer, batch);
+  }
+  assert(batch.size() == 808);
+
+  // The last rectangle recorded is still drawn after the buffers grew.
+  batch.add(Rectangle(Vec2<float>(32.0f, 32.0f), Vec2<float>(8.0f, 8.0f),
+                      BLUE));
+  drawFrame(renderer, batch);
+  assert(readPixel(36, 36) == 0x0000FF);
+
+  batch.Delete();
+  std::cout << "Growth test passed.\n";
+}
+
+void testTextureSlotsAreReleased(Renderer2D &renderer) {
+  // Atlas pages holding one image each stand in for distinct textures.
+  const size_t count = MAX_TEXTURE_SLOTS + 2;
+  TextureAtlas atlas(4, count, 0);
+  std::vector<unsigned char> pixels(4 * 4 * 4, 255);
+  std::vector<Sprite> sprites;
+  for (size_t i = 0; i < count; ++i) {
+    const AtlasRegion *region = atlas.add(pixels.data(), 4, 4);
+    assert(region != nullptr);
+    sprites.emplace_back(*region);
+  }
+  const Sprite &extra = sprites[MAX_TEXTURE_SLOTS];
+  const Sprite &other = sprites[MAX_TEXTURE_SLOTS + 1];
+
+  StaticBatch batch;
+  std::vector<StaticItem> items;
+  for (size_t i = 0; i < MAX_TEXTURE_SLOTS; ++i) {
+    items.push_back(batch.add(sprites[i]));
+    assert(items.back() != INVALID_STATIC_ITEM);
+  }
+  assert(batch.getTextures().size() == MAX_TEXTURE_SLOTS);
+  StaticItem rejected = batch.add(extra);
+  assert(rejected == INVALID_STATIC_ITEM);
+
+  // An update whose texture does not fit leaves the outline as it was.
+  StaticItem outline = batch.add(
+      Rectangle(Vec2<float>(0.0f, 0.0f), Vec2<float>(8.0f, 8.0f), BLUE, false));
+  bool ok = batch.update(outline, extra);
+  assert(!ok);
+  drawFrame(renderer, batch);
+  assert(renderer.getStats().indices == MAX_TEXTURE_SLOTS * 6 + 5);
+
+  // Replacing the only sprite drawing a texture frees its slot.
+  ok = batch.update(items[3], Rectangle(Vec2<float>(0.0f, 0.0f),
+                                        Vec2<float>(8.0f, 8.0f), RED));
+  assert(ok);
+  assert(batch.getTextures()[3] == nullptr);
+  ok = batch.update(outline, extra);
+  assert(ok);
+  assert(batch.getTextures()[3] == &extra.getTexture());
+  drawFrame(renderer, batch);
+  assert(renderer.getStats().indices == (MAX_TEXTURE_SLOTS + 1) * 6);
+
+  // So does removing it, and a texture shared by two items is kept until
+  // both are gone.
+  batch.remove(items[5]);
+  StaticItem added = batch.add(other);
+  assert(added != INVALID_STATIC_ITEM);
+  assert(batch.getTextures()[5] == &other.getTexture());
+
+  StaticItem shared = batch.add(sprites[0]);
+  batch.remove(items[0]);
+  assert(batch.getTextures()[0] == &sprites[0].getTexture());
+  batch.remove(shared);
+  assert(batch.getTextures()[0] == nullptr);
+
+  batch.remove(items[MAX_TEXTURE_SLOTS - 1]);
+  assert(batch.getTextures().size() == MAX_TEXTURE_SLOTS - 1);
+
+  // Empty slots are skipped when the batch is drawn.
+  drawFrame(renderer, batch);
+  assert(renderer.getStats().textureBinds == MAX_TEXTURE_SLOTS - 2);
+  assert(glGetError() == GL_NO_ERROR);
+
+  batch.Delete();
+  std::cout << "Texture slot test passed.\n";
+}
+
+int main() {
+  GLTestContext context;
+  if (!context.init(WIDTH, HEIGHT)) {
+    return SKIP_TEST;
+  }
+
+  {
+    Renderer2D renderer(WIDTH, HEIGHT, 1.0f);
+    renderer.init();
+
+    testUploadsOnlyChanges(renderer);
+    testDrawsRecordedItems(renderer);
+    testGrowsAcrossFrames(renderer);
+    testTextureSlotsAreReleased(renderer);
+
+    renderer.shutdown();
+  }
+
+  std::cout << "All static batch tests passed!" << std::endl;
+  return 0;
+}
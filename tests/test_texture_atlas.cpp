@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "gl_test_context.h"
+#include "jelly/renderer_2d.h"
+#include "jelly/texture_atlas.h"
+
+bool overlaps(const AtlasRect &a, const AtlasRect &b) {
+  return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height &&
+         b.y < a.y + a.height;
+}
+
+void testPackerBounds() {
+  SkylinePacker packer(256, 256);
+  std::vector<AtlasRect> rects;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> size(1, 40);
+
+  AtlasRect rect;
+  while (packer.pack(size(rng), size(rng), rect)) {
+    assert(rect.x >= 0 && rect.y >= 0);
+    assert(rect.x + rect.width <= 256 && rect.y + rect.height <= 256);
+    for (const AtlasRect &other : rects) {
+      assert(!overlaps(rect, other));
+    }
+    rects.push_back(rect);
+  }
+
+  bool tooWide = packer.pack(257, 1, rect);
+  bool empty = packer.pack(0, 4, rect);
+  assert(!tooWide && !empty);
+  std::cout << "Packed " << rects.size() << " rects without overlap.\n";
+
+  packer.reset();
+  assert(packer.getUsedArea() == 0);
+  bool full = packer.pack(256, 256, rect);
+  assert(full);
+  assert(packer.getOccupancy() == 1.0f);
+  std::cout << "Packer bounds test passed.\n";
+}
+
+void testPackingDensity() {
+  SkylinePacker packer(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> size(8, 64);
+
+  // Sprite-sized images keep fitting into gaps long after the first miss.
+  AtlasRect rect;
+  int misses = 0;
+  while (misses < 100) {
+    if (!packer.pack(size(rng), size(rng), rect))
+      misses++;
+  }
+
+  std::cout << "Page occupancy: " << packer.getOccupancy() << "\n";
+  assert(packer.getOccupancy() > 0.85f);
+  std::cout << "Packing density test passed.\n";
+}
+
+std::vector<unsigned char> solidImage(int width, int height, uint32_t rgba) {
+  std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4);
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    pixels[i] = rgba >> 24;
+    pixels[i + 1] = (rgba >> 16) & 0xFF;
+    pixels[i + 2] = (rgba >> 8) & 0xFF;
+    pixels[i + 3] = rgba & 0xFF;
+  }
+  return pixels;
+}
+
+// Checks that every texel of a region on its page has the given color.
+bool regionHasColor(const AtlasRegion &region, int pageSize, uint32_t rgba) {
+  std::vector<unsigned char> page(static_cast<size_t>(pageSize) * pageSize *
+                                  4);
+  region.page->Bind();
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, page.data());
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  region.page->Unbind();
+
+  std::vector<unsigned char> expected = solidImage(1, 1, rgba);
+  for (int y = region.rect.y; y < region.rect.y + region.rect.height; ++y) {
+    for (int x = region.rect.x; x < region.rect.x + region.rect.width; ++x) {
+      const unsigned char *texel =
+          page.data() + (static_cast<size_t>(y) * pageSize + x) * 4;
+      if (!std::equal(expected.begin(), expected.end(), texel))
+        return false;
+    }
+  }
+  return true;
+}
+
+void drawFrame(Renderer2D &renderer, const std::vector<Sprite> &sprites) {
+  renderer.begin();
+  for (const Sprite &sprite : sprites) {
+    renderer.drawSprite(sprite);
+  }
+  renderer.end();
+}
+
+void testAtlasSpritesShareOneDraw(Renderer2D &renderer) {
+  const int pageSize = 256;
+  TextureAtlas atlas(pageSize);
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<int> size(8, 24);
+
+  std::vector<const AtlasRegion *> regions;
+  for (size_t i = 0; i < 400; ++i) {
+    int width = size(rng);
+    int height = size(rng);
+    std::vector<unsigned char> pixels = solidImage(width, height, 0xFF00FFFF);
+    const AtlasRegion *region = atlas.add(pixels.data(), width, height);
+    assert(region != nullptr);
+    assert(region->rect.width == width && region->rect.height == height);
+    regions.push_back(region);
+  }
+
+  const AtlasStats &stats = atlas.getStats();
+  assert(stats.pageCount == atlas.getPageCount());
+  assert(stats.pageCount > 1 && stats.pageCount <= MAX_TEXTURE_SLOTS);
+  assert(stats.regionCount == regions.size());
+  assert(stats.failedInserts == 0);
+
+  // Padding keeps every region apart on its page.
+  for (size_t i = 0; i < regions.size(); ++i) {
+    for (size_t j = i + 1; j < regions.size(); ++j) {
+      if (regions[i]->pageIndex == regions[j]->pageIndex)
+        assert(!overlaps(regions[i]->rect, regions[j]->rect));
+    }
+  }
+
+  std::vector<Sprite> sprites;
+  for (const AtlasRegion *region : regions) {
+    sprites.emplace_back(*region);
+  }
+  for (size_t i = 0; i < sprites.size(); ++i) {
+    const AtlasRegion &region = *regions[i];
+    const float page = static_cast<float>(pageSize);
+    Vec4<float> uv = sprites[i].getUVRect();
+    assert(&sprites[i].getTexture() == region.page);
+    assert(region.page == &atlas.getPage(region.pageIndex));
+    assert(uv.x == region.rect.x / page && uv.y == region.rect.y / page);
+    assert(uv.z == (region.rect.x + region.rect.width) / page);
+    assert(uv.w == (region.rect.y + region.rect.height) / page);
+  }
+
+  // A few pages fit the texture slots of one batch.
+  drawFrame(renderer, sprites);
+  assert(renderer.getStats().drawCalls == 1);
+  assert(renderer.getStats().getFlushes(FlushReason::TextureSlots) == 0);
+  std::cout << "Atlas batching test passed with " << stats.pageCount
+            << " pages.\n";
+}
+
+void testPagesBeyondTextureSlots(Renderer2D &renderer) {
+  // Each image fills a page of its own, as separate textures would.
+  const size_t count = MAX_TEXTURE_SLOTS + 8;
+  TextureAtlas atlas(16, count, 0);
+  std::vector<unsigned char> pixels = solidImage(16, 16, 0xFFFFFFFF);
+  std::vector<Sprite> sprites;
+  for (size_t i = 0; i < count; ++i) {
+    const AtlasRegion *region = atlas.add(pixels.data(), 16, 16);
+    assert(region != nullptr && region->pageIndex == i);
+    sprites.emplace_back(*region);
+  }
+  assert(atlas.getStats().pageCount == count);
+
+  std::vector<unsigned char> extra = solidImage(1, 1, 0xFFFFFFFF);
+  const AtlasRegion *overflow = atlas.add(extra.data(), 1, 1);
+  assert(overflow == nullptr);
+  assert(atlas.getStats().failedInserts == 1);
+
+  drawFrame(renderer, sprites);
+  const RenderStats &stats = renderer.getStats();
+  assert(stats.drawCalls == 2);
+  assert(stats.getFlushes(FlushReason::TextureSlots) == 1);
+  std::cout << "Texture slot test passed.\n";
+}
+
+void testRemoveAndRepack() {
+  const int pageSize = 32;
+  const uint32_t colors[] = {0xFF0000FF, 0x00FF00FF, 0x0000FFFF, 0xFFFF00FF};
+  TextureAtlas atlas(pageSize, 1, 0);
+
+  // Four quarters fill the only page.
+  std::vector<const AtlasRegion *> regions;
+  for (uint32_t color : colors) {
+    std::vector<unsigned char> pixels = solidImage(16, 16, color);
+    regions.push_back(atlas.add(pixels.data(), 16, 16));
+    assert(regions.back() != nullptr);
+  }
+  std::vector<unsigned char> wide = solidImage(32, 16, 0xFFFFFFFF);
+  const AtlasRegion *rejected = atlas.add(wide.data(), 32, 16);
+  assert(rejected == nullptr);
+  assert(atlas.getStats().failedInserts == 1);
+  assert(atlas.getStats().occupancy == 1.0f);
+
+  // Removed texels are only reclaimed by a repack, which the next insert
+  // that does not fit runs.
+  atlas.remove(regions[0]);
+  atlas.remove(regions[3]);
+  atlas.remove(regions[3]);
+  const AtlasStats &stats = atlas.getStats();
+  assert(stats.regionCount == 2 && stats.evictions == 2);
+  assert(stats.usedArea == 2 * 16 * 16 && stats.wastedArea == 2 * 16 * 16);
+  assert(!regions[0]->live && regions[1]->live);
+
+  const AtlasRegion *added = atlas.add(wide.data(), 32, 16);
+  assert(added != nullptr);
+  assert(stats.repacks == 1 && stats.wastedArea == 0);
+  assert(stats.regionCount == 3 && stats.pageCount == 1);
+  assert(stats.occupancy == 1.0f);
+
+  // The surviving regions moved with their texels.
+  assert(regionHasColor(*regions[1], pageSize, colors[1]));
+  assert(regionHasColor(*regions[2], pageSize, colors[2]));
+  assert(regionHasColor(*added, pageSize, 0xFFFFFFFF));
+  assert(!overlaps(regions[1]->rect, regions[2]->rect));
+  assert(!overlaps(regions[1]->rect, added->rect));
+  std::cout << "Remove and repack test passed.\n";
+}
+
+void testRepackFreesPages() {
+  TextureAtlas atlas(16, 4, 0);
+  std::vector<const AtlasRegion *> regions;
+  for (uint32_t i = 0; i < 4; ++i) {
+    std::vector<unsigned char> pixels = solidImage(16, 16, 0x10203000 | i);
+    regions.push_back(atlas.add(pixels.data(), 16, 16));
+  }
+  assert(atlas.getPageCount() == 4);
+
+  atlas.remove(regions[0]);
+  atlas.remove(regions[1]);
+  atlas.remove(regions[2]);
+  atlas.repack();
+
+  // The last region moves to the first page and the others are freed.
+  assert(atlas.getPageCount() == 1);
+  assert(atlas.getStats().pageCount == 1);
+  assert(regions[3]->pageIndex == 0);
+  assert(regions[3]->page == &atlas.getPage(0));
+  assert(regionHasColor(*regions[3], 16, 0x10203003));
+  std::cout << "Repack page test passed.\n";
+}
+
+void testFailedRepackKeepsLayout() {
+  // Insertion order fills the page, but tallest first cannot place the
+  // survivors once the first image is gone.
+  const int pageSize = 16;
+  const int sizes[][2] = {{3, 10}, {12, 3}, {10, 9}, {8, 4}, {6, 3}};
+  TextureAtlas atlas(pageSize, 1, 0);
+  std::vector<const AtlasRegion *> regions;
+  for (uint32_t i = 0; i < 5; ++i) {
+    std::vector<unsigned char> pixels =
+        solidImage(sizes[i][0], sizes[i][1], 0x40506000 | i);
+    regions.push_back(atlas.add(pixels.data(), sizes[i][0], sizes[i][1]));
+    assert(regions.back() != nullptr);
+  }
+  std::vector<AtlasRect> rects;
+  for (const AtlasRegion *region : regions) {
+    rects.push_back(region->rect);
+  }
+  atlas.remove(regions[0]);
+
+  bool repacked = atlas.repack();
+  assert(!repacked);
+  std::vector<unsigned char> big = solidImage(pageSize, pageSize, 0xFFFFFFFF);
+  const AtlasRegion *added = atlas.add(big.data(), pageSize, pageSize);
+  assert(added == nullptr);
+
+  // The survivors keep their page, place and texels.
+  const AtlasStats &stats = atlas.getStats();
+  assert(stats.repacks == 0 && stats.failedInserts == 1);
+  assert(stats.pageCount == 1 && atlas.getPageCount() == 1);
+  assert(stats.regionCount == 4 && stats.wastedArea == 3 * 10);
+  for (uint32_t i = 1; i < 5; ++i) {
+    const AtlasRegion &region = *regions[i];
+    assert(region.live && region.pageIndex == 0);
+    assert(region.page == &atlas.getPage(0));
+    assert(region.rect.x == rects[i].x && region.rect.y == rects[i].y);
+    assert(regionHasColor(region, pageSize, 0x40506000 | i));
+  }
+  std::cout << "Failed repack test passed.\n";
+}
+
+int main() {
+  testPackerBounds();
+  testPackingDensity();
+
+  GLTestContext context;
+  if (!context.init(64, 64)) {
+    return SKIP_TEST;
+  }
+
+  {
+    Renderer2D renderer(64, 64, 1.0f);
+    renderer.init();
+
+    testAtlasSpritesShareOneDraw(renderer);
+    testPagesBeyondTextureSlots(renderer);
+    testRemoveAndRepack();
+    testRepackFreesPages();
+    testFailedRepackKeepsLayout();
+
+    renderer.shutdown();
+  }
+
+  std::cout << "All tests passed successfully.\n";
+  return 0;
+}
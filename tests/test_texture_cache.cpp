@@ -0,0 +1,183 @@
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gl_test_context.h"
+#include "jelly/game_context.h"
+#include "jelly/image.h"
+#include "jelly/sprite.h"
+#include "jelly/texture_cache.h"
+
+const int IMAGE_SIZE = 32;
+
+std::filesystem::path imageDir() {
+  return std::filesystem::temp_directory_path() / "jelly_test_texture_cache";
+}
+
+std::string writeImage(const std::string &name) {
+  std::filesystem::create_directories(imageDir());
+  std::vector<unsigned char> pixels(IMAGE_SIZE * IMAGE_SIZE * 4, 255);
+  std::filesystem::path path = imageDir() / name;
+  bool written = write_png(path.string().c_str(), IMAGE_SIZE, IMAGE_SIZE,
+                           pixels.data());
+  assert(written);
+  return path.string();
+}
+
+// Same estimate as the cache: RGBA plus a third for the mipmaps.
+size_t expectedBytes(const TextureHandle &handle) {
+  return static_cast<size_t>(handle->getWidth()) * handle->getHeight() * 4 *
+         4 / 3;
+}
+
+void testHitsAndDedup(const std::string &path) {
+  TextureCache cache;
+  TextureHandle first = cache.load(path.c_str());
+  assert(first.isReady());
+  assert(first->getID() != 0);
+
+  // The same file through another path is the same texture.
+  std::filesystem::path dir = std::filesystem::path(path).parent_path();
+  std::string other = (dir / ".." / dir.filename() /
+                       std::filesystem::path(path).filename())
+                          .string();
+  TextureHandle second = cache.load(other.c_str());
+  assert(second->getID() == first->getID());
+  assert(first.getRefCount() == 2);
+
+  const TextureCacheStats &stats = cache.getStats();
+  assert(stats.misses == 1 && stats.hits == 1);
+  assert(stats.textureCount == 1);
+  assert(stats.memoryBytes == expectedBytes(first));
+
+  // Other load parameters are a different texture.
+  TextureHandle rgb = cache.load(path.c_str(), GL_TEXTURE_2D, GL_RGB);
+  assert(rgb->getID() != first->getID());
+  assert(stats.misses == 2 && stats.textureCount == 2);
+  std::cout << "Hit and dedup test passed.\n";
+}
+
+void testReleaseOnLastHandle(const std::string &path) {
+  TextureCache cache;
+  const TextureCacheStats &stats = cache.getStats();
+  GLuint id;
+  {
+    TextureHandle handle = cache.load(path.c_str());
+    id = handle->getID();
+    {
+      TextureHandle copy = handle;
+      assert(handle.getRefCount() == 2);
+    }
+    // One handle is left, so the texture stays.
+    assert(handle.getRefCount() == 1);
+    assert(stats.evictions == 0 && stats.textureCount == 1);
+    assert(glIsTexture(id));
+  }
+
+  assert(stats.evictions == 1);
+  assert(stats.textureCount == 0 && stats.memoryBytes == 0);
+  assert(!glIsTexture(id));
+
+  // The next load decodes the image again.
+  TextureHandle handle = cache.load(path.c_str());
+  assert(handle.isReady());
+  assert(stats.misses == 2 && stats.hits == 0);
+  std::cout << "Release test passed.\n";
+}
+
+void testFailedLoad() {
+  TextureCache cache;
+  const TextureCacheStats &stats = cache.getStats();
+  std::string missing = (imageDir() / "missing.png").string();
+  {
+    TextureHandle handle = cache.load(missing.c_str());
+    assert(handle);
+    assert(!handle.isReady());
+    assert(handle.getState() == TextureState::Failed);
+    assert(handle->getID() == 0);
+    assert(stats.memoryBytes == 0);
+
+    // The failure is cached rather than retried.
+    TextureHandle again = cache.load(missing.c_str());
+    assert(again.getState() == TextureState::Failed);
+    assert(stats.misses == 1 && stats.hits == 1);
+    assert(stats.textureCount == 1);
+  }
+
+  assert(stats.evictions == 1);
+  assert(stats.textureCount == 0 && stats.memoryBytes == 0);
+  std::cout << "Failed load test passed.\n";
+}
+
+void testClearWithLiveHandles(const std::string &a, const std::string &b) {
+  TextureHandle kept;
+  GLuint id;
+  {
+    TextureCache cache;
+    kept = cache.load(a.c_str());
+    TextureHandle other = cache.load(b.c_str());
+    id = kept->getID();
+
+    cache.clear();
+    const TextureCacheStats &stats = cache.getStats();
+    assert(stats.textureCount == 0 && stats.memoryBytes == 0);
+    assert(stats.evictions == 0);
+    assert(!glIsTexture(id));
+    assert(kept.getState() == TextureState::Failed);
+
+    // Loading after a clear starts over rather than reusing the entry.
+    TextureHandle reloaded = cache.load(a.c_str());
+    assert(reloaded.isReady());
+    assert(stats.misses == 3 && stats.textureCount == 1);
+  }
+
+  // The handle outlives its cache and is still safe to drop.
+  assert(kept && kept.getRefCount() == 1);
+  kept = TextureHandle();
+  assert(!kept);
+  std::cout << "Clear test passed.\n";
+}
+
+void testSpriteWithoutContext(const std::string &path) {
+  assert(!GameContext::isInitialized());
+  GLuint id;
+  {
+    // Without a game context the sprite loads a texture of its own.
+    Sprite sprite(path.c_str());
+    id = sprite.getTexture().getID();
+    assert(glIsTexture(id));
+    assert(sprite.getWidth() == IMAGE_SIZE);
+
+    Sprite copy = sprite;
+    assert(copy.getTexture().getID() == id);
+  }
+
+  // The last copy frees it.
+  assert(!glIsTexture(id));
+
+  TextureHandle missing = TextureCache::loadUncached(
+      (imageDir() / "missing.png").string().c_str());
+  assert(missing.getState() == TextureState::Failed);
+  std::cout << "Sprite without context test passed.\n";
+}
+
+int main() {
+  GLTestContext context;
+  if (!context.init(64, 64)) {
+    return SKIP_TEST;
+  }
+
+  std::string a = writeImage("a.png");
+  std::string b = writeImage("b.png");
+  testHitsAndDedup(a);
+  testReleaseOnLastHandle(a);
+  testFailedLoad();
+  testClearWithLiveHandles(a, b);
+  testSpriteWithoutContext(a);
+  std::filesystem::remove_all(imageDir());
+
+  std::cout << "All texture cache tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gl_test_context.h"
+#include "jelly/image.h"
+#include "jelly/texture_cache.h"
+#include "jelly/texture_loader.h"
+
+// Enough images that several decode at once on every worker.
+const size_t IMAGE_COUNT = 24;
+const int IMAGE_SIZE = 256;
+
+std::vector<std::string> writeImages() {
+  std::filesystem::path dir =
+      std::filesystem::temp_directory_path() / "jelly_test_texture_loader";
+  std::filesystem::create_directories(dir);
+
+  std::vector<unsigned char> pixels(IMAGE_SIZE * IMAGE_SIZE * 4);
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < IMAGE_COUNT; ++i) {
+    for (size_t p = 0; p < pixels.size(); ++p) {
+      pixels[p] = static_cast<unsigned char>((p * 7 + i * 13) % 251);
+    }
+    std::filesystem::path path = dir / ("image" + std::to_string(i) + ".png");
+    bool written = write_png(path.string().c_str(), IMAGE_SIZE, IMAGE_SIZE,
+                             pixels.data());
+    assert(written);
+    paths.push_back(path.string());
+  }
+  return paths;
+}
+
+void testIdleOnlyWhenAllLoaded(const std::vector<std::string> &paths) {
+  TextureLoader loader;
+  loader.init(4);
+
+  {
+    TextureCache cache;
+    std::vector<TextureHandle> handles;
+    for (const std::string &path : paths) {
+      handles.push_back(cache.loadAsync(path.c_str(), loader));
+    }
+    assert(loader.getStats().queued + loader.getStats().uploading ==
+           paths.size());
+
+    // Jobs a worker is decoding count as queued, so the loader is not idle
+    // before every handle is ready.
+    while (!loader.isIdle()) {
+      TextureLoaderStats stats = loader.getStats();
+      assert(stats.queued + stats.uploading + stats.completed ==
+             paths.size());
+      loader.update();
+    }
+    for (const TextureHandle &handle : handles) {
+      assert(handle.isReady());
+    }
+
+    TextureLoaderStats stats = loader.getStats();
+    assert(stats.queued == 0 && stats.uploading == 0);
+    assert(stats.completed == paths.size() && stats.failed == 0);
+  }
+
+  loader.shutdown();
+  std::cout << "Idle test passed.\n";
+}
+
+int main() {
+  GLTestContext context;
+  if (!context.init(64, 64)) {
+    return SKIP_TEST;
+  }
+
+  std::vector<std::string> paths = writeImages();
+  testIdleOnlyWhenAllLoaded(paths);
+  std::filesystem::remove_all(
+      std::filesystem::path(paths.front()).parent_path());
+
+  std::cout << "All texture loader tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <thread>
+
+#include "jelly/spsc_queue.h"
+#include "jelly/window_events.h"
+
+WindowEvent resize(WindowEventType type, int width, int height) {
+  return {type, width, height};
+}
+
+WindowEvent focus(bool focused) {
+  WindowEvent event{WindowEventType::Focus};
+  event.focused = focused;
+  return event;
+}
+
+void testQueueAcrossThreads() {
+  const size_t count = 100000;
+  SpscQueue<size_t, 64> queue;
+
+  std::thread producer([&] {
+    for (size_t i = 0; i < count; ++i) {
+      while (!queue.push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  // Items arrive complete and in order even while the queue wraps.
+  size_t expected = 0;
+  while (expected < count) {
+    size_t item;
+    if (queue.pop(item)) {
+      assert(item == expected);
+      ++expected;
+    }
+  }
+  producer.join();
+  assert(queue.size() == 0);
+  std::cout << "Queue test passed.\n";
+}
+
+void testLatestEventOfEachType() {
+  WindowEvents events;
+  WindowState initial;
+  initial.width = initial.framebufferWidth = 640;
+  initial.height = initial.framebufferHeight = 480;
+  events.setState(initial);
+
+  // A drag resize followed by the framebuffer catching up, out of order
+  // with focus changes.
+  events.push(focus(false));
+  for (int i = 1; i <= 10; ++i) {
+    events.push(resize(WindowEventType::Resize, 640 + i, 480 + i));
+  }
+  events.push(resize(WindowEventType::FramebufferResize, 1300, 980));
+  events.push(focus(true));
+  events.push(focus(false));
+
+  const std::vector<WindowEvent> &dispatched = events.poll();
+  assert(dispatched.size() == 3);
+  assert(dispatched[0].type == WindowEventType::Resize);
+  assert(dispatched[0].width == 650 && dispatched[0].height == 490);
+  assert(dispatched[1].type == WindowEventType::FramebufferResize);
+  assert(dispatched[2].type == WindowEventType::Focus);
+  assert(!dispatched[2].focused);
+
+  const WindowState &state = events.getState();
+  assert(state.width == 650 && state.height == 490);
+  assert(state.framebufferWidth == 1300 && state.framebufferHeight == 980);
+  assert(!state.focused);
+
+  assert(events.poll().empty());
+  std::cout << "Latest event test passed.\n";
+}
+
+void testUnchangedStateIsNotDispatched() {
+  WindowEvents events;
+  WindowState initial;
+  initial.width = initial.framebufferWidth = 640;
+  initial.height = initial.framebufferHeight = 480;
+  events.setState(initial);
+
+  // Lost and regained focus within a frame, and resized back.
+  events.push(focus(false));
+  events.push(focus(true));
+  events.push(resize(WindowEventType::Resize, 800, 600));
+  events.push(resize(WindowEventType::Resize, 640, 480));
+  assert(events.poll().empty());
+  std::cout << "Unchanged state test passed.\n";
+}
+
+void testOverflowWithoutWindow() {
+  WindowEvents events;
+  for (size_t i = 0; i < WINDOW_EVENT_QUEUE_CAPACITY; ++i) {
+    bool pushed = events.push(resize(WindowEventType::Resize, 1, 1));
+    assert(pushed);
+  }
+  bool overflowed = !events.push(resize(WindowEventType::Resize, 2, 2));
+  assert(overflowed);
+
+  // Without a window to query, the events that fit are applied.
+  assert(events.poll().size() == 1);
+  assert(events.getState().width == 1);
+  bool pushed = events.push(resize(WindowEventType::Resize, 2, 2));
+  assert(pushed);
+  std::cout << "Overflow test passed.\n";
+}
+
+int main() {
+  testQueueAcrossThreads();
+  testLatestEventOfEachType();
+  testUnchangedStateIsNotDispatched();
+  testOverflowWithoutWindow();
+  std::cout << "All window event tests passed!" << std::endl;
+  return 0;
+}